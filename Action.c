@@ -16,6 +16,7 @@ in the source distribution for its full text.
 #include "CategoriesPanel.h"
 #include "CommandScreen.h"
 #include "CRT.h"
+#include "DiffScreen.h"
 #include "EnvScreen.h"
 #include "FunctionBar.h"
 #include "Hashtable.h"
@@ -24,6 +25,7 @@ in the source distribution for its full text.
 #include "ListItem.h"
 #include "Macros.h"
 #include "MainPanel.h"
+#include "MemoryMapsScreen.h"
 #include "OpenFilesScreen.h"
 #include "Process.h"
 #include "ProcessLocksScreen.h"
@@ -291,12 +293,20 @@ static Htop_Reaction actionQuit(ATTR_UNUSED State* st) {
    return HTOP_QUIT;
 }
 
+/* The selected process, unless the list shows processes that cannot be looked at from here */
+static Process* selectedLocalProcess(State* st) {
+   if (!State_showsLiveProcesses(st))
+      return NULL;
+
+   return (Process*) Panel_getSelected((Panel*)st->mainPanel);
+}
+
 static Htop_Reaction actionSetAffinity(State* st) {
    if (st->pl->cpuCount == 1)
       return HTOP_OK;
 
 #if (defined(HAVE_LIBHWLOC) || defined(HAVE_LINUX_AFFINITY))
-   const Process* p = (const Process*) Panel_getSelected((Panel*)st->mainPanel);
+   const Process* p = selectedLocalProcess(st);
    if (!p)
       return HTOP_OK;
 
@@ -369,8 +379,16 @@ static Htop_Reaction actionSetup(State* st) {
    return HTOP_REFRESH | HTOP_REDRAW_BAR | HTOP_UPDATE_PANELHDR;
 }
 
+static Htop_Reaction actionToggleHeader(State* st) {
+   st->header->hidden = !st->header->hidden;
+   int headerHeight = Header_calculateHeight(st->header);
+   Panel_move((Panel*)st->mainPanel, 0, headerHeight);
+   Panel_resize((Panel*)st->mainPanel, COLS, LINES-headerHeight-1);
+   return HTOP_REFRESH | HTOP_REDRAW_BAR | HTOP_UPDATE_PANELHDR;
+}
+
 static Htop_Reaction actionLsof(State* st) {
-   const Process* p = (Process*) Panel_getSelected((Panel*)st->mainPanel);
+   const Process* p = selectedLocalProcess(st);
    if (!p)
       return HTOP_OK;
 
@@ -382,8 +400,21 @@ static Htop_Reaction actionLsof(State* st) {
    return HTOP_REFRESH | HTOP_REDRAW_BAR;
 }
 
+static Htop_Reaction actionShowMemoryMaps(State* st) {
+   const Process* p = selectedLocalProcess(st);
+   if (!p)
+      return HTOP_OK;
+
+   MemoryMapsScreen* mms = MemoryMapsScreen_new(p);
+   InfoScreen_run((InfoScreen*)mms);
+   MemoryMapsScreen_delete((Object*)mms);
+   clear();
+   CRT_enableDelay();
+   return HTOP_REFRESH | HTOP_REDRAW_BAR;
+}
+
 static Htop_Reaction actionShowLocks(State* st) {
-   const Process* p = (Process*) Panel_getSelected((Panel*)st->mainPanel);
+   const Process* p = selectedLocalProcess(st);
    if (!p) return HTOP_OK;
    ProcessLocksScreen* pls = ProcessLocksScreen_new(p);
    InfoScreen_run((InfoScreen*)pls);
@@ -393,8 +424,17 @@ static Htop_Reaction actionShowLocks(State* st) {
    return HTOP_REFRESH | HTOP_REDRAW_BAR;
 }
 
+static Htop_Reaction actionShowDiff(State* st) {
+   DiffScreen* ds = DiffScreen_new(st->history);
+   InfoScreen_run((InfoScreen*)ds);
+   DiffScreen_delete((Object*)ds);
+   clear();
+   CRT_enableDelay();
+   return HTOP_REFRESH | HTOP_REDRAW_BAR;
+}
+
 static Htop_Reaction actionStrace(State* st) {
-   const Process* p = (Process*) Panel_getSelected((Panel*)st->mainPanel);
+   const Process* p = selectedLocalProcess(st);
    if (!p)
       return HTOP_OK;
 
@@ -429,6 +469,47 @@ static Htop_Reaction actionTogglePauseProcessUpdate(State* st) {
    return HTOP_REFRESH | HTOP_REDRAW_BAR;
 }
 
+static Htop_Reaction stepFrames(State* st, int frames) {
+   if (st->replay)
+      Replay_step(st->replay, frames);
+   else if (!st->history || !History_step(st->history, frames))
+      return HTOP_OK;
+
+   return HTOP_RECALCULATE | HTOP_REDRAW_BAR | HTOP_KEEP_FOLLOWING;
+}
+
+static Htop_Reaction actionStepBack(State* st) {
+   return stepFrames(st, -1);
+}
+
+static Htop_Reaction actionStepForward(State* st) {
+   return stepFrames(st, 1);
+}
+
+static Htop_Reaction actionSeekBack(State* st) {
+   if (!st->replay)
+      return HTOP_OK;
+
+   Replay_seek(st->replay, -60 * 1000);
+   return HTOP_RECALCULATE | HTOP_REDRAW_BAR | HTOP_KEEP_FOLLOWING;
+}
+
+static Htop_Reaction actionSeekForward(State* st) {
+   if (!st->replay)
+      return HTOP_OK;
+
+   Replay_seek(st->replay, 60 * 1000);
+   return HTOP_RECALCULATE | HTOP_REDRAW_BAR | HTOP_KEEP_FOLLOWING;
+}
+
+static Htop_Reaction actionCycleReplaySpeed(State* st) {
+   if (!st->replay)
+      return HTOP_OK;
+
+   Replay_cycleSpeed(st->replay);
+   return HTOP_REDRAW_BAR;
+}
+
 static const struct {
    const char* key;
    const char* info;
@@ -444,6 +525,9 @@ static const struct {
    { .key = "      u: ", .info = "tek bir kullanıcının işlemlerini göster" },
    { .key = "      H: ", .info = "kullanıcı işlem dizilerini gizle/göster" },
    { .key = "      K: ", .info = "çekirdek dizilerini gizle/göster" },
+   { .key = "      #: ", .info = "başlık sayaçlarını gizle/göster" },
+   { .key = "    { }: ", .info = "geçmişte bir kare geri/ileri" },
+   { .key = "  ( ) R: ", .info = "kayıtta 1 dk geri/ileri, hız" },
    { .key = "      F: ", .info = "imleç süreci takip eders" },
    { .key = "  + - *: ", .info = "ağacı genişlet/daralt/tümünü değiştir" },
    { .key = "N P M T: ", .info = "PID, CPU%, MEM% veya TIME göre sırala" },
@@ -469,8 +553,10 @@ static const struct {
    { .key = "      i: ", .info = "IO önceliğini ayarla" },
    { .key = "      l: ", .info = "lsof ile açık dosyaları listeleme" },
    { .key = "      x: ", .info = "işlemin dosya kilitlerini listeleyin" },
+   { .key = "      b: ", .info = "işlemin bellek haritasını göster" },
    { .key = "      s: ", .info = "sistem çağrılarını strace ile izleme" },
    { .key = "      w: ", .info = "birden çok satıra sarma işlemi komutu" },
+   { .key = "      D: ", .info = "geçmişe göre süreç farkları" },
    { .key = " F2 C S: ", .info = "kur" },
    { .key = "   F1 h: ", .info = "bu yardım ekranını göster" },
    { .key = "  F10 q: ", .info = "çık" },
@@ -602,7 +688,7 @@ static Htop_Reaction actionTagAllChildren(State* st) {
 }
 
 static Htop_Reaction actionShowEnvScreen(State* st) {
-   Process* p = (Process*) Panel_getSelected((Panel*)st->mainPanel);
+   Process* p = selectedLocalProcess(st);
    if (!p)
       return HTOP_OK;
 
@@ -629,6 +715,9 @@ static Htop_Reaction actionShowCommandScreen(State* st) {
 
 void Action_setBindings(Htop_Action* keys) {
    keys[' '] = actionTag;
+   keys['#'] = actionToggleHeader;
+   keys['('] = actionSeekBack;
+   keys[')'] = actionSeekForward;
    keys['*'] = actionExpandOrCollapseAllBranches;
    keys['+'] = actionExpandOrCollapse;
    keys[','] = actionSetSortColumn;
@@ -640,6 +729,7 @@ void Action_setBindings(Htop_Action* keys) {
    keys['>'] = actionSetSortColumn;
    keys['?'] = actionHelp;
    keys['C'] = actionSetup;
+   keys['D'] = actionShowDiff;
    keys['F'] = Action_follow;
    keys['H'] = actionToggleUserlandThreads;
    keys['I'] = actionInvertSortOrder;
@@ -647,6 +737,7 @@ void Action_setBindings(Htop_Action* keys) {
    keys['M'] = actionSortByMemory;
    keys['N'] = actionSortByPID;
    keys['P'] = actionSortByCPU;
+   keys['R'] = actionCycleReplaySpeed;
    keys['S'] = actionSetup;
    keys['T'] = actionSortByTime;
    keys['U'] = actionUntagAll;
@@ -657,6 +748,7 @@ void Action_setBindings(Htop_Action* keys) {
    keys['\\'] = actionIncFilter;
    keys[']'] = actionHigherPriority;
    keys['a'] = actionSetAffinity;
+   keys['b'] = actionShowMemoryMaps;
    keys['c'] = actionTagAllChildren;
    keys['e'] = actionShowEnvScreen;
    keys['h'] = actionHelp;
@@ -670,6 +762,8 @@ void Action_setBindings(Htop_Action* keys) {
    keys['u'] = actionFilterByUser;
    keys['w'] = actionShowCommandScreen;
    keys['x'] = actionShowLocks;
+   keys['{'] = actionStepBack;
+   keys['}'] = actionStepForward;
    keys[KEY_F(1)] = actionHelp;
    keys[KEY_F(2)] = actionSetup;
    keys[KEY_F(3)] = actionIncSearch;
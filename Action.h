@@ -12,12 +12,17 @@ in the source distribution for its full text.
 #include <stdbool.h>
 #include <sys/types.h>
 
+#include "Cluster.h"
 #include "Header.h"
+#include "History.h"
 #include "Object.h"
 #include "Panel.h"
 #include "Process.h"
 #include "ProcessList.h"
+#include "Recorder.h"
+#include "Replay.h"
 #include "Settings.h"
+#include "SharedScan.h"
 #include "UsersTable.h"
 
 
@@ -40,6 +45,11 @@ typedef struct State_ {
    ProcessList* pl;
    struct MainPanel_* mainPanel;
    Header* header;
+   Recorder* recorder;
+   Replay* replay;
+   SharedScan* shared;
+   Cluster* cluster;
+   History* history;
    bool pauseProcessUpdate;
    bool hideProcessSelection;
 } State;
@@ -48,6 +58,12 @@ static inline bool State_hideFunctionBar(const State* st) {
    return st->settings->hideFunctionBar == 2 || (st->settings->hideFunctionBar == 1 && st->hideProcessSelection);
 }
 
+/* The pids of a recording or of an earlier scan may belong to unrelated processes
+ * by now, those of agents are not on this system at all */
+static inline bool State_showsLiveProcesses(const State* st) {
+   return !st->replay && !st->cluster && !(st->history && History_isBrowsing(st->history));
+}
+
 typedef Htop_Reaction (*Htop_Action)(State* st);
 
 Object* Action_pickFromVector(State* st, Panel* list, int x, bool followProcess);
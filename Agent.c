@@ -0,0 +1,260 @@
+/*
+htop - Agent.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "Agent.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "CRT.h"
+#include "Macros.h"
+#include "Platform.h"
+#include "Recorder.h"
+#include "Socket.h"
+#include "XUtils.h"
+
+
+static volatile sig_atomic_t Agent_stopped;
+
+static void Agent_stop(ATTR_UNUSED int sgn) {
+   Agent_stopped = 1;
+}
+
+Agent* Agent_new(const char* address, bool restricted) {
+   int fd = Socket_listen(address);
+   if (fd < 0)
+      return NULL;
+
+   Agent* this = xCalloc(1, sizeof(Agent));
+   this->fd = fd;
+   this->address = xStrdup(address);
+   this->restricted = restricted;
+   for (int i = 0; i < AGENT_MAX_CLIENTS; i++) {
+      this->clients[i].fd = -1;
+      SnapshotBuffer_init(&this->clients[i].out);
+   }
+   this->current = Snapshot_new();
+   this->previous = Snapshot_new();
+   SnapshotBuffer_init(&this->header);
+   SnapshotBuffer_init(&this->keyframe);
+   SnapshotBuffer_init(&this->delta);
+   Recorder_writeHeader(&this->header);
+   return this;
+}
+
+static void AgentClient_close(AgentClient* client) {
+   close(client->fd);
+   client->fd = -1;
+}
+
+void Agent_delete(Agent* this) {
+   if (!this)
+      return;
+
+   for (int i = 0; i < AGENT_MAX_CLIENTS; i++) {
+      if (this->clients[i].fd >= 0)
+         AgentClient_close(&this->clients[i]);
+      SnapshotBuffer_done(&this->clients[i].out);
+   }
+   Socket_close(this->fd, this->address);
+   Snapshot_delete(this->current);
+   Snapshot_delete(this->previous);
+   SnapshotBuffer_done(&this->header);
+   SnapshotBuffer_done(&this->keyframe);
+   SnapshotBuffer_done(&this->delta);
+   free(this->address);
+   free(this);
+}
+
+static void Agent_encodeFrame(SnapshotBuffer* out, const Snapshot* snapshot, const Snapshot* prev) {
+   static const uint8_t placeholder[SNAPSHOT_FRAME_HEADER_SIZE];
+   SnapshotBuffer_reset(out);
+   SnapshotBuffer_append(out, placeholder, sizeof(placeholder));
+   Snapshot_encode(snapshot, prev, out);
+   Snapshot_putFrameHeader(out->data, out->size - SNAPSHOT_FRAME_HEADER_SIZE, prev ? 0 : SNAPSHOT_FRAME_KEY, snapshot->realtimeMs);
+}
+
+static inline bool AgentClient_isSending(const AgentClient* client) {
+   return client->sent < client->out.size;
+}
+
+static void AgentClient_write(AgentClient* client) {
+   while (AgentClient_isSending(client)) {
+      ssize_t n = write(client->fd, client->out.data + client->sent, client->out.size - client->sent);
+      if (n < 0 && errno == EINTR)
+         continue;
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+         return;
+      if (n <= 0) {
+         AgentClient_close(client);
+         return;
+      }
+      client->sent += n;
+   }
+}
+
+static void AgentClient_read(AgentClient* client) {
+   // clients have nothing to say, this only notices when they hang up
+   char discard[256];
+   ssize_t n = read(client->fd, discard, sizeof(discard));
+   if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+      AgentClient_close(client);
+}
+
+static void Agent_accept(Agent* this) {
+   int fd;
+   while ((fd = Socket_accept(this->fd)) >= 0) {
+      AgentClient* client = NULL;
+      for (int i = 0; i < AGENT_MAX_CLIENTS && !client; i++)
+         if (this->clients[i].fd < 0)
+            client = &this->clients[i];
+
+      if (!client) {
+         close(fd);
+         continue;
+      }
+
+      client->fd = fd;
+      client->sent = 0;
+      SnapshotBuffer_reset(&client->out);
+      SnapshotBuffer_append(&client->out, this->header.data, this->header.size);
+
+      // start right away with the latest scan instead of waiting for the next one
+      client->synced = this->scanned;
+      if (this->scanned) {
+         Agent_encodeFrame(&this->keyframe, this->previous, NULL);
+         SnapshotBuffer_append(&client->out, this->keyframe.data, this->keyframe.size);
+      }
+      AgentClient_write(client);
+   }
+}
+
+static void Agent_publish(Agent* this, const ProcessList* pl, const Header* header) {
+   Snapshot_capture(this->current, this->previous, pl, header);
+   if (!this->restricted)
+      Snapshot_dropRestricted(this->current);
+
+   bool needKeyframe = false;
+   bool needDelta = false;
+   for (int i = 0; i < AGENT_MAX_CLIENTS; i++) {
+      AgentClient* client = &this->clients[i];
+      if (client->fd < 0)
+         continue;
+
+      if (AgentClient_isSending(client))
+         client->synced = false;
+      else if (client->synced && this->scanned)
+         needDelta = true;
+      else
+         needKeyframe = true;
+   }
+
+   if (needKeyframe)
+      Agent_encodeFrame(&this->keyframe, this->current, NULL);
+   if (needDelta)
+      Agent_encodeFrame(&this->delta, this->current, this->previous);
+
+   for (int i = 0; i < AGENT_MAX_CLIENTS; i++) {
+      AgentClient* client = &this->clients[i];
+      if (client->fd < 0 || AgentClient_isSending(client))
+         continue;
+
+      const SnapshotBuffer* frame = client->synced && this->scanned ? &this->delta : &this->keyframe;
+      SnapshotBuffer_reset(&client->out);
+      SnapshotBuffer_append(&client->out, frame->data, frame->size);
+      client->sent = 0;
+      client->synced = true;
+      AgentClient_write(client);
+   }
+
+   Snapshot* t = this->previous;
+   this->previous = this->current;
+   this->current = t;
+   this->scanned = true;
+}
+
+/* Accepts clients and sends them what is pending until the deadline has passed */
+static void Agent_serve(Agent* this, uint64_t deadlineMs) {
+   struct pollfd fds[AGENT_MAX_CLIENTS + 1];
+   int slots[AGENT_MAX_CLIENTS + 1];
+
+   while (!Agent_stopped) {
+      uint64_t now;
+      Platform_gettime_monotonic(&now);
+      if (now >= deadlineMs)
+         return;
+
+      nfds_t n = 0;
+      fds[n] = (struct pollfd) { .fd = this->fd, .events = POLLIN };
+      slots[n++] = -1;
+      for (int i = 0; i < AGENT_MAX_CLIENTS; i++) {
+         if (this->clients[i].fd < 0)
+            continue;
+         fds[n] = (struct pollfd) { .fd = this->clients[i].fd, .events = AgentClient_isSending(&this->clients[i]) ? POLLIN | POLLOUT : POLLIN };
+         slots[n++] = i;
+      }
+
+      if (poll(fds, n, (int)MINIMUM(deadlineMs - now, (uint64_t)INT_MAX)) <= 0)
+         continue;
+
+      for (nfds_t k = 0; k < n; k++) {
+         if (!fds[k].revents)
+            continue;
+
+         if (slots[k] < 0) {
+            Agent_accept(this);
+            continue;
+         }
+
+         AgentClient* client = &this->clients[slots[k]];
+         if (client->fd >= 0 && (fds[k].revents & (POLLIN | POLLHUP | POLLERR)))
+            AgentClient_read(client);
+         if (client->fd >= 0 && (fds[k].revents & POLLOUT))
+            AgentClient_write(client);
+      }
+   }
+}
+
+int Agent_run(Agent* this, ProcessList* pl, Header* header, const Settings* settings) {
+   CRT_initHeadless(settings);
+
+   struct sigaction act;
+   memset(&act, 0, sizeof(act));
+   act.sa_handler = Agent_stop;
+   sigemptyset(&act.sa_mask);
+   sigaction(SIGINT, &act, NULL);
+   sigaction(SIGTERM, &act, NULL);
+   signal(SIGPIPE, SIG_IGN);
+
+   // prime the CPU counters, the first scan has nothing to compare against
+   Platform_gettime_realtime(&pl->realtime, &pl->realtimeMs);
+   ProcessList_scan(pl, false);
+
+   uint64_t next;
+   Platform_gettime_monotonic(&next);
+
+   while (!Agent_stopped) {
+      next += 100 * (uint64_t)settings->delay;
+      Agent_serve(this, next);
+      if (Agent_stopped)
+         break;
+
+      Platform_gettime_realtime(&pl->realtime, &pl->realtimeMs);
+      ProcessList_scan(pl, false);
+      Header_updateData(header);
+      Agent_publish(this, pl, header);
+   }
+   return 0;
+}
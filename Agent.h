@@ -0,0 +1,58 @@
+#ifndef HEADER_Agent
+#define HEADER_Agent
+/*
+htop - Agent.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "Header.h"
+#include "ProcessList.h"
+#include "Settings.h"
+#include "Snapshot.h"
+
+
+#define AGENT_MAX_CLIENTS 16
+
+typedef struct AgentClient_ {
+   int fd;                    /* -1 if the slot is free */
+   bool synced;               /* got every frame since its last keyframe */
+   SnapshotBuffer out;
+   size_t sent;
+} AgentClient;
+
+/*
+ * Streams every scan to the clients connected to it.  A stream has the
+ * format of a recording: the file header followed by frames, where each
+ * client starts with a keyframe and then gets deltas.  A client that is
+ * still receiving an earlier frame skips scans and resumes with a
+ * keyframe, so slow readers never hold up the agent.
+ */
+typedef struct Agent_ {
+   int fd;
+   char* address;
+   AgentClient clients[AGENT_MAX_CLIENTS];
+   Snapshot* current;
+   Snapshot* previous;         /* the last scan sent, empty before the first one */
+   bool restricted;            /* also send the fields that need ptrace access */
+   bool scanned;
+   SnapshotBuffer header;
+   SnapshotBuffer keyframe;
+   SnapshotBuffer delta;
+} Agent;
+
+/* Starts listening on the address, returns NULL with errno set on failure;
+ * the fields marked restricted are only sent when asked for, as anyone who
+ * can connect gets them */
+Agent* Agent_new(const char* address, bool restricted);
+
+void Agent_delete(Agent* this);
+
+/* Scans every update interval and streams the result until interrupted */
+int Agent_run(Agent* this, ProcessList* pl, Header* header, const Settings* settings);
+
+#endif
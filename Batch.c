@@ -0,0 +1,250 @@
+/*
+htop - Batch.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "Batch.h"
+
+#include <inttypes.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <wchar.h>
+
+#include "CRT.h"
+#include "Hashtable.h"
+#include "Platform.h"
+#include "Process.h"
+#include "RichString.h"
+#include "XUtils.h"
+
+
+/* Records are formatted into one reused buffer which is handed to stdio
+ * whenever it runs low, so memory use does not grow with the process count. */
+#define BATCH_BUFFER_SIZE (64 * 1024)
+#define BATCH_FIELD_RESERVE (RICHSTRING_MAXLEN * 6 + 64)
+
+static char Batch_buffer[BATCH_BUFFER_SIZE];
+static size_t Batch_len;
+
+static void Batch_flush(void) {
+   if (Batch_len > 0)
+      fwrite(Batch_buffer, 1, Batch_len, stdout);
+   Batch_len = 0;
+}
+
+static inline void Batch_reserve(size_t n) {
+   if (Batch_len + n > BATCH_BUFFER_SIZE)
+      Batch_flush();
+}
+
+static inline void Batch_putc(char c) {
+   Batch_buffer[Batch_len++] = c;
+}
+
+static void Batch_puts(const char* s) {
+   size_t n = strlen(s);
+   Batch_reserve(n);
+   memcpy(Batch_buffer + Batch_len, s, n);
+   Batch_len += n;
+}
+
+/* Convert a rendered column back to plain text, without the padding. */
+static size_t Batch_plainText(const RichString* str, char* out, size_t size) {
+   int start = 0;
+   int end = RichString_size(str);
+   while (start < end && RichString_getCharVal(*str, start) == ' ')
+      start++;
+   while (end > start && RichString_getCharVal(*str, end - 1) == ' ')
+      end--;
+
+   size_t len = 0;
+   mbstate_t state;
+   memset(&state, 0, sizeof(state));
+   for (int i = start; i < end && len + MB_LEN_MAX < size; i++) {
+      wchar_t c = (wchar_t) RichString_getCharVal(*str, i);
+      if (c < 0x80) {
+         out[len++] = (char) c;
+      } else {
+         size_t n = wcrtomb(out + len, c, &state);
+         if (n == (size_t)-1) {
+            out[len++] = '?';
+            memset(&state, 0, sizeof(state));
+         } else {
+            len += n;
+         }
+      }
+   }
+   out[len] = '\0';
+   return len;
+}
+
+static bool Batch_isNumber(const char* s) {
+   if (*s == '-')
+      s++;
+   if (*s < '0' || *s > '9')
+      return false;
+   while (*s >= '0' && *s <= '9')
+      s++;
+   if (*s == '.') {
+      s++;
+      if (*s < '0' || *s > '9')
+         return false;
+      while (*s >= '0' && *s <= '9')
+         s++;
+   }
+   return *s == '\0';
+}
+
+static void Batch_putJsonString(const char* s) {
+   Batch_putc('"');
+   for (; *s; s++) {
+      unsigned char c = (unsigned char) *s;
+      if (c == '"' || c == '\\') {
+         Batch_putc('\\');
+         Batch_putc((char) c);
+      } else if (c < 0x20) {
+         Batch_len += (size_t) snprintf(Batch_buffer + Batch_len, 7, "\\u%04x", c);
+      } else {
+         Batch_putc((char) c);
+      }
+   }
+   Batch_putc('"');
+}
+
+static void Batch_putCsvString(const char* s) {
+   if (!strpbrk(s, ",\"\n\r")) {
+      size_t n = strlen(s);
+      memcpy(Batch_buffer + Batch_len, s, n);
+      Batch_len += n;
+      return;
+   }
+
+   Batch_putc('"');
+   for (; *s; s++) {
+      if (*s == '"')
+         Batch_putc('"');
+      Batch_putc(*s);
+   }
+   Batch_putc('"');
+}
+
+static void Batch_writeHeader(const Settings* settings, BatchFormat format) {
+   if (format != BATCH_FORMAT_CSV)
+      return;
+
+   Batch_puts("ts");
+   for (int i = 0; settings->fields[i]; i++) {
+      Batch_reserve(BATCH_FIELD_RESERVE);
+      Batch_putc(',');
+      Batch_putCsvString(Process_fields[settings->fields[i]].name);
+   }
+   Batch_puts("\n");
+}
+
+static void Batch_writeProcess(const Process* p, const Settings* settings, BatchFormat format, uint64_t timestamp, RichString* str) {
+   char ts[24];
+   xSnprintf(ts, sizeof(ts), "%" PRIu64, timestamp);
+
+   if (format == BATCH_FORMAT_JSON) {
+      Batch_puts("{\"ts\":");
+      Batch_puts(ts);
+   } else {
+      Batch_puts(ts);
+   }
+
+   char text[BATCH_FIELD_RESERVE];
+   for (int i = 0; settings->fields[i]; i++) {
+      ProcessField field = settings->fields[i];
+
+      RichString_rewind(str, RichString_size(str));
+      As_Process(p)->writeField(p, str, field);
+      Batch_plainText(str, text, sizeof(text));
+
+      Batch_reserve(2 * BATCH_FIELD_RESERVE);
+      Batch_putc(',');
+      if (format == BATCH_FORMAT_JSON) {
+         Batch_putJsonString(Process_fields[field].name);
+         Batch_putc(':');
+         if (Batch_isNumber(text)) {
+            Batch_puts(text);
+         } else {
+            Batch_putJsonString(text);
+         }
+      } else {
+         Batch_putCsvString(text);
+      }
+   }
+
+   Batch_puts(format == BATCH_FORMAT_JSON ? "}\n" : "\n");
+}
+
+static bool Batch_isShown(const ProcessList* pl, const Process* p) {
+   return p->show
+      && (pl->userId == (uid_t) -1 || p->st_uid == pl->userId)
+      && (!pl->incFilter || String_contains_i(Process_getCommand(p), pl->incFilter))
+      && (!pl->pidMatchList || Hashtable_get(pl->pidMatchList, p->tgid));
+}
+
+static void Batch_sleepUntil(uint64_t deadlineMs) {
+   uint64_t now;
+   Platform_gettime_monotonic(&now);
+   if (now >= deadlineMs)
+      return;
+
+   uint64_t ms = deadlineMs - now;
+   struct timespec req = {
+      .tv_sec = (time_t)(ms / 1000),
+      .tv_nsec = (long)(ms % 1000) * 1000000L
+   };
+   while (nanosleep(&req, &req) == -1) {
+      continue;
+   }
+}
+
+int Batch_run(ProcessList* pl, Header* header, const Settings* settings, BatchFormat format, int iterations) {
+   CRT_initHeadless(settings);
+
+   // prime the CPU counters, the first scan has nothing to compare against
+   Platform_gettime_realtime(&pl->realtime, &pl->realtimeMs);
+   ProcessList_scan(pl, false);
+
+   Batch_writeHeader(settings, format);
+
+   RichString_begin(str);
+
+   uint64_t next;
+   Platform_gettime_monotonic(&next);
+
+   for (int n = 0; iterations <= 0 || n < iterations; n++) {
+      next += 100 * (uint64_t)settings->delay;
+      Batch_sleepUntil(next);
+
+      Platform_gettime_realtime(&pl->realtime, &pl->realtimeMs);
+      ProcessList_scan(pl, false);
+      Header_updateData(header);
+      ProcessList_sort(pl);
+
+      const int count = ProcessList_size(pl);
+      for (int i = 0; i < count; i++) {
+         const Process* p = ProcessList_get(pl, i);
+         if (Batch_isShown(pl, p))
+            Batch_writeProcess(p, settings, format, pl->realtimeMs, &str);
+      }
+
+      Batch_flush();
+      if (fflush(stdout) != 0)
+         break;
+   }
+
+   RichString_delete(&str);
+   return ferror(stdout) ? 1 : 0;
+}
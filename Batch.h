@@ -0,0 +1,24 @@
+#ifndef HEADER_Batch
+#define HEADER_Batch
+/*
+htop - Batch.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "Header.h"
+#include "ProcessList.h"
+#include "Settings.h"
+
+
+typedef enum BatchFormat_ {
+   BATCH_FORMAT_JSON,
+   BATCH_FORMAT_CSV,
+} BatchFormat;
+
+/* Run without a terminal, writing one record per process and update to
+ * stdout.  A non-positive iteration count runs until interrupted. */
+int Batch_run(ProcessList* pl, Header* header, const Settings* settings, BatchFormat format, int iterations);
+
+#endif
@@ -59,6 +59,7 @@ const MeterClass BatteryMeter_class = {
    },
    .updateValues = BatteryMeter_updateValues,
    .defaultMode = TEXT_METERMODE,
+   .updateInterval = 100,
    .maxItems = 1,
    .total = 100.0,
    .attributes = BatteryMeter_attributes,
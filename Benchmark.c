@@ -0,0 +1,367 @@
+/*
+htop - Benchmark.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "Benchmark.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+#include "CRT.h"
+#include "FunctionBar.h"
+#include "Macros.h"
+#include "Panel.h"
+#include "Platform.h"
+#include "Process.h"
+#include "Profile.h"
+#include "ProvideCurses.h"
+#include "XUtils.h"
+
+
+typedef enum BenchmarkPhase_ {
+   BENCHMARK_SCAN_LIST,
+   BENCHMARK_SORT_LIST,
+   BENCHMARK_REBUILD_LIST,
+   BENCHMARK_SCAN_TREE,
+   BENCHMARK_SORT_TREE,
+   BENCHMARK_REBUILD_TREE,
+   BENCHMARK_PHASES
+} BenchmarkPhase;
+
+typedef struct BenchmarkTiming_ {
+   uint64_t totalNs;
+   uint64_t minNs;
+   uint64_t maxNs;
+} BenchmarkTiming;
+
+static const char* const Benchmark_phaseNames[BENCHMARK_PHASES] = {
+   [BENCHMARK_SCAN_LIST] = "tarama (liste)",
+   [BENCHMARK_SORT_LIST] = "sıralama (liste)",
+   [BENCHMARK_REBUILD_LIST] = "panel oluşturma (liste)",
+   [BENCHMARK_SCAN_TREE] = "tarama (ağaç)",
+   [BENCHMARK_SORT_TREE] = "sıralama (ağaç)",
+   [BENCHMARK_REBUILD_TREE] = "panel oluşturma (ağaç)",
+};
+
+static BenchmarkTiming Benchmark_timings[BENCHMARK_PHASES];
+
+static void Benchmark_account(BenchmarkPhase phase, uint64_t start) {
+   uint64_t ns = Profile_nowNs() - start;
+   BenchmarkTiming* timing = &Benchmark_timings[phase];
+   timing->minNs = timing->totalNs ? MINIMUM(timing->minNs, ns) : ns;
+   timing->maxNs = MAXIMUM(timing->maxNs, ns);
+   timing->totalNs += ns;
+}
+
+static long Benchmark_maxRssKiB(void) {
+   struct rusage usage;
+   if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return -1;
+   return usage.ru_maxrss;
+}
+
+/* One update as the interactive loop does it, timed phase by phase */
+static void Benchmark_update(ProcessList* pl, bool tree) {
+   const BenchmarkPhase base = tree ? BENCHMARK_SCAN_TREE : BENCHMARK_SCAN_LIST;
+
+   Platform_gettime_realtime(&pl->realtime, &pl->realtimeMs);
+   uint64_t start = Profile_nowNs();
+   ProcessList_scan(pl, false);
+   Benchmark_account(base, start);
+
+   start = Profile_nowNs();
+   ProcessList_sort(pl);
+   Benchmark_account(base + 1, start);
+
+   start = Profile_nowNs();
+   ProcessList_rebuildPanel(pl);
+   Benchmark_account(base + 2, start);
+}
+
+int Benchmark_run(ProcessList* pl, Settings* settings, int iterations) {
+   CRT_initHeadless(settings);
+   Profile_enable();
+
+   Panel* panel = Panel_new(0, 0, 1, 1, Class(Process), false, FunctionBar_new(NULL, NULL, NULL));
+   ProcessList_setPanel(pl, panel);
+
+   const bool treeView = settings->treeView;
+
+   // the first scan creates every process and reads its one-time data, it is reported on its own
+   settings->treeView = false;
+   uint64_t start = Profile_nowNs();
+   ProcessList_scan(pl, false);
+   uint64_t firstScanNs = Profile_nowNs() - start;
+   long firstScanRss = Benchmark_maxRssKiB();
+
+   for (int n = 0; n < iterations; n++) {
+      settings->treeView = false;
+      Benchmark_update(pl, false);
+      settings->treeView = true;
+      Benchmark_update(pl, true);
+   }
+   settings->treeView = treeView;
+
+   printf("htop kıyaslaması: %d süreç, %u görev, %d yineleme\n", ProcessList_size(pl), pl->totalTasks, iterations);
+   printf("%12.3f ms  ilk tarama\n", firstScanNs / 1e6);
+   printf("%12s %12s %12s  %s\n", "ort. ms", "min. ms", "maks. ms", "aşama");
+   for (int i = 0; i < BENCHMARK_PHASES; i++) {
+      const BenchmarkTiming* timing = &Benchmark_timings[i];
+      printf("%12.3f %12.3f %12.3f  %s\n",
+             timing->totalNs / 1e6 / MAXIMUM(iterations, 1),
+             timing->minNs / 1e6,
+             timing->maxNs / 1e6,
+             Benchmark_phaseNames[i]);
+   }
+   printf("%12ld KiB  ilk taramadan sonra en yüksek RSS\n", firstScanRss);
+   printf("%12ld KiB  en yüksek RSS\n", Benchmark_maxRssKiB());
+   Profile_report(stdout);
+
+   ProcessList_setPanel(pl, NULL);
+   Panel_delete((Object*)panel);
+   Profile_disable();
+   return 0;
+}
+
+/* Special keys are sent as the sequence the terminal description gives for them */
+typedef struct RenderKey_ {
+   int key;
+   char capability[8];
+   int fallback;              /* byte sent if the terminal has no such key, 0 to leave the key out */
+} RenderKey;
+
+static RenderKey RenderBenchmark_keys[] = {
+   { KEY_DOWN, "kcud1", KEY_CTRL('N') },
+   { KEY_UP, "kcuu1", KEY_CTRL('P') },
+   { KEY_NPAGE, "knp", 0 },
+   { KEY_PPAGE, "kpp", 0 },
+   { KEY_HOME, "khome", KEY_CTRL('A') },
+   { KEY_END, "kend", KEY_CTRL('E') },
+   { KEY_BACKSPACE, "kbs", 127 },
+};
+
+/* The scenarios follow the manual test plan: moving through the list, the tree, sorting and filtering */
+static const RenderStep RenderBenchmark_scroll[] = {
+   { KEY_DOWN, 200 },
+   { KEY_NPAGE, 10 },
+   { KEY_END, 1 },
+   { KEY_PPAGE, 10 },
+   { KEY_UP, 50 },
+   { KEY_HOME, 1 },
+   { 0, 0 },
+};
+
+static const RenderStep RenderBenchmark_tree[] = {
+   { 't', 1 },
+   { KEY_DOWN, 30 },
+   { '-', 1 },
+   { KEY_DOWN, 20 },
+   { '+', 1 },
+   { '*', 1 },
+   { KEY_NPAGE, 5 },
+   { '*', 1 },
+   { KEY_HOME, 1 },
+   { 't', 1 },
+   { 0, 0 },
+};
+
+static const RenderStep RenderBenchmark_sort[] = {
+   { 'P', 1 },
+   { 'M', 1 },
+   { 'T', 1 },
+   { 'I', 1 },
+   { KEY_NPAGE, 3 },
+   { 'I', 1 },
+   { KEY_HOME, 1 },
+   { 'P', 1 },
+   { 0, 0 },
+};
+
+static const RenderStep RenderBenchmark_filter[] = {
+   { '\\', 1 },
+   { 's', 1 },
+   { 'h', 1 },
+   { 13, 1 },
+   { KEY_DOWN, 20 },
+   { '\\', 1 },
+   { KEY_BACKSPACE, 2 },
+   { 13, 1 },
+   { 0, 0 },
+};
+
+static const struct {
+   const char* name;
+   const RenderStep* steps;
+} RenderBenchmark_scenarios[] = {
+   { "scroll", RenderBenchmark_scroll },
+   { "tree", RenderBenchmark_tree },
+   { "sort", RenderBenchmark_sort },
+   { "filter", RenderBenchmark_filter },
+   { "all", NULL },
+};
+
+RenderBenchmark* RenderBenchmark_new(const char* scenario, const char* size, int repeat) {
+   const RenderStep* steps = NULL;
+   bool found = false;
+   for (size_t i = 0; i < ARRAYSIZE(RenderBenchmark_scenarios); i++) {
+      if (String_eq(scenario, RenderBenchmark_scenarios[i].name)) {
+         steps = RenderBenchmark_scenarios[i].steps;
+         found = true;
+         break;
+      }
+   }
+
+   int cols = 400;
+   int rows = 120;
+   char end;
+   if (!found || (size && (sscanf(size, "%5dx%5d%c", &cols, &rows, &end) != 2 || cols < 10 || rows < 5))) {
+      errno = EINVAL;
+      return NULL;
+   }
+
+   RenderBenchmark* this = xCalloc(1, sizeof(RenderBenchmark));
+   this->scenario = scenario;
+   this->steps = steps;
+   this->cols = cols;
+   this->rows = rows;
+   this->repeat = MAXIMUM(repeat, 1);
+   this->savedStdin = -1;
+   this->savedStdout = -1;
+   return this;
+}
+
+void RenderBenchmark_delete(RenderBenchmark* this) {
+   if (!this)
+      return;
+
+   if (this->input)
+      fclose(this->input);
+   if (this->savedStdin >= 0)
+      close(this->savedStdin);
+   if (this->savedStdout >= 0)
+      close(this->savedStdout);
+   free(this);
+}
+
+bool RenderBenchmark_attach(RenderBenchmark* this) {
+   // without a terminal to ask, curses takes the size from the environment
+   char value[16];
+   xSnprintf(value, sizeof(value), "%d", this->cols);
+   setenv("COLUMNS", value, 1);
+   xSnprintf(value, sizeof(value), "%d", this->rows);
+   setenv("LINES", value, 1);
+   setenv("TERM", "xterm", 0);
+
+   this->input = tmpfile();
+   FILE* output = tmpfile();
+   if (!this->input || !output) {
+      if (output)
+         fclose(output);
+      return false;
+   }
+
+   fflush(stdout);
+   this->savedStdin = dup(STDIN_FILENO);
+   this->savedStdout = dup(STDOUT_FILENO);
+   bool ok = this->savedStdin >= 0 && this->savedStdout >= 0
+          && dup2(fileno(this->input), STDIN_FILENO) >= 0
+          && dup2(fileno(output), STDOUT_FILENO) >= 0;
+   fclose(output);
+   return ok;
+}
+
+static void RenderBenchmark_putKey(RenderBenchmark* this, int key) {
+   if (key < 256) {
+      fputc(key, this->input);
+      this->keys++;
+      return;
+   }
+
+   for (size_t i = 0; i < ARRAYSIZE(RenderBenchmark_keys); i++) {
+      const RenderKey* k = &RenderBenchmark_keys[i];
+      if (k->key != key)
+         continue;
+
+      const char* sequence = tigetstr(RenderBenchmark_keys[i].capability);
+      if (sequence && sequence != (char*)-1) {
+         fputs(sequence, this->input);
+         this->keys++;
+      } else if (k->fallback) {
+         fputc(k->fallback, this->input);
+         this->keys++;
+      }
+      return;
+   }
+}
+
+static void RenderBenchmark_putSteps(RenderBenchmark* this, const RenderStep* steps) {
+   for (const RenderStep* step = steps; step->count; step++)
+      for (int n = 0; n < step->count; n++)
+         RenderBenchmark_putKey(this, step->key);
+}
+
+void RenderBenchmark_start(RenderBenchmark* this) {
+   for (int n = 0; n < this->repeat; n++) {
+      if (this->steps) {
+         RenderBenchmark_putSteps(this, this->steps);
+         continue;
+      }
+      for (size_t i = 0; i < ARRAYSIZE(RenderBenchmark_scenarios); i++)
+         if (RenderBenchmark_scenarios[i].steps)
+            RenderBenchmark_putSteps(this, RenderBenchmark_scenarios[i].steps);
+   }
+   fputc('q', this->input);
+   fflush(this->input);
+
+   // stdin shares the file offset, curses reads the keys from the start
+   lseek(STDIN_FILENO, 0, SEEK_SET);
+
+   struct stat st;
+   this->startBytes = fstat(STDOUT_FILENO, &st) == 0 ? (long)st.st_size : 0;
+   Profile_sum(&this->before);
+   this->startNs = Profile_nowNs();
+}
+
+void RenderBenchmark_stop(RenderBenchmark* this) {
+   this->elapsedNs = Profile_nowNs() - this->startNs;
+   Profile_sum(&this->after);
+
+   struct stat st;
+   this->bytes = fstat(STDOUT_FILENO, &st) == 0 ? (long)st.st_size - this->startBytes : 0;
+}
+
+void RenderBenchmark_report(RenderBenchmark* this) {
+   fflush(stdout);
+   dup2(this->savedStdin, STDIN_FILENO);
+   dup2(this->savedStdout, STDOUT_FILENO);
+
+   uint64_t frames = this->after.counters[PROFILE_FRAMES] - this->before.counters[PROFILE_FRAMES];
+   uint64_t drawNs = 0;
+   drawNs += this->after.phaseNs[PROFILE_HEADER_DRAW] - this->before.phaseNs[PROFILE_HEADER_DRAW];
+   drawNs += this->after.phaseNs[PROFILE_PANEL_DRAW] - this->before.phaseNs[PROFILE_PANEL_DRAW];
+   double seconds = this->elapsedNs / 1e9;
+   double perFrame = MAXIMUM(frames, 1);
+
+   printf("htop çizim kıyaslaması: senaryo %s, %dx%d, %d tekrar\n", this->scenario, this->cols, this->rows, this->repeat);
+   printf("%12u  tuş\n", this->keys);
+   printf("%12llu  kare\n", (unsigned long long)frames);
+   printf("%12.3f  s toplam\n", seconds);
+   printf("%12.1f  kare/s\n", seconds > 0 ? frames / seconds : 0.0);
+   printf("%12.3f  ms/kare toplam\n", this->elapsedNs / 1e6 / perFrame);
+   printf("%12.3f  ms/kare başlık ve panel çizimi\n", drawNs / 1e6 / perFrame);
+   printf("%12ld  bayt terminale yazıldı\n", this->bytes);
+   printf("%12.0f  bayt/kare\n", this->bytes / perFrame);
+   fflush(stdout);
+}
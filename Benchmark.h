@@ -0,0 +1,70 @@
+#ifndef HEADER_Benchmark
+#define HEADER_Benchmark
+/*
+htop - Benchmark.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "ProcessList.h"
+#include "Profile.h"
+#include "Settings.h"
+
+
+/* Scans, sorts and rebuilds the process list in list and in tree view
+ * the given number of times without a terminal and writes the time and
+ * memory every phase took to stdout. */
+int Benchmark_run(ProcessList* pl, Settings* settings, int iterations);
+
+typedef struct RenderStep_ {
+   int key;
+   int count;
+} RenderStep;
+
+/*
+ * Drives the interactive screen through a scripted key sequence on a
+ * virtual terminal: input is read from a file the keys were written to
+ * and output goes to a file that is only measured.  The usual curses
+ * setup and main loop run unchanged, so the frames drawn are the ones a
+ * user would see on a terminal of the chosen size.
+ */
+typedef struct RenderBenchmark_ {
+   const char* scenario;
+   const RenderStep* steps;   /* NULL runs every scenario in turn */
+   int cols;
+   int rows;
+   int repeat;
+   FILE* input;
+   int savedStdin;
+   int savedStdout;
+   unsigned int keys;
+   uint64_t startNs;
+   uint64_t elapsedNs;
+   long startBytes;
+   long bytes;
+   ProfileTick before;
+   ProfileTick after;
+} RenderBenchmark;
+
+/* Takes a scenario name and a COLSxROWS size, returns NULL with errno set if either is invalid */
+RenderBenchmark* RenderBenchmark_new(const char* scenario, const char* size, int repeat);
+
+void RenderBenchmark_delete(RenderBenchmark* this);
+
+/* Points stdin and stdout at the virtual terminal, called before curses is set up */
+bool RenderBenchmark_attach(RenderBenchmark* this);
+
+/* Queues the keys of the scenario ending with a quit, called right before the main loop */
+void RenderBenchmark_start(RenderBenchmark* this);
+
+/* Called right after the main loop returned */
+void RenderBenchmark_stop(RenderBenchmark* this);
+
+/* Restores stdin and stdout and writes the report there, called after curses was shut down */
+void RenderBenchmark_report(RenderBenchmark* this);
+
+#endif
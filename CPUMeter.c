@@ -22,6 +22,10 @@ in the source distribution for its full text.
 #include "Settings.h"
 #include "XUtils.h"
 
+#ifdef HAVE_LIBHWLOC
+#include <hwloc.h>
+#endif
+
 
 static const int CPUMeter_attributes[] = {
    CPU_NICE,
@@ -65,6 +69,12 @@ static void CPUMeter_updateValues(Meter* this) {
    char cpuTemperatureBuffer[16] = { 0 };
 
    double percent = Platform_setCPUValues(this, cpu);
+   if (isnan(percent)) {
+      // the platform knows the CPU but it is offline
+      this->values[CPU_METER_NORMAL] = NAN;
+      xSnprintf(this->txtBuffer, sizeof(this->txtBuffer), "kapalı");
+      return;
+   }
 
    if (this->pl->settings->showCPUUsage) {
       xSnprintf(cpuUsageBuffer, sizeof(cpuUsageBuffer), "%.1f%%", percent);
@@ -106,6 +116,10 @@ static void CPUMeter_display(const Object* cast, RichString* out) {
       RichString_appendAscii(out, CRT_colors[METER_TEXT], "yok");
       return;
    }
+   if (isnan(this->values[CPU_METER_NORMAL])) {
+      RichString_appendWide(out, CRT_colors[METER_TEXT], "kapalı");
+      return;
+   }
    xSnprintf(buffer, sizeof(buffer), "%5.1f%% ", this->values[CPU_METER_NORMAL]);
    RichString_appendAscii(out, CRT_colors[METER_TEXT], ":");
    RichString_appendAscii(out, CRT_colors[CPU_NORMAL], buffer);
@@ -191,8 +205,17 @@ static void AllCPUsMeter_updateValues(Meter* this) {
    Meter** meters = data->meters;
    int start, count;
    AllCPUsMeter_getRange(this, &start, &count);
-   for (int i = 0; i < count; i++)
+   for (int i = 0; i < count; i++) {
       Meter_updateValues(meters[i]);
+      Meter_sampleGraph(meters[i]);
+   }
+}
+
+static Meter** AllCPUsMeter_subMeters(const Meter* this, int* count) {
+   const CPUMeterData* data = this->meterData;
+   int start;
+   AllCPUsMeter_getRange(this, &start, count);
+   return data->meters;
 }
 
 static void CPUMeterCommonInit(Meter* this, int ncol) {
@@ -316,6 +339,229 @@ static void SingleColCPUsMeter_draw(Meter* this, int x, int y, int w) {
    }
 }
 
+/* ---------- CPU heatmap ---------- */
+
+#define CPUHEATMAP_ROW_CELLS 32    /* per row when sizing the meter, drawing fills the width */
+#define CPUHEATMAP_BUCKETS 9
+
+#if defined(HAVE_LIBHWLOC) && HWLOC_API_VERSION < 0x00010b00
+#define HWLOC_OBJ_PACKAGE HWLOC_OBJ_SOCKET
+#endif
+
+typedef struct CPUHeatmapRow_ {
+   unsigned int first;        /* index into order[] */
+   unsigned int count;
+   int group;                 /* NUMA node or package, -1 without topology */
+} CPUHeatmapRow;
+
+typedef struct CPUHeatmapData_ {
+   unsigned int cpus;
+   unsigned int* order;       /* CPU indexes in drawing order, grouped */
+   int* groups;               /* group per CPU, indexed like order[] */
+   uint8_t* buckets;          /* utilization bucket per CPU, indexed like order[] */
+   CPUHeatmapRow* rows;
+   unsigned int nRows;
+   unsigned int rowCells;     /* the rows were laid out for */
+   int labelLen;              /* including the space before the cells */
+   char groupKind;
+} CPUHeatmapData;
+
+static const int CPUHeatmap_colors[CPUHEATMAP_BUCKETS] = {
+   BAR_SHADOW,
+   CPU_NICE,
+   CPU_NICE,
+   CPU_NORMAL,
+   CPU_NORMAL,
+   METER_VALUE_WARN,
+   METER_VALUE_WARN,
+   METER_VALUE_ERROR,
+   METER_VALUE_ERROR,
+};
+
+static const char* const CPUHeatmap_glyphsAscii[CPUHEATMAP_BUCKETS] = {
+   ".", ":", "-", "=", "+", "*", "%", "#", "@"
+};
+
+#ifdef HAVE_LIBNCURSESW
+static const char* const CPUHeatmap_glyphsUtf8[CPUHEATMAP_BUCKETS] = {
+   "·", "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"
+};
+#endif
+
+/* percent -> bucket, filled once so updates do no arithmetic per CPU */
+static uint8_t CPUHeatmap_bucketOf[101];
+
+static void CPUHeatmap_initBuckets(void) {
+   if (CPUHeatmap_bucketOf[100])
+      return;
+
+   for (int p = 1; p <= 100; p++)
+      CPUHeatmap_bucketOf[p] = 1 + (p - 1) * (CPUHEATMAP_BUCKETS - 1) / 100;
+}
+
+#ifdef HAVE_LIBHWLOC
+static int CPUHeatmap_assignGroups(const ProcessList* pl, int* group, unsigned int cpus, char* kind) {
+   if (!pl->topologyOk)
+      return 0;
+
+   hwloc_obj_type_t type = HWLOC_OBJ_NUMANODE;
+   *kind = 'N';
+   int n = hwloc_get_nbobjs_by_type(pl->topology, type);
+   if (n <= 1) {
+      type = HWLOC_OBJ_PACKAGE;
+      *kind = 'P';
+      n = hwloc_get_nbobjs_by_type(pl->topology, type);
+   }
+   if (n <= 1)
+      return 0;
+
+   for (int g = 0; g < n; g++) {
+      hwloc_obj_t obj = hwloc_get_obj_by_type(pl->topology, type, g);
+      if (!obj || !obj->cpuset)
+         continue;
+
+      for (unsigned int cpu = 0; cpu < cpus; cpu++) {
+         if (group[cpu] < 0 && hwloc_bitmap_isset(obj->cpuset, cpu))
+            group[cpu] = g;
+      }
+   }
+   return n;
+}
+#endif
+
+/* Starts a new row for every group and every rowCells CPUs */
+static void CPUHeatmap_layout(CPUHeatmapData* data, unsigned int rowCells) {
+   data->nRows = 0;
+   data->rowCells = rowCells;
+   for (unsigned int i = 0; i < data->cpus; i++) {
+      CPUHeatmapRow* row = data->nRows ? &data->rows[data->nRows - 1] : NULL;
+      if (!row || row->count == rowCells || row->group != data->groups[i]) {
+         row = &data->rows[data->nRows++];
+         row->first = i;
+         row->count = 0;
+         row->group = data->groups[i];
+      }
+      row->count++;
+   }
+}
+
+static void CPUHeatmapMeter_init(Meter* this) {
+   if (this->meterData)
+      return;
+
+   CPUHeatmap_initBuckets();
+
+   unsigned int cpus = this->pl->cpuCount;
+   CPUHeatmapData* data = this->meterData = xCalloc(1, sizeof(CPUHeatmapData));
+   data->cpus = cpus;
+   data->order = xCalloc(cpus, sizeof(unsigned int));
+   data->groups = xCalloc(cpus, sizeof(int));
+   data->buckets = xCalloc(cpus, sizeof(uint8_t));
+
+   int* group = xMalloc(cpus * sizeof(int));
+   for (unsigned int cpu = 0; cpu < cpus; cpu++)
+      group[cpu] = -1;
+
+   int nGroups = 0;
+   #ifdef HAVE_LIBHWLOC
+   nGroups = CPUHeatmap_assignGroups(this->pl, group, cpus, &data->groupKind);
+   #endif
+
+   // CPUs the topology does not know about end up in a trailing group
+   unsigned int n = 0;
+   for (int g = 0; g <= nGroups; g++) {
+      int key = g < nGroups ? g : -1;
+      for (unsigned int cpu = 0; cpu < cpus; cpu++) {
+         if (group[cpu] == key) {
+            data->groups[n] = key;
+            data->order[n++] = cpu;
+         }
+      }
+   }
+   free(group);
+
+   // room for the caption or the widest group label, like "N12"
+   char label[16];
+   int labelLen = nGroups ? xSnprintf(label, sizeof(label), "%c%d", data->groupKind, nGroups - 1) : 0;
+   data->labelLen = MAXIMUM(labelLen, (int)strlen(this->caption)) + 1;
+
+   data->rows = xCalloc(MAXIMUM(cpus, 1U), sizeof(CPUHeatmapRow));
+   CPUHeatmap_layout(data, CPUHEATMAP_ROW_CELLS);
+   this->h = MAXIMUM(data->nRows, 1U);
+}
+
+static void CPUHeatmapMeter_done(Meter* this) {
+   CPUHeatmapData* data = this->meterData;
+   free(data->order);
+   free(data->groups);
+   free(data->buckets);
+   free(data->rows);
+   free(data);
+}
+
+static void CPUHeatmapMeter_updateValues(Meter* this) {
+   CPUHeatmapData* data = this->meterData;
+   unsigned int cpus = MINIMUM(data->cpus, this->pl->cpuCount);
+   for (unsigned int i = 0; i < data->cpus; i++) {
+      unsigned int cpu = data->order[i];
+      if (cpu >= cpus) {
+         data->buckets[i] = 0;
+         continue;
+      }
+      double percent = Platform_setCPUValues(this, cpu + 1);
+      data->buckets[i] = isnan(percent) ? 0 : CPUHeatmap_bucketOf[(int) lround(CLAMP(percent, 0.0, 100.0))];
+   }
+   xSnprintf(this->txtBuffer, sizeof(this->txtBuffer), "%u CPU", data->cpus);
+}
+
+static void CPUHeatmapMeter_draw(Meter* this, int x, int y, int w) {
+   CPUHeatmapData* data = this->meterData;
+
+   const char* const* glyphs = CPUHeatmap_glyphsAscii;
+   #ifdef HAVE_LIBNCURSESW
+   if (CRT_utf8)
+      glyphs = CPUHeatmap_glyphsUtf8;
+   #endif
+
+   // the height was set for CPUHEATMAP_ROW_CELLS per row, the rows take what the width
+   // allows and CPUs beyond the last row are marked as cut off
+   unsigned int cells = (unsigned int)MAXIMUM(w - data->labelLen, 2);
+   if (cells != data->rowCells)
+      CPUHeatmap_layout(data, cells);
+   unsigned int nRows = MINIMUM(data->nRows, (unsigned int)this->h);
+   for (unsigned int r = 0; r < nRows; r++) {
+      const CPUHeatmapRow* row = &data->rows[r];
+
+      char label[16] = "";
+      if (r == 0 || row->group != data->rows[r - 1].group) {
+         if (row->group >= 0)
+            xSnprintf(label, sizeof(label), "%c%d", data->groupKind, row->group);
+         else if (r == 0)
+            xSnprintf(label, sizeof(label), "%s", this->caption);
+      }
+      attrset(CRT_colors[METER_TEXT]);
+      mvaddnstr(y + (int)r, x, label, data->labelLen - 1);
+
+      bool cut = r + 1 == nRows && nRows < data->nRows;
+      unsigned int count = cut ? MINIMUM(row->count, cells - 1) : row->count;
+      int last = -1;
+      move(y + (int)r, x + data->labelLen);
+      for (unsigned int i = 0; i < count; i++) {
+         uint8_t bucket = data->buckets[row->first + i];
+         if (CPUHeatmap_colors[bucket] != last) {
+            last = CPUHeatmap_colors[bucket];
+            attrset(CRT_colors[last]);
+         }
+         addstr(glyphs[bucket]);
+      }
+      if (cut) {
+         attrset(CRT_colors[METER_TEXT]);
+         addstr(">");
+      }
+   }
+   attrset(CRT_colors[RESET_COLOR]);
+}
+
 
 const MeterClass CPUMeter_class = {
    .super = {
@@ -341,6 +587,7 @@ const MeterClass AllCPUsMeter_class = {
       .display = CPUMeter_display
    },
    .updateValues = AllCPUsMeter_updateValues,
+   .subMeters = AllCPUsMeter_subMeters,
    .defaultMode = CUSTOM_METERMODE,
    .total = 100.0,
    .attributes = CPUMeter_attributes,
@@ -361,6 +608,7 @@ const MeterClass AllCPUs2Meter_class = {
       .display = CPUMeter_display
    },
    .updateValues = AllCPUsMeter_updateValues,
+   .subMeters = AllCPUsMeter_subMeters,
    .defaultMode = CUSTOM_METERMODE,
    .total = 100.0,
    .attributes = CPUMeter_attributes,
@@ -381,6 +629,7 @@ const MeterClass LeftCPUsMeter_class = {
       .display = CPUMeter_display
    },
    .updateValues = AllCPUsMeter_updateValues,
+   .subMeters = AllCPUsMeter_subMeters,
    .defaultMode = CUSTOM_METERMODE,
    .total = 100.0,
    .attributes = CPUMeter_attributes,
@@ -401,6 +650,7 @@ const MeterClass RightCPUsMeter_class = {
       .display = CPUMeter_display
    },
    .updateValues = AllCPUsMeter_updateValues,
+   .subMeters = AllCPUsMeter_subMeters,
    .defaultMode = CUSTOM_METERMODE,
    .total = 100.0,
    .attributes = CPUMeter_attributes,
@@ -421,6 +671,7 @@ const MeterClass LeftCPUs2Meter_class = {
       .display = CPUMeter_display
    },
    .updateValues = AllCPUsMeter_updateValues,
+   .subMeters = AllCPUsMeter_subMeters,
    .defaultMode = CUSTOM_METERMODE,
    .total = 100.0,
    .attributes = CPUMeter_attributes,
@@ -441,6 +692,7 @@ const MeterClass RightCPUs2Meter_class = {
       .display = CPUMeter_display
    },
    .updateValues = AllCPUsMeter_updateValues,
+   .subMeters = AllCPUsMeter_subMeters,
    .defaultMode = CUSTOM_METERMODE,
    .total = 100.0,
    .attributes = CPUMeter_attributes,
@@ -461,6 +713,7 @@ const MeterClass AllCPUs4Meter_class = {
       .display = CPUMeter_display
    },
    .updateValues = AllCPUsMeter_updateValues,
+   .subMeters = AllCPUsMeter_subMeters,
    .defaultMode = CUSTOM_METERMODE,
    .total = 100.0,
    .attributes = CPUMeter_attributes,
@@ -481,6 +734,7 @@ const MeterClass LeftCPUs4Meter_class = {
       .display = CPUMeter_display
    },
    .updateValues = AllCPUsMeter_updateValues,
+   .subMeters = AllCPUsMeter_subMeters,
    .defaultMode = CUSTOM_METERMODE,
    .total = 100.0,
    .attributes = CPUMeter_attributes,
@@ -501,6 +755,7 @@ const MeterClass RightCPUs4Meter_class = {
       .display = CPUMeter_display
    },
    .updateValues = AllCPUsMeter_updateValues,
+   .subMeters = AllCPUsMeter_subMeters,
    .defaultMode = CUSTOM_METERMODE,
    .total = 100.0,
    .attributes = CPUMeter_attributes,
@@ -521,6 +776,7 @@ const MeterClass AllCPUs8Meter_class = {
       .display = CPUMeter_display
    },
    .updateValues = AllCPUsMeter_updateValues,
+   .subMeters = AllCPUsMeter_subMeters,
    .defaultMode = CUSTOM_METERMODE,
    .total = 100.0,
    .attributes = CPUMeter_attributes,
@@ -541,6 +797,7 @@ const MeterClass LeftCPUs8Meter_class = {
       .display = CPUMeter_display
    },
    .updateValues = AllCPUsMeter_updateValues,
+   .subMeters = AllCPUsMeter_subMeters,
    .defaultMode = CUSTOM_METERMODE,
    .total = 100.0,
    .attributes = CPUMeter_attributes,
@@ -561,6 +818,7 @@ const MeterClass RightCPUs8Meter_class = {
       .display = CPUMeter_display
    },
    .updateValues = AllCPUsMeter_updateValues,
+   .subMeters = AllCPUsMeter_subMeters,
    .defaultMode = CUSTOM_METERMODE,
    .total = 100.0,
    .attributes = CPUMeter_attributes,
@@ -573,3 +831,23 @@ const MeterClass RightCPUs8Meter_class = {
    .updateMode = OctoColCPUsMeter_updateMode,
    .done = AllCPUsMeter_done
 };
+
+const MeterClass CPUHeatmapMeter_class = {
+   .super = {
+      .extends = Class(Meter),
+      .delete = Meter_delete,
+      .display = CPUMeter_display
+   },
+   .updateValues = CPUHeatmapMeter_updateValues,
+   .defaultMode = CUSTOM_METERMODE,
+   .maxItems = CPU_METER_ITEMCOUNT,
+   .total = 100.0,
+   .attributes = CPUMeter_attributes,
+   .name = "CPUHeatmap",
+   .uiName = "CPU ısı haritası",
+   .description = "CPU ısı haritası: her CPU için kullanıma göre renklendirilmiş tek bir hücre",
+   .caption = "CPU",
+   .draw = CPUHeatmapMeter_draw,
+   .init = CPUHeatmapMeter_init,
+   .done = CPUHeatmapMeter_done
+};
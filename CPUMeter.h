@@ -49,4 +49,6 @@ extern const MeterClass LeftCPUs8Meter_class;
 
 extern const MeterClass RightCPUs8Meter_class;
 
+extern const MeterClass CPUHeatmapMeter_class;
+
 #endif
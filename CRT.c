@@ -856,6 +856,18 @@ void CRT_init(const Settings* settings, bool allowUnicode) {
    CRT_degreeSign = initDegreeSign();
 }
 
+/* Set up what rendering needs without touching the terminal, for batch output. */
+void CRT_initHeadless(const Settings* settings) {
+   CRT_delay = &(settings->delay);
+   CRT_colorScheme = COLORSCHEME_MONOCHROME;
+   CRT_colors = CRT_colorSchemes[COLORSCHEME_MONOCHROME];
+#ifdef HAVE_LIBNCURSESW
+   CRT_utf8 = false;
+#endif
+   CRT_treeStr = CRT_treeStrAscii;
+   CRT_degreeSign = initDegreeSign();
+}
+
 void CRT_done() {
    curs_set(1);
    endwin();
@@ -164,6 +164,8 @@ extern ColorScheme CRT_colorScheme;
 
 void CRT_init(const Settings* settings, bool allowUnicode);
 
+void CRT_initHeadless(const Settings* settings);
+
 void CRT_done(void);
 
 int CRT_readKey(void);
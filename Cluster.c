@@ -0,0 +1,204 @@
+/*
+htop - Cluster.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "Cluster.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "Macros.h"
+#include "Platform.h"
+#include "Process.h"
+#include "Replay.h"
+#include "Socket.h"
+#include "XUtils.h"
+
+
+Cluster* Cluster_new(const char* addresses) {
+   size_t nItems;
+   char** items = String_split(addresses, ',', &nItems);
+
+   unsigned int nHosts = 0;
+   for (size_t i = 0; i < nItems; i++)
+      if (items[i][0])
+         nHosts++;
+   if (nHosts == 0 || nHosts > PROCESS_MAX_HOSTS) {
+      String_freeArray(items);
+      errno = EINVAL;
+      return NULL;
+   }
+
+   Cluster* this = xCalloc(1, sizeof(Cluster));
+   this->hosts = xCalloc(nHosts, sizeof(ClusterHost));
+   this->names = xCalloc(nHosts, sizeof(const char*));
+   this->fds = xCalloc(nHosts, sizeof(struct pollfd));
+   this->merged = Snapshot_new();
+   for (size_t i = 0; i < nItems; i++) {
+      if (!items[i][0])
+         continue;
+
+      ClusterHost* host = &this->hosts[this->nHosts];
+      host->address = xStrdup(items[i]);
+      host->fd = -1;
+      SnapshotBuffer_init(&host->in);
+      host->current = Snapshot_new();
+      host->scratch = Snapshot_new();
+      this->names[this->nHosts++] = host->address;
+   }
+   String_freeArray(items);
+   return this;
+}
+
+static void ClusterHost_disconnect(ClusterHost* host, uint64_t now) {
+   if (host->fd >= 0)
+      close(host->fd);
+   host->fd = -1;
+   host->connected = false;
+   host->streaming = false;
+   host->valid = false;
+   host->retryMs = now + CLUSTER_RETRY_MS;
+   SnapshotBuffer_reset(&host->in);
+}
+
+void Cluster_delete(Cluster* this) {
+   if (!this)
+      return;
+
+   for (unsigned int i = 0; i < this->nHosts; i++) {
+      ClusterHost* host = &this->hosts[i];
+      if (host->fd >= 0)
+         close(host->fd);
+      SnapshotBuffer_done(&host->in);
+      Snapshot_delete(host->current);
+      Snapshot_delete(host->scratch);
+      free(host->address);
+   }
+   Snapshot_delete(this->merged);
+   free(this->hosts);
+   free(this->names);
+   free(this->fds);
+   free(this);
+}
+
+/* Decodes the complete frames received so far, false if the stream is broken */
+static bool ClusterHost_decode(ClusterHost* host) {
+   size_t offset = 0;
+   if (!host->streaming) {
+      ssize_t len = Replay_parseHeader(host->in.data, host->in.size, &host->codec);
+      if (len <= 0)
+         return len == 0;
+      offset = len;
+      host->streaming = true;
+   }
+
+   while (host->in.size - offset >= SNAPSHOT_FRAME_HEADER_SIZE) {
+      uint32_t len, flags;
+      uint64_t realtimeMs;
+      Snapshot_getFrameHeader(host->in.data + offset, &len, &flags, &realtimeMs);
+      if (len > host->in.size - offset - SNAPSHOT_FRAME_HEADER_SIZE)
+         break;
+
+      bool keyframe = flags & SNAPSHOT_FRAME_KEY;
+      if (!keyframe && !host->valid)
+         return false;
+      if (!Snapshot_decode(host->scratch, keyframe ? NULL : host->current, &host->codec, host->in.data + offset + SNAPSHOT_FRAME_HEADER_SIZE, len))
+         return false;
+      host->scratch->realtimeMs = realtimeMs;
+
+      Snapshot* t = host->current;
+      host->current = host->scratch;
+      host->scratch = t;
+      host->valid = true;
+      offset += SNAPSHOT_FRAME_HEADER_SIZE + len;
+   }
+
+   // keep the start of a frame that is still incomplete at the front of the buffer
+   memmove(host->in.data, host->in.data + offset, host->in.size - offset);
+   host->in.size -= offset;
+   return true;
+}
+
+static void ClusterHost_receive(ClusterHost* host, uint64_t now) {
+   for (;;) {
+      uint8_t* at = SnapshotBuffer_reserve(&host->in, CLUSTER_READ_CHUNK);
+      ssize_t n = read(host->fd, at, CLUSTER_READ_CHUNK);
+      if (n > 0) {
+         host->in.size += n;
+         continue;
+      }
+      if (n < 0 && errno == EINTR)
+         continue;
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+         break;
+
+      ClusterHost_disconnect(host, now);
+      return;
+   }
+
+   if (!ClusterHost_decode(host))
+      ClusterHost_disconnect(host, now);
+}
+
+static void ClusterHost_finishConnect(ClusterHost* host, uint64_t now) {
+   int err = 0;
+   socklen_t len = sizeof(err);
+   if (getsockopt(host->fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err != 0) {
+      ClusterHost_disconnect(host, now);
+      return;
+   }
+   host->connected = true;
+}
+
+void Cluster_advance(Cluster* this, ProcessList* pl, bool paused) {
+   pl->snapshot = this->merged;
+   pl->hostNames = this->names;
+   pl->hostCount = this->nHosts;
+   if (paused)
+      return;
+
+   uint64_t now;
+   Platform_gettime_monotonic(&now);
+   for (unsigned int i = 0; i < this->nHosts; i++) {
+      ClusterHost* host = &this->hosts[i];
+      if (host->fd < 0 && now >= host->retryMs) {
+         host->fd = Socket_connect(host->address);
+         if (host->fd < 0)
+            host->retryMs = now + CLUSTER_RETRY_MS;
+      }
+      this->fds[i] = (struct pollfd) { .fd = host->fd, .events = host->connected ? POLLIN : POLLOUT };
+   }
+
+   if (poll(this->fds, this->nHosts, 0) > 0) {
+      for (unsigned int i = 0; i < this->nHosts; i++) {
+         ClusterHost* host = &this->hosts[i];
+         if (host->fd < 0 || !this->fds[i].revents)
+            continue;
+
+         if (!host->connected)
+            ClusterHost_finishConnect(host, now);
+         else
+            ClusterHost_receive(host, now);
+      }
+   }
+
+   Snapshot_clear(this->merged);
+   for (unsigned int i = 0; i < this->nHosts; i++)
+      if (this->hosts[i].valid)
+         Snapshot_append(this->merged, this->hosts[i].current, (pid_t)((i + 1) << PROCESS_HOST_SHIFT));
+}
+
+void Cluster_status(const Cluster* this, char* buffer, size_t size) {
+   unsigned int live = 0;
+   for (unsigned int i = 0; i < this->nHosts; i++)
+      live += this->hosts[i].valid;
+   xSnprintf(buffer, size, "AJANLAR %u/%u", live, this->nHosts);
+}
@@ -0,0 +1,59 @@
+#ifndef HEADER_Cluster
+#define HEADER_Cluster
+/*
+htop - Cluster.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <poll.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ProcessList.h"
+#include "Snapshot.h"
+
+
+#define CLUSTER_RETRY_MS 5000
+#define CLUSTER_READ_CHUNK 65536
+
+typedef struct ClusterHost_ {
+   char* address;
+   int fd;                    /* -1 while disconnected */
+   bool connected;            /* the connection was made and the socket is readable */
+   uint64_t retryMs;          /* when to try connecting again */
+   SnapshotBuffer in;         /* received data not decoded yet, reused for the whole connection */
+   bool streaming;            /* the stream header was read */
+   SnapshotCodec codec;
+   Snapshot* current;
+   Snapshot* scratch;
+   bool valid;                /* current holds a scan of this connection */
+} ClusterHost;
+
+/*
+ * Connects to a number of agents and shows their processes as one list.
+ * Everything is non-blocking: each update polls all connections once,
+ * decodes the frames that arrived completely and merges the newest scan
+ * of every host into a snapshot that the process list is restored from.
+ */
+typedef struct Cluster_ {
+   ClusterHost* hosts;
+   unsigned int nHosts;
+   const char** names;
+   struct pollfd* fds;
+   Snapshot* merged;
+} Cluster;
+
+/* Takes a comma separated list of agent addresses, returns NULL with errno set if it is invalid */
+Cluster* Cluster_new(const char* addresses);
+
+void Cluster_delete(Cluster* this);
+
+/* Reads what the agents sent and points pl at the merged processes; keeps the current ones while paused */
+void Cluster_advance(Cluster* this, ProcessList* pl, bool paused);
+
+void Cluster_status(const Cluster* this, char* buffer, size_t size);
+
+#endif
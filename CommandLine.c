@@ -11,7 +11,9 @@ in the source distribution for its full text.
 #include "CommandLine.h"
 
 #include <assert.h>
+#include <errno.h>
 #include <getopt.h>
+#include <grp.h>
 #include <locale.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -21,9 +23,15 @@ in the source distribution for its full text.
 #include <unistd.h>
 
 #include "Action.h"
+#include "Agent.h"
+#include "Batch.h"
+#include "Benchmark.h"
 #include "CRT.h"
+#include "Cluster.h"
+#include "Exporter.h"
 #include "Hashtable.h"
 #include "Header.h"
+#include "History.h"
 #include "IncSet.h"
 #include "MainPanel.h"
 #include "MetersPanel.h"
@@ -31,9 +39,13 @@ in the source distribution for its full text.
 #include "Platform.h"
 #include "Process.h"
 #include "ProcessList.h"
+#include "Profile.h"
 #include "ProvideCurses.h"
+#include "Recorder.h"
+#include "Replay.h"
 #include "ScreenManager.h"
 #include "Settings.h"
+#include "SharedScan.h"
 #include "UsersTable.h"
 #include "XUtils.h"
 
@@ -46,13 +58,30 @@ static void printHelpFlag(const char* name) {
    printf("%s " VERSION "\n"
          COPYRIGHT "\n"
          "Released under the GNU GPLv2.\n\n"
+         "   --agent                      Terminal olmadan çalışın ve güncellemeleri --listen adresine bağlananlara gönderin\n"
+         "   --attach[=NAME]              Tarama yapmak yerine NAME paylaşımlı belleğinde yayınlanan güncellemeleri gösterin\n"
+         "-b --batch                      Terminal olmadan çalışın ve her güncellemede süreçleri stdout'a yazın\n"
+         "   --benchmark=N                Süreç listesini N kez tarayın, sıralayın ve aşamaların süresini yazdırın\n"
+         "   --connect=ADDR[,ADDR...]     Verilen ajanların süreçlerini tek bir listede gösterin\n"
          "-C --no-color                   Tek renkli bir renk düzeni kullanın\n"
          "-d --delay=DELAY                Güncellemeler arasındaki gecikmeyi saniyenin onda biri olarak ayarlayın\n"
+         "   --export=ADDR                Terminal olmadan çalışın ve ölçümleri ADDR üzerinden OpenMetrics olarak sunun\n"
+         "-f --format=json|csv            Toplu modun çıktı biçimi (varsayılan: json)\n"
          "-F --filter=FILTER              Yalnızca verilen filtreyle eşleşen komutları göster\n"
          "-h --help                       Bu yardım ekranını yazdırın\n"
          "-H --highlight-changes[=DELAY]  Yeni ve eski süreçleri vurgulayın\n"
+         "   --listen=ADDR                Ajan modunda bağlantıları ADDR adresinde (UNIX soketi veya [HOST:]PORT) bekleyin\n"
          "-M --no-mouse                   Fareyi devre dışı bırakın\n"
+         "-n --iterations=N               Toplu modda N güncellemeden sonra çıkın\n"
          "-p --pid=PID[,PID,PID...]       Yalnızca verilen PID'yi göster\n"
+         "   --profile-report             Çıkışta htop'un kendi tarama, sıralama ve çizim sürelerinin özetini yazdırın\n"
+         "   --record=FILE                Her güncellemeyi FILE kayıt dosyasına ekleyin\n"
+         "   --render-benchmark=SCENARIO  Ekranı sanal bir terminalde scroll, tree, sort, filter veya all senaryosuyla -n kez çizin ve kare hızını yazdırın\n"
+         "   --render-size=COLSxROWS      Çizim kıyaslamasının terminal boyutu (varsayılan: 400x120)\n"
+         "   --replay=FILE                Canlı veriler yerine FILE kaydını oynatın\n"
+         "   --send-restricted            Ajan modunda ptrace erişimi gerektiren alanları da gönderin\n"
+         "   --serve-shm[=NAME]           Terminal olmadan çalışın ve her güncellemeyi NAME paylaşımlı belleğinde yayınlayın\n"
+         "   --shm-group=GROUP            Paylaşımlı belleği GROUP grubunun okumasına izin verin\n"
          "-s --sort-key=COLUMN            Liste görünümünde SÜTUNA göre sırala (liste için --sort-key = yardım deneyin)\n"
          "-t --tree                       Ağaç görünümünü göster (-s ile birleştirilebilir)\n"
          "-u --user[=USERNAME]            Yalnızca belirli bir kullanıcı (veya $ USER) için işlemleri göster\n"
@@ -67,6 +96,23 @@ static void printHelpFlag(const char* name) {
 
 // ----------------------------------------
 
+enum {
+   LONGOPT_RECORD = 256,
+   LONGOPT_REPLAY,
+   LONGOPT_EXPORT,
+   LONGOPT_SERVE_SHM,
+   LONGOPT_SHM_GROUP,
+   LONGOPT_ATTACH,
+   LONGOPT_AGENT,
+   LONGOPT_LISTEN,
+   LONGOPT_SEND_RESTRICTED,
+   LONGOPT_CONNECT,
+   LONGOPT_PROFILE_REPORT,
+   LONGOPT_BENCHMARK,
+   LONGOPT_RENDER_BENCHMARK,
+   LONGOPT_RENDER_SIZE,
+};
+
 typedef struct CommandLineSettings_ {
    Hashtable* pidMatchList;
    char* commFilter;
@@ -79,6 +125,23 @@ typedef struct CommandLineSettings_ {
    bool allowUnicode;
    bool highlightChanges;
    int highlightDelaySecs;
+   bool batch;
+   BatchFormat batchFormat;
+   int iterations;
+   const char* recordPath;
+   const char* replayPath;
+   const char* exportAddress;
+   const char* serveShm;
+   const char* shmGroup;
+   const char* attachShm;
+   bool agent;
+   const char* listenAddress;
+   bool sendRestricted;
+   const char* connectAddresses;
+   bool profileReport;
+   int benchmark;
+   const char* renderBenchmark;
+   const char* renderSize;
 } CommandLineSettings;
 
 static CommandLineSettings parseArguments(const char* program, int argc, char** argv) {
@@ -95,6 +158,23 @@ static CommandLineSettings parseArguments(const char* program, int argc, char**
       .allowUnicode = true,
       .highlightChanges = false,
       .highlightDelaySecs = -1,
+      .batch = false,
+      .batchFormat = BATCH_FORMAT_JSON,
+      .iterations = 0,
+      .recordPath = NULL,
+      .replayPath = NULL,
+      .exportAddress = NULL,
+      .serveShm = NULL,
+      .shmGroup = NULL,
+      .attachShm = NULL,
+      .agent = false,
+      .listenAddress = NULL,
+      .sendRestricted = false,
+      .connectAddresses = NULL,
+      .profileReport = false,
+      .benchmark = 0,
+      .renderBenchmark = NULL,
+      .renderSize = NULL,
    };
 
    const struct option long_opts[] =
@@ -112,13 +192,30 @@ static CommandLineSettings parseArguments(const char* program, int argc, char**
       {"pid",        required_argument,   0, 'p'},
       {"filter",     required_argument,   0, 'F'},
       {"highlight-changes", optional_argument, 0, 'H'},
+      {"batch",      no_argument,         0, 'b'},
+      {"format",     required_argument,   0, 'f'},
+      {"iterations", required_argument,   0, 'n'},
+      {"record",     required_argument,   0, LONGOPT_RECORD},
+      {"replay",     required_argument,   0, LONGOPT_REPLAY},
+      {"export",     required_argument,   0, LONGOPT_EXPORT},
+      {"serve-shm",  optional_argument,   0, LONGOPT_SERVE_SHM},
+      {"shm-group",  required_argument,   0, LONGOPT_SHM_GROUP},
+      {"attach",     optional_argument,   0, LONGOPT_ATTACH},
+      {"agent",      no_argument,         0, LONGOPT_AGENT},
+      {"listen",     required_argument,   0, LONGOPT_LISTEN},
+      {"send-restricted", no_argument,    0, LONGOPT_SEND_RESTRICTED},
+      {"connect",    required_argument,   0, LONGOPT_CONNECT},
+      {"profile-report", no_argument,     0, LONGOPT_PROFILE_REPORT},
+      {"benchmark",  required_argument,   0, LONGOPT_BENCHMARK},
+      {"render-benchmark", required_argument, 0, LONGOPT_RENDER_BENCHMARK},
+      {"render-size", required_argument,  0, LONGOPT_RENDER_SIZE},
       PLATFORM_LONG_OPTIONS
       {0,0,0,0}
    };
 
    int opt, opti=0;
    /* Parse arguments */
-   while ((opt = getopt_long(argc, argv, "hVMCs:td:u::Up:F:H::", long_opts, &opti))) {
+   while ((opt = getopt_long(argc, argv, "hVMCs:td:u::Up:F:H::bf:n:", long_opts, &opti))) {
       if (opt == EOF) break;
       switch (opt) {
          case 'h':
@@ -231,6 +328,81 @@ static CommandLineSettings parseArguments(const char* program, int argc, char**
             flags.highlightChanges = true;
             break;
          }
+         case 'b':
+            flags.batch = true;
+            break;
+         case 'f':
+            assert(optarg);
+            if (String_eq(optarg, "json")) {
+               flags.batchFormat = BATCH_FORMAT_JSON;
+            } else if (String_eq(optarg, "csv")) {
+               flags.batchFormat = BATCH_FORMAT_CSV;
+            } else {
+               fprintf(stderr, "Hata: geçersiz çıktı biçimi \"%s\".\n", optarg);
+               exit(1);
+            }
+            break;
+         case 'n':
+            assert(optarg);
+            if (sscanf(optarg, "%16d", &(flags.iterations)) != 1 || flags.iterations < 1) {
+               fprintf(stderr, "Hata: geçersiz yineleme sayısı \"%s\".\n", optarg);
+               exit(1);
+            }
+            break;
+         case LONGOPT_RENDER_BENCHMARK:
+            assert(optarg);
+            flags.renderBenchmark = optarg;
+            break;
+         case LONGOPT_RENDER_SIZE:
+            assert(optarg);
+            flags.renderSize = optarg;
+            break;
+         case LONGOPT_RECORD:
+            assert(optarg);
+            flags.recordPath = optarg;
+            break;
+         case LONGOPT_REPLAY:
+            assert(optarg);
+            flags.replayPath = optarg;
+            break;
+         case LONGOPT_EXPORT:
+            assert(optarg);
+            flags.exportAddress = optarg;
+            break;
+         case LONGOPT_SERVE_SHM:
+            flags.serveShm = optarg ? optarg : SHARED_SCAN_DEFAULT_NAME;
+            break;
+         case LONGOPT_SHM_GROUP:
+            assert(optarg);
+            flags.shmGroup = optarg;
+            break;
+         case LONGOPT_ATTACH:
+            flags.attachShm = optarg ? optarg : SHARED_SCAN_DEFAULT_NAME;
+            break;
+         case LONGOPT_AGENT:
+            flags.agent = true;
+            break;
+         case LONGOPT_LISTEN:
+            assert(optarg);
+            flags.listenAddress = optarg;
+            break;
+         case LONGOPT_SEND_RESTRICTED:
+            flags.sendRestricted = true;
+            break;
+         case LONGOPT_CONNECT:
+            assert(optarg);
+            flags.connectAddresses = optarg;
+            break;
+         case LONGOPT_PROFILE_REPORT:
+            flags.profileReport = true;
+            break;
+         case LONGOPT_BENCHMARK:
+            assert(optarg);
+            if (sscanf(optarg, "%16d", &(flags.benchmark)) != 1 || flags.benchmark < 1) {
+               fprintf(stderr, "Hata: geçersiz yineleme sayısı \"%s\".\n", optarg);
+               exit(1);
+            }
+            break;
 
          default:
            if (Platform_getLongOption(opt, argc, argv) == false)
@@ -251,6 +423,29 @@ static void millisleep(unsigned long millisec) {
    }
 }
 
+/* The processes of agents are told apart by their host, show it next to the
+ * first column; returns whether it had to be added */
+static bool showHostColumn(Settings* settings) {
+   int n = 0;
+   for (; settings->fields[n]; n++)
+      if (settings->fields[n] == HOST)
+         return false;
+
+   int at = n ? 1 : 0;
+   memmove(&settings->fields[at + 1], &settings->fields[at], (n - at + 1) * sizeof(ProcessField));
+   settings->fields[at] = HOST;
+   return true;
+}
+
+/* Takes the column added by showHostColumn out again, it means nothing without agents */
+static void hideHostColumn(Settings* settings) {
+   int j = 0;
+   for (int i = 0; settings->fields[i]; i++)
+      if (settings->fields[i] != HOST)
+         settings->fields[j++] = settings->fields[i];
+   settings->fields[j] = NULL_PROCESSFIELD;
+}
+
 static void setCommFilter(State* state, char** commFilter) {
    ProcessList* pl = state->pl;
    IncSet* inc = state->mainPanel->inc;
@@ -273,12 +468,103 @@ int CommandLine_run(const char* name, int argc, char** argv) {
 
    CommandLineSettings flags = parseArguments(name, argc, argv);
 
+   int modes = flags.batch + !!flags.recordPath + !!flags.replayPath + !!flags.exportAddress + !!flags.serveShm + !!flags.attachShm + flags.agent + !!flags.connectAddresses + !!flags.benchmark;
+   if (modes > 1) {
+      fprintf(stderr, "Hata: --batch, --record, --replay, --export, --serve-shm, --attach, --agent, --connect ve --benchmark birbiriyle birlikte kullanılamaz.\n");
+      exit(1);
+   }
+   if (flags.renderBenchmark && (flags.batch || flags.exportAddress || flags.serveShm || flags.agent || flags.benchmark)) {
+      fprintf(stderr, "Hata: --render-benchmark terminal olmadan çalışan modlarla birlikte kullanılamaz.\n");
+      exit(1);
+   }
+   if (flags.renderSize && !flags.renderBenchmark) {
+      fprintf(stderr, "Hata: --render-size yalnızca --render-benchmark ile kullanılabilir.\n");
+      exit(1);
+   }
+   if (flags.agent != !!flags.listenAddress) {
+      fprintf(stderr, "Hata: --agent ve --listen yalnızca birlikte kullanılabilir.\n");
+      exit(1);
+   }
+
+   Recorder* recorder = NULL;
+   if (flags.recordPath && !(recorder = Recorder_new(flags.recordPath))) {
+      fprintf(stderr, "Hata: kayıt dosyası açılamıyor \"%s\": %s\n", flags.recordPath, strerror(errno));
+      exit(1);
+   }
+
+   Replay* replay = NULL;
+   if (flags.replayPath && !(replay = Replay_new(flags.replayPath))) {
+      fprintf(stderr, "Hata: kayıt oynatılamıyor \"%s\": %s\n", flags.replayPath, strerror(errno));
+      exit(1);
+   }
+
+   Exporter* exporter = NULL;
+   if (flags.exportAddress && !(exporter = Exporter_new(flags.exportAddress))) {
+      fprintf(stderr, "Hata: ölçümler sunulamıyor \"%s\": %s\n", flags.exportAddress, strerror(errno));
+      exit(1);
+   }
+
+   if (flags.shmGroup && !flags.serveShm) {
+      fprintf(stderr, "Hata: --shm-group yalnızca --serve-shm ile kullanılabilir.\n");
+      exit(1);
+   }
+   gid_t shmGroup = (gid_t)-1;
+   if (flags.shmGroup) {
+      const struct group* gr = getgrnam(flags.shmGroup);
+      if (!gr) {
+         fprintf(stderr, "Hata: bilinmeyen grup \"%s\".\n", flags.shmGroup);
+         exit(1);
+      }
+      shmGroup = gr->gr_gid;
+   }
+
+   SharedScan* shared = NULL;
+   if (flags.serveShm && !(shared = SharedScan_create(flags.serveShm, shmGroup))) {
+      fprintf(stderr, "Hata: paylaşımlı bellek oluşturulamıyor \"%s\": %s\n", flags.serveShm, strerror(errno));
+      exit(1);
+   }
+   if (flags.attachShm && !(shared = SharedScan_attach(flags.attachShm))) {
+      fprintf(stderr, "Hata: paylaşımlı belleğe bağlanılamıyor \"%s\": %s\n", flags.attachShm, strerror(errno));
+      exit(1);
+   }
+
+   if (flags.sendRestricted && !flags.agent) {
+      fprintf(stderr, "Hata: --send-restricted yalnızca --agent ile kullanılabilir.\n");
+      exit(1);
+   }
+   Agent* agent = NULL;
+   if (flags.agent && !(agent = Agent_new(flags.listenAddress, flags.sendRestricted))) {
+      fprintf(stderr, "Hata: ajan bağlantı bekleyemiyor \"%s\": %s\n", flags.listenAddress, strerror(errno));
+      exit(1);
+   }
+
+   Cluster* cluster = NULL;
+   if (flags.connectAddresses && !(cluster = Cluster_new(flags.connectAddresses))) {
+      fprintf(stderr, "Hata: geçersiz ajan listesi \"%s\".\n", flags.connectAddresses);
+      exit(1);
+   }
+
+   RenderBenchmark* render = NULL;
+   if (flags.renderBenchmark && !(render = RenderBenchmark_new(flags.renderBenchmark, flags.renderSize, flags.iterations))) {
+      fprintf(stderr, "Hata: geçersiz çizim kıyaslaması \"%s\" veya boyutu \"%s\".\n", flags.renderBenchmark, flags.renderSize ? flags.renderSize : "");
+      exit(1);
+   }
+
+   if (flags.profileReport || render)
+      Profile_enable();
+
    Platform_init();
 
    Process_setupColumnWidths();
 
    UsersTable* ut = UsersTable_new();
    ProcessList* pl = ProcessList_new(ut, flags.pidMatchList, flags.userId);
+   if (replay)
+      Replay_advance(replay, pl, true);
+   else if (flags.attachShm)
+      SharedScan_advance(shared, pl, false);
+   else if (cluster)
+      Cluster_advance(cluster, pl, false);
 
    Settings* settings = Settings_new(pl->cpuCount);
    pl->settings = settings;
@@ -307,6 +593,47 @@ int CommandLine_run(const char* name, int argc, char** argv) {
       }
       Settings_setSortKey(settings, flags.sortKey);
    }
+   bool addedHostColumn = cluster && showHostColumn(settings);
+
+   if (flags.batch || exporter || flags.serveShm || agent || flags.benchmark) {
+      pl->incFilter = flags.commFilter;
+      int r;
+      if (flags.benchmark)
+         r = Benchmark_run(pl, settings, flags.benchmark);
+      else if (exporter)
+         r = Exporter_run(exporter, pl, settings);
+      else if (flags.serveShm)
+         r = SharedScan_run(shared, pl, header, settings);
+      else if (agent)
+         r = Agent_run(agent, pl, header, settings);
+      else
+         r = Batch_run(pl, header, settings, flags.batchFormat, flags.iterations);
+      Exporter_delete(exporter);
+      Agent_delete(agent);
+      SharedScan_delete(shared);
+      if (flags.profileReport)
+         Profile_report(stderr);
+
+      Platform_done();
+      Header_delete(header);
+      ProcessList_delete(pl);
+      UsersTable_delete(ut);
+      Settings_delete(settings);
+      free(flags.commFilter);
+      if (flags.pidMatchList)
+         Hashtable_delete(flags.pidMatchList);
+      return r;
+   }
+
+   if (render) {
+      // only the keys of the scenario may ask for a rescan
+      if (flags.delay == -1)
+         settings->delay = 255;
+      if (!RenderBenchmark_attach(render)) {
+         fprintf(stderr, "Hata: sanal terminal oluşturulamıyor: %s\n", strerror(errno));
+         exit(1);
+      }
+   }
 
    CRT_init(settings, flags.allowUnicode);
 
@@ -321,6 +648,11 @@ int CommandLine_run(const char* name, int argc, char** argv) {
       .pl = pl,
       .mainPanel = panel,
       .header = header,
+      .recorder = recorder,
+      .replay = replay,
+      .shared = shared,
+      .cluster = cluster,
+      .history = replay || shared || cluster ? NULL : History_new(),
       .pauseProcessUpdate = false,
       .hideProcessSelection = false,
    };
@@ -339,8 +671,14 @@ int CommandLine_run(const char* name, int argc, char** argv) {
    if (settings->allBranchesCollapsed)
       ProcessList_collapseAllBranches(pl);
 
+   if (render)
+      RenderBenchmark_start(render);
+
    ScreenManager_run(scr, NULL, NULL);
 
+   if (render)
+      RenderBenchmark_stop(render);
+
    attron(CRT_colors[RESET_COLOR]);
    mvhline(LINES-1, 0, ' ', COLS);
    attroff(CRT_colors[RESET_COLOR]);
@@ -350,7 +688,19 @@ int CommandLine_run(const char* name, int argc, char** argv) {
 
    CRT_done();
 
-   if (settings->changed) {
+   if (render)
+      RenderBenchmark_report(render);
+
+   if (flags.profileReport)
+      Profile_report(stderr);
+
+   if (recorder && recorder->error)
+      fprintf(stderr, "Hata: kayıt durduruldu \"%s\": %s\n", flags.recordPath, strerror(recorder->error));
+
+   // the scenario changes settings the user did not ask for
+   if (settings->changed && !render) {
+      if (addedHostColumn)
+         hideHostColumn(settings);
       int r = Settings_write(settings);
       if (r < 0)
          fprintf(stderr, "Yapılandırma değere kaydedilemez %s: %s\n", settings->filename, strerror(-r));
@@ -358,6 +708,12 @@ int CommandLine_run(const char* name, int argc, char** argv) {
 
    Header_delete(header);
    ProcessList_delete(pl);
+   Recorder_delete(recorder);
+   Replay_delete(replay);
+   SharedScan_delete(shared);
+   Cluster_delete(cluster);
+   History_delete(state.history);
+   RenderBenchmark_delete(render);
 
    ScreenManager_delete(scr);
    MetersPanel_cleanup();
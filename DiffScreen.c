@@ -0,0 +1,279 @@
+/*
+htop - DiffScreen.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "DiffScreen.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/types.h>
+
+#include "CRT.h"
+#include "FunctionBar.h"
+#include "Macros.h"
+#include "Panel.h"
+#include "ProvideCurses.h"
+#include "Snapshot.h"
+#include "Vector.h"
+#include "XUtils.h"
+
+
+static const char* const DiffScreenFunctions[] = {"Ara ", "Filtrele ", "Yenile", "Sırala: CPU ", "Aralık- ", "Aralık+ ", "Tamam   ", NULL};
+
+static const char* const DiffScreenKeys[] = {"F3", "F4", "F5", "F6", "F7", "F8", "Esc"};
+
+static const int DiffScreenEvents[] = {KEY_F(3), KEY_F(4), KEY_F(5), KEY_F(6), KEY_F(7), KEY_F(8), 27};
+
+static const char* const DiffScreen_sortLabels[LAST_DIFF_SORT] = {"Sırala: CPU ", "Sırala: RSS ", "Sırala: IO  "};
+
+static const unsigned int DiffScreen_intervals[] = {10, 30, 60, 300, 900, 3600};
+
+#define DIFF_DEFAULT_INTERVAL 2
+
+typedef struct DiffRow_ {
+   pid_t pid;
+   char status;               /* '+' started, '-' exited, ' ' seen in both */
+   long long cpu;             /* hundredths of a second */
+   long long rss;             /* kB */
+   long long io;              /* kB, -1 if unknown */
+   const char* command;
+} DiffRow;
+
+DiffScreen* DiffScreen_new(const History* history) {
+   DiffScreen* this = xCalloc(1, sizeof(DiffScreen));
+   Object_setClass(this, Class(DiffScreen));
+   this->history = history;
+   this->interval = DIFF_DEFAULT_INTERVAL;
+   this->sortKey = DIFF_SORT_CPU;
+   FunctionBar* fuBar = FunctionBar_new(DiffScreenFunctions, DiffScreenKeys, DiffScreenEvents);
+   return (DiffScreen*) InfoScreen_init(&this->super, NULL, fuBar, LINES - 2, "    PID D   CPU-TIME        RSS         IO  Command");
+}
+
+void DiffScreen_delete(Object* this) {
+   free(InfoScreen_done((InfoScreen*)this));
+}
+
+static void DiffScreen_draw(InfoScreen* super) {
+   const DiffScreen* this = (const DiffScreen*) super;
+   InfoScreen_drawTitled(super, "Son %u saniyedeki süreç farkları", DiffScreen_intervals[this->interval]);
+}
+
+static long long DiffScreen_sortValue(const DiffRow* row, DiffSortKey key) {
+   switch (key) {
+   case DIFF_SORT_RSS:
+      return row->rss;
+   case DIFF_SORT_IO:
+      return row->io;
+   default:
+      return row->cpu;
+   }
+}
+
+static DiffSortKey DiffScreen_compareKey;
+
+static int DiffScreen_compareRows(const void* v1, const void* v2) {
+   const DiffRow* r1 = (const DiffRow*) v1;
+   const DiffRow* r2 = (const DiffRow*) v2;
+   int r = SPACESHIP_NUMBER(DiffScreen_sortValue(r2, DiffScreen_compareKey), DiffScreen_sortValue(r1, DiffScreen_compareKey));
+   return r ? r : SPACESHIP_NUMBER(r1->pid, r2->pid);
+}
+
+static void DiffScreen_formatKB(char* buffer, size_t size, long long kb, bool known) {
+   if (!known) {
+      xSnprintf(buffer, size, "%10s", "-");
+      return;
+   }
+
+   char sign = kb < 0 ? '-' : kb > 0 ? '+' : ' ';
+   unsigned long long value = kb < 0 ? -(unsigned long long)kb : (unsigned long long)kb;
+   if (value < 100000)
+      xSnprintf(buffer, size, "%9llu%c", value, 'K');
+   else if (value < 100000 * ONE_K)
+      xSnprintf(buffer, size, "%9.1f%c", (double)value / ONE_K, 'M');
+   else
+      xSnprintf(buffer, size, "%9.1f%c", (double)value / (ONE_K * ONE_K), 'G');
+
+   // put the sign right in front of the number
+   size_t i = 0;
+   while (buffer[i + 1] == ' ')
+      i++;
+   buffer[i] = sign;
+}
+
+static void DiffScreen_addRow(InfoScreen* super, const DiffRow* row) {
+   char cpu[32];
+   if (row->status == '-')
+      xSnprintf(cpu, sizeof(cpu), "%10s", "-");
+   else
+      xSnprintf(cpu, sizeof(cpu), "%4lld:%02lld.%02lld", row->cpu / 6000, (row->cpu / 100) % 60, row->cpu % 100);
+
+   char rss[16];
+   DiffScreen_formatKB(rss, sizeof(rss), row->rss, true);
+   char io[16];
+   DiffScreen_formatKB(io, sizeof(io), row->io, row->io >= 0);
+
+   char* line;
+   xAsprintf(&line, "%7d %c %s %s %s  %s", (int)row->pid, row->status, cpu, rss, io, row->command ? row->command : "");
+   InfoScreen_addLine(super, line);
+   free(line);
+}
+
+static long long DiffScreen_io(const Snapshot* snapshot, unsigned int row, int readField, int writeField) {
+   if (readField < 0 || writeField < 0)
+      return -1;
+
+   int64_t rd = Snapshot_value(snapshot, row, readField);
+   int64_t wr = Snapshot_value(snapshot, row, writeField);
+   // counters that could not be read are stored as all bits set
+   if (rd < 0 || wr < 0)
+      return -1;
+   return rd + wr;
+}
+
+static void DiffScreen_scan(InfoScreen* super) {
+   DiffScreen* this = (DiffScreen*) super;
+   Panel* panel = super->display;
+   int idx = Panel_getSelectedIndex(panel);
+   Panel_prune(panel);
+
+   Snapshot* now = this->history ? History_snapshotBefore(this->history, 0) : NULL;
+   Snapshot* then = now ? History_snapshotBefore(this->history, DiffScreen_intervals[this->interval] * 1000ULL) : NULL;
+   if (!now || !then) {
+      InfoScreen_addLine(super, this->history ? "Henüz karşılaştırılacak güncelleme yok." : "Güncelleme geçmişi kapalı.");
+      Snapshot_delete(now);
+      return;
+   }
+
+   const int timeField = Snapshot_fieldIndex("time");
+   const int rssField = Snapshot_fieldIndex("m_resident");
+   const int tgidField = Snapshot_fieldIndex("tgid");
+   const int commField = Snapshot_fieldIndex("comm");
+   const int readField = Snapshot_fieldIndex("io_read_bytes");
+   const int writeField = Snapshot_fieldIndex("io_write_bytes");
+   const int startField = Snapshot_fieldIndex("starttime_ctime");
+
+   // both snapshots are sorted by pid, walk them side by side
+   DiffRow* rows = xMallocArray(now->nRows + then->nRows + 1, sizeof(DiffRow));
+   unsigned int nRows = 0;
+   unsigned int started = 0;
+   unsigned int exited = 0;
+   unsigned int i = 0;
+   unsigned int j = 0;
+   while (i < now->nRows || j < then->nRows) {
+      const Snapshot* snapshot;
+      unsigned int row;
+      DiffRow* diff = &rows[nRows];
+      if (j >= then->nRows || (i < now->nRows && now->pids[i] < then->pids[j])) {
+         snapshot = now;
+         row = i++;
+         diff->status = '+';
+         diff->cpu = Snapshot_value(now, row, timeField);
+         diff->rss = Snapshot_value(now, row, rssField);
+         diff->io = DiffScreen_io(now, row, readField, writeField);
+      } else if (i >= now->nRows || then->pids[j] < now->pids[i]
+                 || Snapshot_value(then, j, startField) != Snapshot_value(now, i, startField)) {
+         // a pid taken over by a new process is its old one exiting, the new
+         // one is paired with nothing on the next pass
+         snapshot = then;
+         row = j++;
+         diff->status = '-';
+         diff->cpu = 0;
+         diff->rss = -Snapshot_value(then, row, rssField);
+         diff->io = -1;
+      } else {
+         snapshot = now;
+         row = i++;
+         unsigned int old = j++;
+         diff->status = ' ';
+         diff->cpu = Snapshot_value(now, row, timeField) - Snapshot_value(then, old, timeField);
+         diff->rss = Snapshot_value(now, row, rssField) - Snapshot_value(then, old, rssField);
+         long long ioNow = DiffScreen_io(now, row, readField, writeField);
+         long long ioThen = DiffScreen_io(then, old, readField, writeField);
+         diff->io = ioNow >= 0 && ioThen >= 0 ? ioNow - ioThen : -1;
+      }
+
+      // threads are accounted for in their process
+      pid_t tgid = Snapshot_value(snapshot, row, tgidField);
+      if (tgid && tgid != snapshot->pids[row])
+         continue;
+      if (diff->status == ' ' && diff->cpu == 0 && diff->rss == 0 && diff->io <= 0)
+         continue;
+
+      diff->pid = snapshot->pids[row];
+      diff->command = Snapshot_string(snapshot, row, commField);
+      started += diff->status == '+';
+      exited += diff->status == '-';
+      nRows++;
+   }
+
+   DiffScreen_compareKey = this->sortKey;
+   qsort(rows, nRows, sizeof(DiffRow), DiffScreen_compareRows);
+
+   char summary[128];
+   time_t from = then->realtimeMs / 1000;
+   time_t to = now->realtimeMs / 1000;
+   struct tm tmFrom, tmTo;
+   char fromText[16] = "?";
+   char toText[16] = "?";
+   if (localtime_r(&from, &tmFrom))
+      strftime(fromText, sizeof(fromText), "%H:%M:%S", &tmFrom);
+   if (localtime_r(&to, &tmTo))
+      strftime(toText, sizeof(toText), "%H:%M:%S", &tmTo);
+   xSnprintf(summary, sizeof(summary), "%s - %s: %u yeni, %u biten, %u değişen süreç", fromText, toText, started, exited, nRows - started - exited);
+   InfoScreen_addLine(super, summary);
+
+   for (unsigned int r = 0; r < nRows; r++)
+      DiffScreen_addRow(super, &rows[r]);
+
+   free(rows);
+   Snapshot_delete(then);
+   Snapshot_delete(now);
+   Panel_setSelected(panel, idx);
+}
+
+static bool DiffScreen_onKey(InfoScreen* super, int ch) {
+   DiffScreen* this = (DiffScreen*) super;
+   switch (ch) {
+      case 's':
+      case KEY_F(6):
+         this->sortKey = (this->sortKey + 1) % LAST_DIFF_SORT;
+         FunctionBar_setLabel(super->display->defaultBar, KEY_F(6), DiffScreen_sortLabels[this->sortKey]);
+         break;
+      case '-':
+      case KEY_F(7):
+         if (this->interval == 0)
+            return true;
+         this->interval--;
+         break;
+      case '+':
+      case KEY_F(8):
+         if (this->interval + 1 >= ARRAYSIZE(DiffScreen_intervals))
+            return true;
+         this->interval++;
+         break;
+      default:
+         return false;
+   }
+
+   Vector_prune(super->lines);
+   DiffScreen_scan(super);
+   InfoScreen_draw(super);
+   return true;
+}
+
+const InfoScreenClass DiffScreen_class = {
+   .super = {
+      .extends = Class(Object),
+      .delete = DiffScreen_delete
+   },
+   .scan = DiffScreen_scan,
+   .draw = DiffScreen_draw,
+   .onKey = DiffScreen_onKey,
+};
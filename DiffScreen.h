@@ -0,0 +1,35 @@
+#ifndef HEADER_DiffScreen
+#define HEADER_DiffScreen
+/*
+htop - DiffScreen.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "History.h"
+#include "InfoScreen.h"
+#include "Object.h"
+
+
+typedef enum DiffSortKey_ {
+   DIFF_SORT_CPU,
+   DIFF_SORT_RSS,
+   DIFF_SORT_IO,
+   LAST_DIFF_SORT
+} DiffSortKey;
+
+typedef struct DiffScreen_ {
+   InfoScreen super;
+   const History* history;
+   unsigned int interval;     /* index into the offered intervals */
+   DiffSortKey sortKey;
+} DiffScreen;
+
+extern const InfoScreenClass DiffScreen_class;
+
+DiffScreen* DiffScreen_new(const History* history);
+
+void DiffScreen_delete(Object* this);
+
+#endif
@@ -135,6 +135,9 @@ DisplayOptionsPanel* DisplayOptionsPanel_new(Settings* settings, ScreenManager*
    Panel_add(super, (Object*) CheckItem_newByRef("Yeni ve eski süreçleri vurgulayın", &(settings->highlightChanges)));
    Panel_add(super, (Object*) NumberItem_newByRef("- Vurgu süresi (saniye cinsinden)", &(settings->highlightDelaySecs), 0, 1, 24*60*60));
    Panel_add(super, (Object*) NumberItem_newByRef("Ana işlev çubuğunu gizle (0 - kapalı, 1 - sonraki girişe kadar ESC'de, 2 - kalıcı olarak)", &(settings->hideFunctionBar), 0, 0, 2));
+   Panel_add(super, (Object*) NumberItem_newByRef("Grafik geçmişi (saat cinsinden, 0 - yalnızca ekran genişliği)", &(settings->graphHistoryHours), 0, 0, 48));
+   Panel_add(super, (Object*) CheckItem_newByRef("- Grafik geçmişini yeniden başlatmalar arasında sakla", &(settings->graphHistoryPersist)));
+   Panel_add(super, (Object*) NumberItem_newByRef("Geriye dönük süreç geçmişi için bellek (MB, 0 - kapalı)", &(settings->historyMemoryMB), 0, 0, 1024));
    #ifdef HAVE_LIBHWLOC
    Panel_add(super, (Object*) CheckItem_newByRef("Varsayılan olarak yakınlığı seçerken topolojiyi göster", &(settings->topologyAffinity)));
    #endif
@@ -0,0 +1,430 @@
+/*
+htop - Exporter.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "Exporter.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "CRT.h"
+#include "DiskIOMeter.h"
+#include "NetworkIOMeter.h"
+#include "Platform.h"
+#include "Process.h"
+#include "Socket.h"
+#include "Vector.h"
+#include "XUtils.h"
+
+
+#define EXPORTER_CONTENT_TYPE "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+static volatile sig_atomic_t Exporter_stopped;
+
+static void Exporter_stop(ATTR_UNUSED int sgn) {
+   Exporter_stopped = 1;
+}
+
+Exporter* Exporter_new(const char* address) {
+   int fd = Socket_listen(address);
+   if (fd < 0)
+      return NULL;
+
+   Exporter* this = xCalloc(1, sizeof(Exporter));
+   this->fd = fd;
+   this->address = xStrdup(address);
+   for (int i = 0; i < EXPORTER_MAX_CLIENTS; i++)
+      this->clients[i].fd = -1;
+   return this;
+}
+
+static void ExporterClient_close(ExporterClient* client) {
+   close(client->fd);
+   client->fd = -1;
+}
+
+void Exporter_delete(Exporter* this) {
+   if (!this)
+      return;
+
+   for (int i = 0; i < EXPORTER_MAX_CLIENTS; i++)
+      if (this->clients[i].fd >= 0)
+         ExporterClient_close(&this->clients[i]);
+   Socket_close(this->fd, this->address);
+   free(this->address);
+   free(this->page);
+   free(this);
+}
+
+/* ---------------------------------------- */
+
+void Exporter_printf(Exporter* this, const char* fmt, ...) {
+   for (;;) {
+      size_t room = this->pageCapacity - this->pageLen;
+      va_list ap;
+      va_start(ap, fmt);
+      int n = room ? vsnprintf(this->page + this->pageLen, room, fmt, ap) : 0;
+      va_end(ap);
+      if (n < 0)
+         return;
+      if (room && (size_t)n < room) {
+         this->pageLen += n;
+         return;
+      }
+
+      this->pageCapacity = MAXIMUM(this->pageCapacity * 2, this->pageLen + (size_t)n + 4096);
+      this->page = xRealloc(this->page, this->pageCapacity);
+   }
+}
+
+void Exporter_family(Exporter* this, const char* name, const char* type, const char* help) {
+   Exporter_printf(this, "# TYPE %s %s\n# HELP %s %s\n", name, type, name, help);
+}
+
+void Exporter_sample(Exporter* this, const char* name, const char* labels, double value) {
+   Exporter_printf(this, "%s", name);
+   if (labels)
+      Exporter_printf(this, "{%s}", labels);
+
+   if (isnan(value))
+      Exporter_printf(this, " NaN\n");
+   else
+      Exporter_printf(this, " %.15g\n", value);  // exact for counters below 10^15
+}
+
+void Exporter_escapeLabel(char* out, size_t size, const char* value) {
+   size_t len = 0;
+   for (; value && *value && len + 3 < size; value++) {
+      if (*value == '\\' || *value == '"') {
+         out[len++] = '\\';
+         out[len++] = *value;
+      } else if (*value == '\n') {
+         out[len++] = '\\';
+         out[len++] = 'n';
+      } else {
+         out[len++] = *value;
+      }
+   }
+   out[len] = '\0';
+}
+
+/* Name of the executable, without its path and arguments */
+static void Exporter_programName(const Process* p, char* out, size_t size) {
+   const char* comm = p->comm ? p->comm : "";
+   int end = p->basenameOffset > 0 ? p->basenameOffset : (int)strlen(comm);
+   int start = 0;
+   for (int i = 0; i < end && comm[i]; i++)
+      if (comm[i] == '/')
+         start = i + 1;
+
+   char name[128];
+   String_safeStrncpy(name, comm + start, MINIMUM(sizeof(name), (size_t)(end - start) + 1));
+   Exporter_escapeLabel(out, size, name);
+}
+
+static double Exporter_topValue(const Process* p, bool byMemory) {
+   if (byMemory)
+      return (double)p->m_resident;
+   return isnan(p->percent_cpu) ? 0.0 : p->percent_cpu;
+}
+
+static void Exporter_writeTop(Exporter* this, const ProcessList* pl, bool byMemory) {
+   const Process* top[EXPORTER_TOP_PROCESSES];
+   int n = 0;
+
+   for (int i = 0; i < Vector_size(pl->processes); i++) {
+      const Process* p = (const Process*) Vector_get(pl->processes, i);
+      // threads share the memory of their process
+      if (p->pid != p->tgid)
+         continue;
+
+      double value = Exporter_topValue(p, byMemory);
+      if (n == EXPORTER_TOP_PROCESSES && value <= Exporter_topValue(top[n - 1], byMemory))
+         continue;
+
+      int j = n < EXPORTER_TOP_PROCESSES ? n++ : n - 1;
+      while (j > 0 && Exporter_topValue(top[j - 1], byMemory) < value) {
+         top[j] = top[j - 1];
+         j--;
+      }
+      top[j] = p;
+   }
+
+   const char* name = byMemory ? "htop_top_process_resident_bytes" : "htop_top_process_cpu_percent";
+   Exporter_family(this, name, "gauge", byMemory ? "Resident memory of the processes using the most memory" : "CPU usage of the busiest processes");
+   for (int i = 0; i < n; i++) {
+      const Process* p = top[i];
+      char program[256];
+      Exporter_programName(p, program, sizeof(program));
+      char user[64];
+      if (p->user)
+         Exporter_escapeLabel(user, sizeof(user), p->user);
+      else
+         xSnprintf(user, sizeof(user), "%u", (unsigned int)p->st_uid);
+
+      char labels[512];
+      xSnprintf(labels, sizeof(labels), "rank=\"%d\",pid=\"%d\",user=\"%s\",command=\"%s\"", i + 1, (int)p->pid, user, program);
+      Exporter_sample(this, name, labels, byMemory ? Exporter_topValue(p, true) * ONE_K : Exporter_topValue(p, false));
+   }
+}
+
+static void Exporter_render(Exporter* this, const ProcessList* pl) {
+   this->pageLen = 0;
+
+   Exporter_family(this, "htop_uptime_seconds", "gauge", "Time since the system was booted");
+   Exporter_sample(this, "htop_uptime_seconds", NULL, Platform_getUptime());
+
+   double load[3];
+   Platform_getLoadAverage(&load[0], &load[1], &load[2]);
+   Exporter_family(this, "htop_load_average", "gauge", "System load average");
+   Exporter_sample(this, "htop_load_average", "period=\"1m\"", load[0]);
+   Exporter_sample(this, "htop_load_average", "period=\"5m\"", load[1]);
+   Exporter_sample(this, "htop_load_average", "period=\"15m\"", load[2]);
+
+   Exporter_family(this, "htop_tasks", "gauge", "Number of tasks");
+   Exporter_sample(this, "htop_tasks", "kind=\"total\"", pl->totalTasks);
+   Exporter_sample(this, "htop_tasks", "kind=\"running\"", pl->runningTasks);
+   Exporter_sample(this, "htop_tasks", "kind=\"userland_threads\"", pl->userlandThreads);
+   Exporter_sample(this, "htop_tasks", "kind=\"kernel_threads\"", pl->kernelThreads);
+
+   Exporter_family(this, "htop_memory_bytes", "gauge", "Physical memory");
+   Exporter_sample(this, "htop_memory_bytes", "kind=\"total\"", (double)pl->totalMem * ONE_K);
+   Exporter_sample(this, "htop_memory_bytes", "kind=\"used\"", (double)pl->usedMem * ONE_K);
+   Exporter_sample(this, "htop_memory_bytes", "kind=\"buffers\"", (double)pl->buffersMem * ONE_K);
+   Exporter_sample(this, "htop_memory_bytes", "kind=\"cached\"", (double)pl->cachedMem * ONE_K);
+   Exporter_sample(this, "htop_memory_bytes", "kind=\"shared\"", (double)pl->sharedMem * ONE_K);
+   Exporter_sample(this, "htop_memory_bytes", "kind=\"available\"", (double)pl->availableMem * ONE_K);
+
+   Exporter_family(this, "htop_swap_bytes", "gauge", "Swap space");
+   Exporter_sample(this, "htop_swap_bytes", "kind=\"total\"", (double)pl->totalSwap * ONE_K);
+   Exporter_sample(this, "htop_swap_bytes", "kind=\"used\"", (double)pl->usedSwap * ONE_K);
+   Exporter_sample(this, "htop_swap_bytes", "kind=\"cached\"", (double)pl->cachedSwap * ONE_K);
+
+   DiskIOData disk;
+   if (Platform_getDiskIO(&disk)) {
+      Exporter_family(this, "htop_disk_read_bytes", "counter", "Bytes read from disks");
+      Exporter_sample(this, "htop_disk_read_bytes_total", NULL, disk.totalBytesRead);
+      Exporter_family(this, "htop_disk_written_bytes", "counter", "Bytes written to disks");
+      Exporter_sample(this, "htop_disk_written_bytes_total", NULL, disk.totalBytesWritten);
+      Exporter_family(this, "htop_disk_io_time_seconds", "counter", "Time spent doing disk I/O");
+      Exporter_sample(this, "htop_disk_io_time_seconds_total", NULL, disk.totalMsTimeSpend / 1000.0);
+   }
+
+   NetworkIOData net;
+   if (Platform_getNetworkIO(&net)) {
+      Exporter_family(this, "htop_network_received_bytes", "counter", "Bytes received on network interfaces");
+      Exporter_sample(this, "htop_network_received_bytes_total", NULL, net.bytesReceived);
+      Exporter_family(this, "htop_network_received_packets", "counter", "Packets received on network interfaces");
+      Exporter_sample(this, "htop_network_received_packets_total", NULL, net.packetsReceived);
+      Exporter_family(this, "htop_network_transmitted_bytes", "counter", "Bytes sent on network interfaces");
+      Exporter_sample(this, "htop_network_transmitted_bytes_total", NULL, net.bytesTransmitted);
+      Exporter_family(this, "htop_network_transmitted_packets", "counter", "Packets sent on network interfaces");
+      Exporter_sample(this, "htop_network_transmitted_packets_total", NULL, net.packetsTransmitted);
+   }
+
+   Platform_exportMetrics(pl, this);
+
+   Exporter_writeTop(this, pl, false);
+   Exporter_writeTop(this, pl, true);
+
+   Exporter_printf(this, "# EOF\n");
+}
+
+/* ---------------------------------------- */
+
+static void Exporter_respond(Exporter* this, ExporterClient* client, bool complete) {
+   const char* status = "200 OK";
+   const char* type = EXPORTER_CONTENT_TYPE;
+   client->body = this->page;
+   client->bodyLen = this->pageLen;
+
+   const char* request = client->request;
+   const char* path = request + 4;
+   if (!complete) {
+      status = "400 Bad Request";
+   } else if (!String_startsWith(request, "GET ")) {
+      status = "405 Method Not Allowed";
+   } else if (!(String_startsWith(path, "/ ") || String_startsWith(path, "/metrics ") || String_startsWith(path, "/metrics?"))) {
+      status = "404 Not Found";
+   }
+
+   if (status[0] != '2') {
+      client->body = status;
+      client->bodyLen = strlen(status);
+      type = "text/plain";
+   }
+
+   client->headLen = xSnprintf(client->head, sizeof(client->head),
+      "HTTP/1.0 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+      status, type, client->bodyLen);
+   client->sent = 0;
+   client->responding = true;
+}
+
+static void Exporter_write(ExporterClient* client) {
+   while (client->sent < client->headLen + client->bodyLen) {
+      const char* data;
+      size_t len;
+      if (client->sent < client->headLen) {
+         data = client->head + client->sent;
+         len = client->headLen - client->sent;
+      } else {
+         data = client->body + (client->sent - client->headLen);
+         len = client->bodyLen - (client->sent - client->headLen);
+      }
+
+      ssize_t n = write(client->fd, data, len);
+      if (n < 0) {
+         if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            return;
+         break;
+      }
+      client->sent += n;
+   }
+   ExporterClient_close(client);
+}
+
+static void Exporter_read(Exporter* this, ExporterClient* client) {
+   size_t room = sizeof(client->request) - 1 - client->received;
+   ssize_t n = read(client->fd, client->request + client->received, room);
+   if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+      return;
+   if (n <= 0) {
+      ExporterClient_close(client);
+      return;
+   }
+
+   client->received += n;
+   client->request[client->received] = '\0';
+   bool complete = strstr(client->request, "\r\n\r\n") || strstr(client->request, "\n\n");
+   if (complete || client->received == sizeof(client->request) - 1) {
+      Exporter_respond(this, client, complete);
+      Exporter_write(client);
+   }
+}
+
+static void Exporter_accept(Exporter* this) {
+   uint64_t now;
+   Platform_gettime_monotonic(&now);
+
+   int fd;
+   while ((fd = Socket_accept(this->fd)) >= 0) {
+      ExporterClient* client = NULL;
+      for (int i = 0; i < EXPORTER_MAX_CLIENTS && !client; i++)
+         if (this->clients[i].fd < 0)
+            client = &this->clients[i];
+
+      if (!client) {
+         close(fd);
+         continue;
+      }
+      client->fd = fd;
+      client->acceptedMs = now;
+      client->received = 0;
+      client->responding = false;
+   }
+}
+
+/* Handles scrapes until the deadline has passed */
+static void Exporter_serve(Exporter* this, uint64_t deadlineMs) {
+   struct pollfd fds[EXPORTER_MAX_CLIENTS + 1];
+   int slots[EXPORTER_MAX_CLIENTS + 1];
+
+   while (!Exporter_stopped) {
+      uint64_t now;
+      Platform_gettime_monotonic(&now);
+      if (now >= deadlineMs)
+         return;
+
+      // clients that keep a slot without asking for anything would lock out the scrapers
+      uint64_t wakeMs = deadlineMs;
+      nfds_t n = 0;
+      fds[n] = (struct pollfd) { .fd = this->fd, .events = POLLIN };
+      slots[n++] = -1;
+      for (int i = 0; i < EXPORTER_MAX_CLIENTS; i++) {
+         if (this->clients[i].fd < 0)
+            continue;
+         if (!this->clients[i].responding) {
+            uint64_t expiresMs = this->clients[i].acceptedMs + EXPORTER_REQUEST_TIMEOUT_MS;
+            if (now >= expiresMs) {
+               ExporterClient_close(&this->clients[i]);
+               continue;
+            }
+            wakeMs = MINIMUM(wakeMs, expiresMs);
+         }
+         fds[n] = (struct pollfd) { .fd = this->clients[i].fd, .events = this->clients[i].responding ? POLLOUT : POLLIN };
+         slots[n++] = i;
+      }
+
+      if (poll(fds, n, (int)MINIMUM(wakeMs - now, (uint64_t)INT_MAX)) <= 0)
+         continue;
+
+      for (nfds_t k = 0; k < n; k++) {
+         if (!fds[k].revents)
+            continue;
+
+         if (slots[k] < 0) {
+            Exporter_accept(this);
+            continue;
+         }
+
+         ExporterClient* client = &this->clients[slots[k]];
+         if (client->fd < 0)
+            continue;
+         if (client->responding)
+            Exporter_write(client);
+         else
+            Exporter_read(this, client);
+      }
+   }
+}
+
+int Exporter_run(Exporter* this, ProcessList* pl, const Settings* settings) {
+   CRT_initHeadless(settings);
+
+   struct sigaction act;
+   memset(&act, 0, sizeof(act));
+   act.sa_handler = Exporter_stop;
+   sigemptyset(&act.sa_mask);
+   sigaction(SIGINT, &act, NULL);
+   sigaction(SIGTERM, &act, NULL);
+   signal(SIGPIPE, SIG_IGN);
+
+   Platform_gettime_realtime(&pl->realtime, &pl->realtimeMs);
+   ProcessList_scan(pl, false);
+   Exporter_render(this, pl);
+
+   uint64_t next;
+   Platform_gettime_monotonic(&next);
+
+   while (!Exporter_stopped) {
+      next += 100 * (uint64_t)settings->delay;
+      Exporter_serve(this, next);
+      if (Exporter_stopped)
+         break;
+
+      Platform_gettime_realtime(&pl->realtime, &pl->realtimeMs);
+      ProcessList_scan(pl, false);
+
+      // the page is about to be rewritten, scrapes still sending it are too slow
+      for (int i = 0; i < EXPORTER_MAX_CLIENTS; i++)
+         if (this->clients[i].fd >= 0 && this->clients[i].responding)
+            ExporterClient_close(&this->clients[i]);
+
+      Exporter_render(this, pl);
+   }
+   return 0;
+}
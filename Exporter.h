@@ -0,0 +1,71 @@
+#ifndef HEADER_Exporter
+#define HEADER_Exporter
+/*
+htop - Exporter.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Macros.h"
+#include "ProcessList.h"
+#include "Settings.h"
+
+
+#define EXPORTER_MAX_CLIENTS 16
+#define EXPORTER_REQUEST_MAX 2048
+#define EXPORTER_TOP_PROCESSES 10
+#define EXPORTER_REQUEST_TIMEOUT_MS 5000
+
+typedef struct ExporterClient_ {
+   int fd;                    /* -1 if the slot is free */
+   uint64_t acceptedMs;       /* monotonic, the request has to arrive in time */
+   char request[EXPORTER_REQUEST_MAX];
+   size_t received;
+   bool responding;
+   char head[192];
+   size_t headLen;
+   const char* body;
+   size_t bodyLen;
+   size_t sent;               /* of head and body together */
+} ExporterClient;
+
+/*
+ * Serves the latest scan in OpenMetrics text format over HTTP.  The page
+ * is rendered once per update into a buffer that is reused, scrapes only
+ * copy it out and are handled between updates without ever blocking.
+ */
+typedef struct Exporter_ {
+   int fd;
+   char* address;
+   ExporterClient clients[EXPORTER_MAX_CLIENTS];
+   char* page;
+   size_t pageLen;
+   size_t pageCapacity;
+} Exporter;
+
+/* Starts listening on the address, returns NULL with errno set on failure */
+Exporter* Exporter_new(const char* address);
+
+void Exporter_delete(Exporter* this);
+
+/* Scans every update interval and serves the result until interrupted */
+int Exporter_run(Exporter* this, ProcessList* pl, const Settings* settings);
+
+ATTR_FORMAT(printf, 2, 3)
+void Exporter_printf(Exporter* this, const char* fmt, ...);
+
+/* Starts a metric family; counters get their samples named NAME_total */
+void Exporter_family(Exporter* this, const char* name, const char* type, const char* help);
+
+/* Adds a sample, labels is a preformatted list like cpu="0" or NULL */
+void Exporter_sample(Exporter* this, const char* name, const char* labels, double value);
+
+/* Quotes a label value for use in the labels of a sample */
+void Exporter_escapeLabel(char* out, size_t size, const char* value);
+
+#endif
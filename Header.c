@@ -8,6 +8,7 @@ in the source distribution for its full text.
 #include "Header.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -16,7 +17,9 @@ in the source distribution for its full text.
 #include "Macros.h"
 #include "Object.h"
 #include "Platform.h"
+#include "Profile.h"
 #include "ProvideCurses.h"
+#include "Snapshot.h"
 #include "XUtils.h"
 
 
@@ -48,6 +51,10 @@ void Header_populateFromSettings(Header* this) {
          if (colSettings->modes[i] != 0) {
             Header_setMode(this, i, colSettings->modes[i], col);
          }
+         if (i < colSettings->intervalsLen && colSettings->intervals[i] >= 0 && i < Vector_size(this->columns[col])) {
+            Meter* meter = (Meter*) Vector_get(this->columns[col], i);
+            meter->updateInterval = colSettings->intervals[i];
+         }
       }
    }
    Header_calculateHeight(this);
@@ -59,13 +66,16 @@ void Header_writeBackToSettings(const Header* this) {
 
       String_freeArray(colSettings->names);
       free(colSettings->modes);
+      free(colSettings->intervals);
 
       const Vector* vec = this->columns[col];
       int len = Vector_size(vec);
 
       colSettings->names = xCalloc(len + 1, sizeof(char*));
       colSettings->modes = xCalloc(len, sizeof(int));
+      colSettings->intervals = len ? xCalloc(len, sizeof(int)) : NULL;
       colSettings->len = len;
+      colSettings->intervalsLen = len;
 
       for (int i = 0; i < len; i++) {
          const Meter* meter = (Meter*) Vector_get(vec, i);
@@ -77,6 +87,7 @@ void Header_writeBackToSettings(const Header* this) {
          }
          colSettings->names[i] = name;
          colSettings->modes[i] = meter->mode;
+         colSettings->intervals[i] = meter->updateInterval;
       }
    }
 }
@@ -150,6 +161,10 @@ void Header_reinit(Header* this) {
 }
 
 void Header_draw(const Header* this) {
+   if (this->hidden)
+      return;
+
+   uint64_t start = Profile_start();
    const int height = this->height;
    const int pad = this->pad;
    attrset(CRT_colors[RESET_COLOR]);
@@ -175,15 +190,38 @@ void Header_draw(const Header* this) {
       }
       x += width + pad;
    }
+   Profile_stop(PROFILE_HEADER_DRAW, start);
 }
 
 void Header_updateData(Header* this) {
+   // the scan time stands still while process updates are paused, meters go on
+   uint64_t now;
+   Platform_gettime_monotonic(&now);
+   const Snapshot* snapshot = this->pl->snapshot;
+
+   // meters of a snapshot carry their recorded values instead of live ones
+   if (snapshot)
+      Snapshot_restoreMeters(snapshot, this);
+
    Header_forEachColumn(this, col) {
       Vector* meters = this->columns[col];
       int items = Vector_size(meters);
       for (int i = 0; i < items; i++) {
          Meter* meter = (Meter*) Vector_get(meters, i);
-         Meter_updateValues(meter);
+
+         // graph meters keep updating while hidden, so their history has no gaps
+         if (this->hidden && meter->mode != GRAPH_METERMODE)
+            continue;
+
+         // recorded values must not end up in the live graph history or its files
+         if (snapshot)
+            continue;
+
+         if (Meter_isDue(meter, now)) {
+            Meter_updateValues(meter);
+            meter->lastUpdateMs = now;
+         }
+         Meter_sampleGraph(meter);
       }
    }
 }
@@ -217,6 +255,12 @@ static int calcColumnWidthCount(const Header* this, const Meter* curMeter, const
 }
 
 int Header_calculateHeight(Header* this) {
+   if (this->hidden) {
+      this->height = 0;
+      this->pad = 0;
+      return 0;
+   }
+
    const int pad = this->settings->headerMargin ? 2 : 0;
    int maxHeight = pad;
 
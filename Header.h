@@ -7,6 +7,8 @@ Released under the GNU GPLv2, see the COPYING file
 in the source distribution for its full text.
 */
 
+#include <stdbool.h>
+
 #include "Meter.h"
 #include "ProcessList.h"
 #include "Settings.h"
@@ -19,6 +21,7 @@ typedef struct Header_ {
    int nrColumns;
    int pad;
    int height;
+   bool hidden;
 } Header;
 
 #define Header_forEachColumn(this_, i_) for (int (i_)=0; (i_) < (this_)->nrColumns; ++(i_))
@@ -0,0 +1,262 @@
+/*
+htop - History.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "History.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Macros.h"
+#include "XUtils.h"
+
+
+static inline HistoryFrame* History_at(const History* this, unsigned int i) {
+   return &this->frames[(this->first + i) % this->capacity];
+}
+
+History* History_new(void) {
+   History* this = xCalloc(1, sizeof(History));
+   this->viewPosition = -1;
+   this->position = -1;
+   return this;
+}
+
+/* Sets up the capture state once the history is given memory */
+static void History_init(History* this) {
+   this->current = Snapshot_new();
+   this->previous = Snapshot_new();
+   this->view = Snapshot_new();
+   this->scratch = Snapshot_new();
+   SnapshotBuffer_init(&this->buffer);
+
+   // frames never leave this process, so the stream layout is our own
+   SnapshotBuffer layout;
+   SnapshotBuffer_init(&layout);
+   Snapshot_writeLayout(&layout);
+   SnapshotCodec_init(&this->codec, layout.data, layout.size);
+   SnapshotBuffer_done(&layout);
+}
+
+static void History_dropOldest(History* this) {
+   HistoryFrame* frame = History_at(this, 0);
+   this->bytes -= frame->size + sizeof(HistoryFrame);
+   free(frame->data);
+   this->first = (this->first + 1) % this->capacity;
+   this->count--;
+}
+
+void History_delete(History* this) {
+   if (!this)
+      return;
+
+   while (this->count)
+      History_dropOldest(this);
+   free(this->frames);
+   Snapshot_delete(this->current);
+   Snapshot_delete(this->previous);
+   Snapshot_delete(this->view);
+   Snapshot_delete(this->scratch);
+   SnapshotBuffer_done(&this->buffer);
+   free(this);
+}
+
+/* Drops the oldest keyframe groups until the frames fit the budget */
+static void History_trim(History* this, size_t budget) {
+   while (this->bytes > budget) {
+      unsigned int next = 1;
+      while (next < this->count && !History_at(this, next)->keyframe)
+         next++;
+
+      if (next >= this->count) {
+         // the newest group alone is too large, start a new one with the next scan
+         this->sinceKeyframe = HISTORY_KEYFRAME_INTERVAL;
+         return;
+      }
+
+      while (next--)
+         History_dropOldest(this);
+   }
+}
+
+static void History_push(History* this, bool keyframe, uint64_t realtimeMs) {
+   if (this->count == this->capacity) {
+      unsigned int capacity = MAXIMUM(this->capacity * 2, 64U);
+      HistoryFrame* frames = xMallocArray(capacity, sizeof(HistoryFrame));
+      for (unsigned int i = 0; i < this->count; i++)
+         frames[i] = *History_at(this, i);
+      free(this->frames);
+      this->frames = frames;
+      this->capacity = capacity;
+      this->first = 0;
+   }
+
+   HistoryFrame* frame = History_at(this, this->count);
+   frame->data = xMalloc(this->buffer.size);
+   memcpy(frame->data, this->buffer.data, this->buffer.size);
+   frame->size = this->buffer.size;
+   frame->keyframe = keyframe;
+   frame->realtimeMs = realtimeMs;
+   this->bytes += frame->size + sizeof(HistoryFrame);
+   this->count++;
+}
+
+void History_append(History* this, const ProcessList* pl, const Header* header, size_t budget) {
+   if (History_isBrowsing(this))
+      return;
+
+   // positions shift once frames are added or dropped
+   this->viewPosition = -1;
+
+   if (budget == 0) {
+      while (this->count)
+         History_dropOldest(this);
+      return;
+   }
+
+   if (!this->current)
+      History_init(this);
+
+   bool keyframe = this->count == 0 || this->sinceKeyframe >= HISTORY_KEYFRAME_INTERVAL;
+   Snapshot_capture(this->current, this->previous, pl, header);
+
+   SnapshotBuffer_reset(&this->buffer);
+   Snapshot_encode(this->current, keyframe ? NULL : this->previous, &this->buffer);
+   History_push(this, keyframe, this->current->realtimeMs);
+   this->sinceKeyframe = keyframe ? 1 : this->sinceKeyframe + 1;
+
+   Snapshot* t = this->previous;
+   this->previous = this->current;
+   this->current = t;
+
+   History_trim(this, budget);
+}
+
+/* Decodes the given frame into *view, continuing from the frame at
+ * *viewPosition if it is in the same keyframe group */
+static bool History_decode(const History* this, int target, Snapshot** view, Snapshot** scratch, int* viewPosition) {
+   if (target == *viewPosition)
+      return true;
+
+   int from = target;
+   while (from > 0 && !History_at(this, from)->keyframe)
+      from--;
+   if (!History_at(this, from)->keyframe)
+      return false;
+   if (*viewPosition >= from && *viewPosition < target)
+      from = *viewPosition + 1;
+
+   for (int i = from; i <= target; i++) {
+      const HistoryFrame* frame = History_at(this, i);
+      if (!Snapshot_decode(*scratch, frame->keyframe ? NULL : *view, &this->codec, frame->data, frame->size)) {
+         *viewPosition = -1;
+         return false;
+      }
+      (*scratch)->realtimeMs = frame->realtimeMs;
+
+      Snapshot* t = *view;
+      *view = *scratch;
+      *scratch = t;
+      *viewPosition = i;
+   }
+   return true;
+}
+
+static bool History_load(History* this, int target) {
+   return History_decode(this, target, &this->view, &this->scratch, &this->viewPosition);
+}
+
+bool History_step(History* this, int frames) {
+   if (this->count == 0)
+      return false;
+
+   // live data is what the newest frame holds
+   int newest = (int)this->count - 1;
+   if (!History_isBrowsing(this)) {
+      if (frames >= 0)
+         return false;
+
+      this->position = MAXIMUM(newest + frames, 0);
+      return true;
+   }
+
+   int target = this->position + frames;
+   if (target > newest) {
+      this->position = -1;
+      this->resync = true;
+   } else {
+      this->position = MAXIMUM(target, 0);
+   }
+   return true;
+}
+
+const Snapshot* History_frame(History* this) {
+   int target = this->position;
+   if (target < 0) {
+      if (!this->resync)
+         return NULL;
+
+      // show the newest frame once more, so live updates go on from it
+      this->resync = false;
+      target = (int)this->count - 1;
+   }
+
+   if (target < 0 || !History_load(this, target)) {
+      this->position = -1;
+      return NULL;
+   }
+   return this->view;
+}
+
+Snapshot* History_snapshotBefore(const History* this, uint64_t ageMs) {
+   if (this->count == 0)
+      return NULL;
+
+   int current = History_isBrowsing(this) ? this->position : (int)this->count - 1;
+   uint64_t currentMs = History_at(this, current)->realtimeMs;
+   uint64_t wantedMs = currentMs > ageMs ? currentMs - ageMs : 0;
+
+   // last frame at or before the wanted time, or the oldest one
+   int l = 0;
+   int r = current + 1;
+   while (r - l > 1) {
+      int c = l + (r - l) / 2;
+      if (History_at(this, c)->realtimeMs <= wantedMs)
+         l = c;
+      else
+         r = c;
+   }
+
+   Snapshot* snapshot = Snapshot_new();
+   Snapshot* scratch = Snapshot_new();
+   int position = -1;
+   bool ok = History_decode(this, l, &snapshot, &scratch, &position);
+   Snapshot_delete(scratch);
+   if (!ok) {
+      Snapshot_delete(snapshot);
+      return NULL;
+   }
+   return snapshot;
+}
+
+void History_status(const History* this, char* buffer, size_t size) {
+   if (!History_isBrowsing(this)) {
+      buffer[0] = '\0';
+      return;
+   }
+
+   time_t t = History_at(this, this->position)->realtimeMs / 1000;
+   struct tm tm;
+   char when[16];
+   if (!localtime_r(&t, &tm) || !strftime(when, sizeof(when), "%H:%M:%S", &tm))
+      String_safeStrncpy(when, "?", sizeof(when));
+
+   double perFrame = (double)this->bytes / this->count / ONE_K;
+   xSnprintf(buffer, size, "GEÇMİŞ %s [%d/%u] %.1f KB/kare", when, this->position + 1, this->count, perFrame);
+}
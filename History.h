@@ -0,0 +1,77 @@
+#ifndef HEADER_History
+#define HEADER_History
+/*
+htop - History.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Header.h"
+#include "ProcessList.h"
+#include "Snapshot.h"
+
+
+#define HISTORY_KEYFRAME_INTERVAL 32
+
+typedef struct HistoryFrame_ {
+   uint8_t* data;
+   uint32_t size;
+   bool keyframe;
+   uint64_t realtimeMs;
+} HistoryFrame;
+
+/*
+ * The most recent scans, kept encoded like the frames of a recording in
+ * a ring that is trimmed from the oldest keyframe on to stay within its
+ * memory budget.  While browsing, no scans are added and the chosen
+ * frame is shown instead of live data.
+ */
+typedef struct History_ {
+   HistoryFrame* frames;      /* ring of capacity entries starting at first */
+   unsigned int capacity;
+   unsigned int first;
+   unsigned int count;
+   size_t bytes;              /* encoded size of all frames */
+
+   Snapshot* current;         /* last two captured scans */
+   Snapshot* previous;
+   unsigned int sinceKeyframe;
+   SnapshotBuffer buffer;
+
+   SnapshotCodec codec;
+   Snapshot* view;            /* decoded frame at viewPosition */
+   Snapshot* scratch;
+   int viewPosition;          /* -1 if nothing decoded */
+   int position;              /* browsed frame, -1 when live */
+   bool resync;
+} History;
+
+History* History_new(void);
+
+void History_delete(History* this);
+
+/* Adds the current scan unless browsing; a budget of 0 drops all frames */
+void History_append(History* this, const ProcessList* pl, const Header* header, size_t budget);
+
+/* Moves the browsed frame, going past the newest one returns to live data */
+bool History_step(History* this, int frames);
+
+/* Frame to show instead of a live scan, NULL when live */
+const Snapshot* History_frame(History* this);
+
+static inline bool History_isBrowsing(const History* this) {
+   return this->position >= 0;
+}
+
+/* Decodes the frame taken ageMs before the shown one (or the oldest kept)
+ * into a new snapshot owned by the caller, NULL if there is none */
+Snapshot* History_snapshotBefore(const History* this, uint64_t ageMs);
+
+void History_status(const History* this, char* buffer, size_t size);
+
+#endif
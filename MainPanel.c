@@ -10,14 +10,19 @@ in the source distribution for its full text.
 
 #include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "CRT.h"
+#include "Cluster.h"
 #include "FunctionBar.h"
+#include "History.h"
 #include "Platform.h"
 #include "Process.h"
 #include "ProcessList.h"
 #include "ProvideCurses.h"
+#include "Replay.h"
 #include "Settings.h"
+#include "SharedScan.h"
 #include "XUtils.h"
 
 
@@ -44,8 +49,30 @@ void MainPanel_pidSearch(MainPanel* this, int ch) {
    }
 }
 
+static inline bool MainPanel_isPortSearch(const MainPanel* this) {
+   return this->inc->active == &this->inc->modes[INC_SEARCH] && this->inc->modes[INC_SEARCH].buffer[0] == ':';
+}
+
+/* Whether one of the space separated ports is the searched one, ":80" must not find ":8080" */
+static bool MainPanel_listensOn(const char* ports, const char* wanted) {
+   size_t len = strlen(wanted);
+   for (const char* port = ports; port; port = strchr(port, ' ')) {
+      while (*port == ' ')
+         port++;
+      if (strncmp(port, wanted, len) == 0 && (port[len] == ' ' || port[len] == '\0'))
+         return true;
+   }
+   return false;
+}
+
 static const char* MainPanel_getValue(Panel* this, int i) {
    const Process* p = (const Process*) Panel_get(this, i);
+   // a search for ":PORT" finds the process listening on that port
+   if (MainPanel_isPortSearch((MainPanel*)this)) {
+      const char* wanted = ((MainPanel*)this)->inc->modes[INC_SEARCH].buffer;
+      const char* ports = Process_getListenPorts(p);
+      return ports && MainPanel_listensOn(ports, wanted) ? wanted : "";
+   }
    return Process_getCommand(p);
 }
 
@@ -83,6 +110,13 @@ static HandlerResult MainPanel_eventHandler(Panel* super, int ch) {
       result = HANDLED;
    } else if (ch != ERR && this->inc->active) {
       bool filterChanged = IncSet_handleKey(this->inc, ch, super, MainPanel_getValue, NULL);
+      // ports are only collected while a port search is typed, or a column shows them
+      bool portSearch = MainPanel_isPortSearch(this);
+      if (portSearch != this->state->pl->wantListenPorts) {
+         this->state->pl->wantListenPorts = portSearch;
+         if (portSearch)
+            reaction |= HTOP_RECALCULATE;
+      }
       if (filterChanged) {
          this->state->pl->incFilter = IncSet_filter(this->inc);
          reaction = HTOP_REFRESH | HTOP_REDRAW_BAR;
@@ -145,6 +179,10 @@ bool MainPanel_foreachProcess(MainPanel* this, MainPanel_ForeachProcessFn fn, Ar
    Panel* super = (Panel*) this;
    bool ok = true;
    bool anyTagged = false;
+
+   if (!State_showsLiveProcesses(this->state))
+      return false;
+
    for (int i = 0; i < Panel_size(super); i++) {
       Process* p = (Process*) Panel_get(super, i);
       if (p->tag) {
@@ -176,6 +214,28 @@ static void MainPanel_drawFunctionBar(Panel* super, bool hideFunctionBar) {
    if (this->state->pauseProcessUpdate) {
       FunctionBar_append("PAUSED", CRT_colors[PAUSED]);
    }
+   if (this->state->recorder) {
+      char status[64];
+      if (Recorder_status(this->state->recorder, status, sizeof(status)))
+         FunctionBar_append(status, CRT_colors[FAILED_READ]);
+   }
+   if (this->state->replay) {
+      char status[64];
+      Replay_status(this->state->replay, status, sizeof(status));
+      FunctionBar_append(status, CRT_colors[PAUSED]);
+   } else if (this->state->history && History_isBrowsing(this->state->history)) {
+      char status[64];
+      History_status(this->state->history, status, sizeof(status));
+      FunctionBar_append(status, CRT_colors[PAUSED]);
+   } else if (this->state->cluster) {
+      char status[64];
+      Cluster_status(this->state->cluster, status, sizeof(status));
+      FunctionBar_append(status, CRT_colors[PAUSED]);
+   } else if (this->state->shared) {
+      char status[64];
+      if (SharedScan_staleStatus(this->state->shared, status, sizeof(status)))
+         FunctionBar_append(status, CRT_colors[PAUSED]);
+   }
 }
 
 static void MainPanel_printHeader(Panel* super) {
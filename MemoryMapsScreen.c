@@ -0,0 +1,285 @@
+/*
+htop - MemoryMapsScreen.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "MemoryMapsScreen.h"
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CRT.h"
+#include "Macros.h"
+#include "Panel.h"
+#include "Platform.h"
+#include "ProvideCurses.h"
+#include "Vector.h"
+#include "XUtils.h"
+
+
+/* How long one slice of reading may take before the screen is updated and keys are handled */
+#define MEMORYMAPS_SLICE_MS 50
+
+MemoryMapsScreen* MemoryMapsScreen_new(const Process* process) {
+   MemoryMapsScreen* this = xCalloc(1, sizeof(MemoryMapsScreen));
+   Object_setClass(this, Class(MemoryMapsScreen));
+   if (Process_isThread(process))
+      this->pid = process->tgid;
+   else
+      this->pid = process->pid;
+   this->byInode = Hashtable_new(64, false);
+   this->byName = Hashtable_new(16, false);
+   return (MemoryMapsScreen*) InfoScreen_init(&this->super, process, NULL, LINES - 2, "     SIZE kB       RSS kB       PSS kB      SWAP kB  ANONHUGE kB   MAPS  FILE");
+}
+
+static void MemoryMapsScreen_reset(MemoryMapsScreen* this) {
+   if (this->smaps) {
+      fclose(this->smaps);
+      this->smaps = NULL;
+      CRT_enableDelay();
+   }
+   for (size_t i = 0; i < this->nGroups; i++) {
+      free(this->groups[i]->name);
+      free(this->groups[i]);
+   }
+   this->nGroups = 0;
+   Hashtable_clear(this->byInode);
+   Hashtable_clear(this->byName);
+   this->current = NULL;
+   this->error = false;
+   memset(&this->total, 0, sizeof(this->total));
+}
+
+void MemoryMapsScreen_delete(Object* cast) {
+   MemoryMapsScreen* this = (MemoryMapsScreen*) cast;
+   MemoryMapsScreen_reset(this);
+   free(this->groups);
+   Hashtable_delete(this->byInode);
+   Hashtable_delete(this->byName);
+   free(InfoScreen_done((InfoScreen*)this));
+}
+
+static void MemoryMapsScreen_draw(InfoScreen* super) {
+   const MemoryMapsScreen* this = (const MemoryMapsScreen*) super;
+   InfoScreen_drawTitled(super, "Bellek haritası %d%s: RSS %"PRIu64" kB, PSS %"PRIu64" kB, takas %"PRIu64" kB, %u eşlem - %s",
+      this->pid, this->smaps ? " (okunuyor...)" : "",
+      this->total.rss, this->total.pss, this->total.swap, this->total.mappings,
+      Process_getCommand(super->process));
+}
+
+static unsigned int MemoryMapsScreen_hashName(const char* name) {
+   unsigned int hash = 5381;
+   for (const char* c = name; *c; c++)
+      hash = hash * 33 + (unsigned char)*c;
+   return hash;
+}
+
+static MemoryMaps_Group* MemoryMapsScreen_addGroup(MemoryMapsScreen* this, const char* name, uint64_t inode) {
+   if (this->nGroups == this->capacity) {
+      this->capacity = MAXIMUM(this->capacity * 2, 64);
+      this->groups = xReallocArray(this->groups, this->capacity, sizeof(MemoryMaps_Group*));
+   }
+   MemoryMaps_Group* group = xCalloc(1, sizeof(MemoryMaps_Group));
+   group->name = xStrdup(name);
+   group->inode = inode;
+   this->groups[this->nGroups++] = group;
+   return group;
+}
+
+/*
+ * The group of a mapping: files are keyed by inode like the library size
+ * of the process list, anonymous memory by its name, "[heap]" or "[stack]".
+ */
+static MemoryMaps_Group* MemoryMapsScreen_group(MemoryMapsScreen* this, const char* name, uint64_t inode) {
+   if (inode) {
+      MemoryMaps_Group* group = Hashtable_get(this->byInode, (ht_key_t)inode);
+      if (group && group->inode == inode)
+         return group;
+      if (!group) {
+         group = MemoryMapsScreen_addGroup(this, name, inode);
+         Hashtable_put(this->byInode, (ht_key_t)inode, group);
+         return group;
+      }
+   } else {
+      if (!name[0])
+         name = "[anon]";
+      unsigned int hash = MemoryMapsScreen_hashName(name);
+      MemoryMaps_Group* group = Hashtable_get(this->byName, hash);
+      if (group && group->inode == 0 && String_eq(group->name, name))
+         return group;
+      if (!group) {
+         group = MemoryMapsScreen_addGroup(this, name, 0);
+         Hashtable_put(this->byName, hash, group);
+         return group;
+      }
+   }
+
+   // the key is taken by another group, which is rare enough to look for a match one by one
+   for (size_t i = 0; i < this->nGroups; i++) {
+      MemoryMaps_Group* group = this->groups[i];
+      if (group->inode == inode && (inode || String_eq(group->name, name)))
+         return group;
+   }
+   return MemoryMapsScreen_addGroup(this, name, inode);
+}
+
+/* A mapping header: "7f0000000000-7f0000001000 r-xp 00000000 08:01 1234    /usr/lib/libc.so.6" */
+static bool MemoryMapsScreen_readHeader(MemoryMapsScreen* this, char* line) {
+   char* pos = line;
+   while (isxdigit((unsigned char)*pos))
+      pos++;
+   if (pos == line || *pos != '-')
+      return false;
+
+   // skip the range, permissions, offset and device
+   for (int field = 0; field < 4; field++) {
+      pos = strchr(pos, ' ');
+      if (!pos)
+         return false;
+      pos++;
+   }
+
+   char* name;
+   uint64_t inode = strtoull(pos, &name, 10);
+   while (*name == ' ')
+      name++;
+   char* end = strchr(name, '\n');
+   if (end)
+      *end = '\0';
+
+   this->current = MemoryMapsScreen_group(this, name, inode);
+   this->current->mappings++;
+   this->total.mappings++;
+   return true;
+}
+
+static const struct {
+   const char* key;
+   size_t offset;
+} MemoryMaps_fields[] = {
+   { "Size:", offsetof(MemoryMaps_Group, size) },
+   { "Rss:", offsetof(MemoryMaps_Group, rss) },
+   { "Pss:", offsetof(MemoryMaps_Group, pss) },
+   { "Swap:", offsetof(MemoryMaps_Group, swap) },
+   { "AnonHugePages:", offsetof(MemoryMaps_Group, anonHuge) },
+};
+
+static void MemoryMapsScreen_readField(MemoryMapsScreen* this, const char* line) {
+   if (!this->current)
+      return;
+
+   for (size_t i = 0; i < ARRAYSIZE(MemoryMaps_fields); i++) {
+      if (!String_startsWith(line, MemoryMaps_fields[i].key))
+         continue;
+
+      uint64_t kb = strtoull(line + strlen(MemoryMaps_fields[i].key), NULL, 10);
+      *(uint64_t*)((char*)this->current + MemoryMaps_fields[i].offset) += kb;
+      *(uint64_t*)((char*)&this->total + MemoryMaps_fields[i].offset) += kb;
+      return;
+   }
+}
+
+static int MemoryMaps_Group_compare(const void* v1, const void* v2) {
+   const MemoryMaps_Group* g1 = *(const MemoryMaps_Group* const*)v1;
+   const MemoryMaps_Group* g2 = *(const MemoryMaps_Group* const*)v2;
+   if (g1->rss != g2->rss)
+      return g1->rss < g2->rss ? 1 : -1;
+   if (g1->size != g2->size)
+      return g1->size < g2->size ? 1 : -1;
+   return strcmp(g1->name, g2->name);
+}
+
+/* Shows the groups found so far, the most resident first */
+static void MemoryMapsScreen_render(MemoryMapsScreen* this) {
+   InfoScreen* super = &this->super;
+   Panel* panel = super->display;
+   int idx = MAXIMUM(Panel_getSelectedIndex(panel), 0);
+   Panel_prune(panel);
+   Vector_prune(super->lines);
+
+   if (this->error) {
+      InfoScreen_addLine(super, "İşlemin bellek haritası okunamadı.");
+   } else if (this->nGroups == 0 && !this->smaps) {
+      InfoScreen_addLine(super, "İşlemin bellek eşlemi yok.");
+   }
+
+   qsort(this->groups, this->nGroups, sizeof(MemoryMaps_Group*), MemoryMaps_Group_compare);
+   for (size_t i = 0; i < this->nGroups; i++) {
+      const MemoryMaps_Group* group = this->groups[i];
+      char entry[PATH_MAX + 128];
+      xSnprintf(entry, sizeof(entry), "%12"PRIu64" %12"PRIu64" %12"PRIu64" %12"PRIu64" %12"PRIu64" %6u  %s",
+         group->size, group->rss, group->pss, group->swap, group->anonHuge, group->mappings, group->name);
+      InfoScreen_addLine(super, entry);
+   }
+
+   Panel_setSelected(panel, idx);
+   InfoScreen_draw(super);
+}
+
+/* Reads the listing for one slice, the rest is read on later calls */
+static void MemoryMapsScreen_readSlice(InfoScreen* super) {
+   MemoryMapsScreen* this = (MemoryMapsScreen*) super;
+   if (!this->smaps)
+      return;
+
+   uint64_t start;
+   Platform_gettime_monotonic(&start);
+
+   char buffer[PATH_MAX + 128];
+   for (unsigned int n = 1;; n++) {
+      if (!fgets(buffer, sizeof(buffer), this->smaps)) {
+         fclose(this->smaps);
+         this->smaps = NULL;
+         this->current = NULL;
+         CRT_enableDelay();
+         break;
+      }
+
+      // field names start with a capital letter, mapping headers with a hex address and a dash
+      if (!MemoryMapsScreen_readHeader(this, buffer))
+         MemoryMapsScreen_readField(this, buffer);
+
+      if (n % 1024 == 0) {
+         uint64_t now;
+         Platform_gettime_monotonic(&now);
+         if (now - start >= MEMORYMAPS_SLICE_MS)
+            break;
+      }
+   }
+
+   MemoryMapsScreen_render(this);
+}
+
+static void MemoryMapsScreen_scan(InfoScreen* super) {
+   MemoryMapsScreen* this = (MemoryMapsScreen*) super;
+   MemoryMapsScreen_reset(this);
+
+   this->smaps = Platform_openProcessSmaps(this->pid);
+   if (!this->smaps) {
+      this->error = true;
+      MemoryMapsScreen_render(this);
+      return;
+   }
+
+   // keys are polled while the listing is read, so they stay responsive
+   CRT_disableDelay();
+   MemoryMapsScreen_readSlice(super);
+}
+
+const InfoScreenClass MemoryMapsScreen_class = {
+   .super = {
+      .extends = Class(Object),
+      .delete = MemoryMapsScreen_delete
+   },
+   .scan = MemoryMapsScreen_scan,
+   .draw = MemoryMapsScreen_draw,
+   .onErr = MemoryMapsScreen_readSlice,
+};
@@ -0,0 +1,59 @@
+#ifndef HEADER_MemoryMapsScreen
+#define HEADER_MemoryMapsScreen
+/*
+htop - MemoryMapsScreen.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#include "Hashtable.h"
+#include "InfoScreen.h"
+#include "Object.h"
+#include "Process.h"
+
+
+/* The mappings of one backing file, or of one kind of anonymous memory, sizes in kB */
+typedef struct MemoryMaps_Group_ {
+   char* name;
+   uint64_t inode;            /* 0 for anonymous memory, grouped by name */
+   unsigned int mappings;
+   uint64_t size;
+   uint64_t rss;
+   uint64_t pss;
+   uint64_t swap;
+   uint64_t anonHuge;
+} MemoryMaps_Group;
+
+/*
+ * The smaps listing is read in slices between key presses, so that the
+ * groups found so far are shown while the listing of a large process is
+ * still being read.
+ */
+typedef struct MemoryMapsScreen_ {
+   InfoScreen super;
+   pid_t pid;
+   FILE* smaps;               /* NULL once the listing has been read */
+   bool error;
+   MemoryMaps_Group** groups;
+   size_t nGroups;
+   size_t capacity;
+   Hashtable* byInode;
+   Hashtable* byName;         /* anonymous groups by hash of their name */
+   MemoryMaps_Group* current; /* group of the mapping whose fields are being read */
+   MemoryMaps_Group total;
+} MemoryMapsScreen;
+
+extern const InfoScreenClass MemoryMapsScreen_class;
+
+MemoryMapsScreen* MemoryMapsScreen_new(const Process* process);
+
+void MemoryMapsScreen_delete(Object* this);
+
+#endif
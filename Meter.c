@@ -10,10 +10,16 @@ in the source distribution for its full text.
 #include "Meter.h"
 
 #include <assert.h>
+#include <fcntl.h>
 #include <math.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "CRT.h"
 #include "Macros.h"
@@ -38,6 +44,8 @@ Meter* Meter_new(const struct ProcessList_* pl, unsigned int param, const MeterC
    Object_setClass(this, type);
    this->h = 1;
    this->param = param;
+   this->drawDataFd = -1;
+   this->updateInterval = type->updateInterval;
    this->pl = pl;
    this->curItems = type->maxItems;
    this->curAttributes = NULL;
@@ -79,6 +87,126 @@ int Meter_humanUnit(char* buffer, unsigned long int value, size_t size) {
    return snprintf(buffer, size, "%.*f%c", precision, (double) value / powi, *prefix);
 }
 
+/* ---------- graph history store ---------- */
+
+#define GRAPHSTORE_MAGIC   0x48475248 /* "HRGH" */
+#define GRAPHSTORE_VERSION 1
+
+/* On-disk layout of a persisted graph history: a fixed header followed by
+ * the GraphData exactly as it lives in memory.  The file is mapped shared,
+ * so samples reach the page cache without any copying or serialization. */
+typedef struct GraphStore_ {
+   uint32_t magic;
+   uint32_t version;
+   uint32_t size;
+   uint32_t reserved;
+   GraphData data;
+} GraphStore;
+
+static bool GraphStore_isValid(const GraphStore* store) {
+   if (store->magic != GRAPHSTORE_MAGIC || store->version != GRAPHSTORE_VERSION || store->size != sizeof(GraphData))
+      return false;
+
+   const GraphData* data = &store->data;
+   if (data->nLevels > METER_GRAPHDATA_LEVELS)
+      return false;
+
+   for (unsigned int l = 0; l < METER_GRAPHDATA_LEVELS; l++) {
+      const GraphRing* ring = &data->levels[l];
+      if (ring->head >= METER_GRAPHDATA_SIZE || ring->count > METER_GRAPHDATA_SIZE ||
+         ring->pending >= METER_GRAPHDATA_FACTOR || ring->pendingValid > ring->pending)
+         return false;
+   }
+   return true;
+}
+
+static char* GraphStore_path(const Meter* this) {
+   const char* rcfile = this->pl->settings->filename;
+   const char* slash = strrchr(rcfile, '/');
+   char* dir = slash ? xStrndup(rcfile, (size_t)(slash - rcfile)) : xStrdup(".");
+   char* graphDir = String_cat(dir, "/graphs");
+   free(dir);
+   (void) mkdir(graphDir, 0700);
+
+   char* path;
+   xAsprintf(&path, "%s/%s-%u", graphDir, Meter_name(this), this->param);
+   free(graphDir);
+   return path;
+}
+
+/* Mark the time htop was not running as a gap, limited to what the
+ * coarsest level in use is able to show anyway. */
+static void GraphStore_fillGap(GraphData* data, const struct timeval* now, int delay) {
+   if (!timercmp(now, &data->time, >) || data->nLevels == 0)
+      return;
+
+   struct timeval elapsed;
+   timersub(now, &data->time, &elapsed);
+   double missed = (elapsed.tv_sec + elapsed.tv_usec / 1000000.0) * 10.0 / MAXIMUM(delay, 1);
+
+   double limit = METER_GRAPHDATA_SIZE;
+   for (uint32_t l = 1; l < data->nLevels; l++)
+      limit *= METER_GRAPHDATA_FACTOR;
+
+   for (long i = (long) MINIMUM(missed, limit); i > 0; i--)
+      GraphData_push(data, NAN);
+}
+
+static GraphData* GraphStore_map(Meter* this) {
+   char* path = GraphStore_path(this);
+   int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+   free(path);
+   if (fd < 0)
+      return NULL;
+
+   // another htop instance already owns this history
+   if (flock(fd, LOCK_EX | LOCK_NB) < 0)
+      goto fail;
+
+   struct stat st;
+   if (fstat(fd, &st) < 0)
+      goto fail;
+
+   bool fresh = (size_t)st.st_size != sizeof(GraphStore);
+   if (fresh && ftruncate(fd, sizeof(GraphStore)) < 0)
+      goto fail;
+
+   void* map = mmap(NULL, sizeof(GraphStore), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   if (map == MAP_FAILED)
+      goto fail;
+
+   GraphStore* store = map;
+   if (fresh || !GraphStore_isValid(store)) {
+      memset(store, 0, sizeof(GraphStore));
+      store->magic = GRAPHSTORE_MAGIC;
+      store->version = GRAPHSTORE_VERSION;
+      store->size = sizeof(GraphData);
+   } else {
+      GraphStore_fillGap(&store->data, &this->pl->realtime, this->pl->settings->delay);
+   }
+
+   this->drawDataFd = fd;
+   return &store->data;
+
+fail:
+   close(fd);
+   return NULL;
+}
+
+static void Meter_freeDrawData(Meter* this) {
+   if (!this->drawData)
+      return;
+
+   if (this->drawDataFd >= 0) {
+      munmap((char*)this->drawData - offsetof(GraphStore, data), sizeof(GraphStore));
+      close(this->drawDataFd);
+      this->drawDataFd = -1;
+   } else {
+      free(this->drawData);
+   }
+   this->drawData = NULL;
+}
+
 void Meter_delete(Object* cast) {
    if (!cast)
       return;
@@ -87,7 +215,7 @@ void Meter_delete(Object* cast) {
    if (Meter_doneFn(this)) {
       Meter_done(this);
    }
-   free(this->drawData);
+   Meter_freeDrawData(this);
    free(this->caption);
    free(this->values);
    free(this);
@@ -115,6 +243,13 @@ void Meter_setMode(Meter* this, int modeIndex) {
    }
 
    assert(modeIndex < LAST_METERMODE);
+   uint32_t supported = Meter_supportedModes(this);
+   if (supported && !(supported & (1U << modeIndex))) {
+      modeIndex = Meter_defaultMode(this);
+      if (modeIndex == this->mode)
+         return;
+   }
+
    if (Meter_defaultMode(this) == CUSTOM_METERMODE) {
       this->draw = Meter_drawFn(this);
       if (Meter_updateModeFn(this)) {
@@ -122,8 +257,7 @@ void Meter_setMode(Meter* this, int modeIndex) {
       }
    } else {
       assert(modeIndex >= 1);
-      free(this->drawData);
-      this->drawData = NULL;
+      Meter_freeDrawData(this);
 
       const MeterMode* mode = Meter_modes[modeIndex];
       this->draw = mode->draw;
@@ -132,6 +266,17 @@ void Meter_setMode(Meter* this, int modeIndex) {
    this->mode = modeIndex;
 }
 
+int Meter_nextSupportedMode(const Meter* this) {
+   uint32_t supported = Meter_supportedModes(this);
+   int mode = this->mode;
+   for (int i = 1; i < LAST_METERMODE; i++) {
+      mode = mode + 1 < LAST_METERMODE ? mode + 1 : 1;
+      if (!supported || (supported & (1U << mode)))
+         return mode;
+   }
+   return this->mode;
+}
+
 ListItem* Meter_toListItem(const Meter* this, bool moving) {
    char mode[20];
    if (this->mode) {
@@ -145,13 +290,36 @@ ListItem* Meter_toListItem(const Meter* this, bool moving) {
    } else {
       number[0] = '\0';
    }
-   char buffer[50];
-   xSnprintf(buffer, sizeof(buffer), "%s%s%s", Meter_uiName(this), number, mode);
+   char interval[16];
+   if (this->updateInterval > 0) {
+      xSnprintf(interval, sizeof(interval), " (%ds)", this->updateInterval / 10);
+   } else {
+      interval[0] = '\0';
+   }
+   char buffer[70];
+   xSnprintf(buffer, sizeof(buffer), "%s%s%s%s", Meter_uiName(this), number, mode, interval);
    ListItem* li = ListItem_new(buffer, 0);
    li->moving = moving;
    return li;
 }
 
+bool Meter_isDue(const Meter* this, uint64_t nowMs) {
+   if (this->updateInterval <= 0 || this->lastUpdateMs == 0 || nowMs < this->lastUpdateMs)
+      return true;
+
+   return nowMs - this->lastUpdateMs >= 100 * (uint64_t)this->updateInterval;
+}
+
+void Meter_cycleInterval(Meter* this) {
+   static const int intervals[] = { 0, 10, 50, 100, 300, 600 };
+
+   size_t i = 0;
+   while (i < ARRAYSIZE(intervals) && intervals[i] <= this->updateInterval)
+      i++;
+   this->updateInterval = i < ARRAYSIZE(intervals) ? intervals[i] : 0;
+   this->lastUpdateMs = 0;
+}
+
 /* ---------- TextMeterMode ---------- */
 
 static void TextMeterMode_draw(Meter* this, int x, int y, int w) {
@@ -286,14 +454,128 @@ static const char* const GraphMeterMode_dotsAscii[] = {
    /*20*/":", /*21*/":", /*22*/":"
 };
 
-static void GraphMeterMode_draw(Meter* this, int x, int y, int w) {
-   const ProcessList* pl = this->pl;
+unsigned int GraphData_levelsFor(int historyHours, int delay) {
+   double span = (double)METER_GRAPHDATA_SIZE * MAXIMUM(delay, 1) / 10.0;
+   double wanted = historyHours * 3600.0;
+   unsigned int levels = 1;
+   while (levels < METER_GRAPHDATA_LEVELS && span < wanted) {
+      span *= METER_GRAPHDATA_FACTOR;
+      levels++;
+   }
+   return levels;
+}
+
+static void GraphRing_append(GraphRing* ring, GraphBucket bucket) {
+   ring->entries[ring->head] = bucket;
+   ring->head = (ring->head + 1) % METER_GRAPHDATA_SIZE;
+   if (ring->count < METER_GRAPHDATA_SIZE)
+      ring->count++;
+}
+
+static inline const GraphBucket* GraphRing_newest(const GraphRing* ring, uint32_t age) {
+   return &ring->entries[(ring->head + METER_GRAPHDATA_SIZE - 1 - age) % METER_GRAPHDATA_SIZE];
+}
+
+void GraphData_push(GraphData* data, double value) {
+   GraphBucket bucket = { .min = value, .avg = value, .max = value };
+   GraphRing_append(&data->levels[0], bucket);
+
+   for (uint32_t l = 1; l < data->nLevels; l++) {
+      GraphRing* ring = &data->levels[l];
+
+      // acc.avg holds the running sum until the bucket is complete
+      if (!isnan(bucket.avg)) {
+         if (ring->pendingValid == 0) {
+            ring->acc = bucket;
+         } else {
+            ring->acc.min = MINIMUM(ring->acc.min, bucket.min);
+            ring->acc.max = MAXIMUM(ring->acc.max, bucket.max);
+            ring->acc.avg += bucket.avg;
+         }
+         ring->pendingValid++;
+      }
+      ring->pending++;
+      if (ring->pending < METER_GRAPHDATA_FACTOR)
+         return;
+
+      if (ring->pendingValid) {
+         ring->acc.avg /= ring->pendingValid;
+      } else {
+         ring->acc = (GraphBucket) { .min = NAN, .avg = NAN, .max = NAN };
+      }
+      bucket = ring->acc;
+      GraphRing_append(ring, bucket);
+      ring->pending = 0;
+      ring->pendingValid = 0;
+   }
+}
+
+/* Fill out[] with up to n values, newest first, continuing into the coarser
+ * levels where the finer ones run out of history. */
+static int GraphData_collect(const GraphData* data, double* out, int n) {
+   int filled = 0;
+   uint32_t skip = 0;
+   for (uint32_t l = 0; l < data->nLevels && filled < n; l++) {
+      const GraphRing* ring = &data->levels[l];
+      for (uint32_t age = skip; age < ring->count && filled < n; age++)
+         out[filled++] = GraphRing_newest(ring, age)->avg;
+
+      // skip the coarser buckets that cover what was just shown
+      if (l + 1 < data->nLevels) {
+         uint32_t pending = data->levels[l + 1].pending;
+         skip = ring->count > pending ? (ring->count - pending + METER_GRAPHDATA_FACTOR - 1) / METER_GRAPHDATA_FACTOR : 0;
+      }
+   }
+   return filled;
+}
+
+static int GraphMeterMode_pixels(double value, double total, int pix) {
+   if (isnan(value))
+      return 0;
+   return CLAMP((int) lround(value / total * pix), 1, pix);
+}
+
+static GraphData* GraphMeterMode_data(Meter* this) {
+   const Settings* settings = this->pl->settings;
 
    if (!this->drawData) {
-      this->drawData = xCalloc(1, sizeof(GraphData));
+      if (settings->graphHistoryPersist && !this->pl->snapshot)
+         this->drawData = GraphStore_map(this);
+      if (!this->drawData)
+         this->drawData = xCalloc(1, sizeof(GraphData));
    }
    GraphData* data = this->drawData;
-   const int nValues = METER_GRAPHDATA_SIZE;
+
+   uint32_t nLevels = GraphData_levelsFor(settings->graphHistoryHours, settings->delay);
+   if (nLevels > data->nLevels)
+      memset(&data->levels[data->nLevels], 0, (nLevels - data->nLevels) * sizeof(GraphRing));
+   data->nLevels = nLevels;
+   return data;
+}
+
+/* Graph history is fed from the update cycle rather than from drawing, so it
+ * keeps going while the header is hidden or the meter is not redrawn. */
+void Meter_sampleGraph(Meter* this) {
+   if (this->mode != GRAPH_METERMODE || Meter_defaultMode(this) == CUSTOM_METERMODE)
+      return;
+
+   const ProcessList* pl = this->pl;
+   GraphData* data = GraphMeterMode_data(this);
+   if (timercmp(&pl->realtime, &(data->time), <))
+      return;
+
+   int globalDelay = pl->settings->delay;
+   struct timeval delay = { .tv_sec = globalDelay / 10, .tv_usec = (globalDelay - ((globalDelay / 10) * 10)) * 100000 };
+   timeradd(&pl->realtime, &delay, &(data->time));
+
+   double value = 0.0;
+   for (uint8_t i = 0; i < this->curItems; i++)
+      value += this->values[i];
+   GraphData_push(data, value);
+}
+
+static void GraphMeterMode_draw(Meter* this, int x, int y, int w) {
+   const GraphData* data = GraphMeterMode_data(this);
 
    const char* const* GraphMeterMode_dots;
    int GraphMeterMode_pixPerRow;
@@ -314,31 +596,25 @@ static void GraphMeterMode_draw(Meter* this, int x, int y, int w) {
    x += captionLen;
    w -= captionLen;
 
-   if (!timercmp(&pl->realtime, &(data->time), <)) {
-      int globalDelay = this->pl->settings->delay;
-      struct timeval delay = { .tv_sec = globalDelay / 10, .tv_usec = (globalDelay - ((globalDelay / 10) * 10)) * 100000 };
-      timeradd(&pl->realtime, &delay, &(data->time));
+   int columns = w - 1;
+   if (columns <= 0) {
+      attrset(CRT_colors[RESET_COLOR]);
+      return;
+   }
 
-      for (int i = 0; i < nValues - 1; i++)
-         data->values[i] = data->values[i + 1];
+   double samples[METER_GRAPHDATA_SIZE * METER_GRAPHDATA_LEVELS];
+   int nSamples = GraphData_collect(data, samples, MINIMUM(columns * 2, (int)ARRAYSIZE(samples)));
 
-      double value = 0.0;
-      for (uint8_t i = 0; i < this->curItems; i++)
-         value += this->values[i];
-      data->values[nValues - 1] = value;
-   }
+   if (this->total < 1)
+      this->total = 1;
+   int pix = GraphMeterMode_pixPerRow * GRAPH_HEIGHT;
 
-   int i = nValues - (w * 2) + 2, k = 0;
-   if (i < 0) {
-      k = -i / 2;
-      i = 0;
-   }
-   for (; i < nValues - 1; i += 2, k++) {
-      int pix = GraphMeterMode_pixPerRow * GRAPH_HEIGHT;
-      if (this->total < 1)
-         this->total = 1;
-      int v1 = CLAMP((int) lround(data->values[i] / this->total * pix), 1, pix);
-      int v2 = CLAMP((int) lround(data->values[i + 1] / this->total * pix), 1, pix);
+   for (int k = 0; k < columns; k++) {
+      // two samples per column, the newest one at the right edge
+      int newer = (columns - 1 - k) * 2;
+      int older = newer + 1;
+      int v1 = older < nSamples ? GraphMeterMode_pixels(samples[older], this->total, pix) : 1;
+      int v2 = newer < nSamples ? GraphMeterMode_pixels(samples[newer], this->total, pix) : 1;
 
       int colorIdx = GRAPH_1;
       for (int line = 0; line < GRAPH_HEIGHT; line++) {
@@ -19,7 +19,9 @@ in the source distribution for its full text.
 
 
 #define METER_TXTBUFFER_LEN 256
-#define METER_GRAPHDATA_SIZE 256
+#define METER_GRAPHDATA_SIZE 256     /* entries kept per resolution level */
+#define METER_GRAPHDATA_LEVELS 4     /* raw samples plus three downsampled levels */
+#define METER_GRAPHDATA_FACTOR 8     /* entries of one level merged into a bucket of the next */
 
 #define METER_BUFFER_CHECK(buffer, size, written)          \
    do {                                                    \
@@ -52,6 +54,7 @@ typedef void(*Meter_Done)(Meter*);
 typedef void(*Meter_UpdateMode)(Meter*, int);
 typedef void(*Meter_UpdateValues)(Meter*);
 typedef void(*Meter_Draw)(Meter*, int, int, int);
+typedef Meter** (*Meter_GetSubMeters)(const Meter*, int*);
 
 typedef struct MeterClass_ {
    const ObjectClass super;
@@ -68,6 +71,9 @@ typedef struct MeterClass_ {
    const char* const caption;              /* prefix in the actual header */
    const char* const description;          /* optional meter description in header setup menu */
    const uint8_t maxItems;
+   const int updateInterval;               /* default refresh period in tenths of a second, 0 for every update */
+   const Meter_GetSubMeters subMeters;     /* optional, meters updated and drawn as part of this one */
+   const uint32_t supportedModes;          /* bit of each MeterModeId the meter can be shown in, 0 for all */
 } MeterClass;
 
 #define As_Meter(this_)                ((const MeterClass*)((this_)->super.klass))
@@ -80,13 +86,40 @@ typedef struct MeterClass_ {
 #define Meter_doneFn(this_)            As_Meter(this_)->done
 #define Meter_updateValues(this_)      As_Meter(this_)->updateValues((Meter*)(this_))
 #define Meter_defaultMode(this_)       As_Meter(this_)->defaultMode
+#define Meter_supportedModes(this_)    As_Meter(this_)->supportedModes
 #define Meter_attributes(this_)        As_Meter(this_)->attributes
 #define Meter_name(this_)              As_Meter(this_)->name
 #define Meter_uiName(this_)            As_Meter(this_)->uiName
 
+typedef struct GraphBucket_ {
+   double min;
+   double avg;
+   double max;
+} GraphBucket;
+
+typedef struct GraphRing_ {
+   uint32_t head;                  /* slot the next entry is written to */
+   uint32_t count;                 /* valid entries, at most METER_GRAPHDATA_SIZE */
+   uint32_t pending;               /* entries of the level below merged into acc so far */
+   uint32_t pendingValid;          /* ... of which were not gaps */
+   GraphBucket acc;                /* bucket under construction, unused on the raw level */
+   GraphBucket entries[METER_GRAPHDATA_SIZE];
+} GraphRing;
+
+/*
+ * Graph history is kept as a set of fixed-size rings: level 0 holds raw
+ * samples, every further level holds min/avg/max buckets of
+ * METER_GRAPHDATA_FACTOR entries of the level below.  Appending is O(1)
+ * amortized, and the structure contains no pointers so it can be placed
+ * in a file mapping as is.  Its size is bounded by sizeof(GraphData),
+ * roughly 24 KiB per graph meter regardless of the configured depth.
+ * A sample of NAN marks a gap in the history.
+ */
 typedef struct GraphData_ {
    struct timeval time;
-   double values[METER_GRAPHDATA_SIZE];
+   uint32_t nLevels;               /* levels currently fed, 1..METER_GRAPHDATA_LEVELS */
+   uint32_t reserved;
+   GraphRing levels[METER_GRAPHDATA_LEVELS];
 } GraphData;
 
 struct Meter_ {
@@ -97,6 +130,9 @@ struct Meter_ {
    int mode;
    unsigned int param;
    GraphData* drawData;
+   int drawDataFd;            /*<< locked history file backing drawData, or -1 */
+   int updateInterval;        /*<< tenths of a second between updates, 0 for every update */
+   uint64_t lastUpdateMs;     /*<< monotonic time of the last update, 0 if never */
    int h;
    int columnWidthCount;      /*<< only used internally by the Header */
    const ProcessList* pl;
@@ -133,10 +169,24 @@ void Meter_delete(Object* cast);
 
 void Meter_setCaption(Meter* this, const char* caption);
 
+/* Modes the meter does not support fall back to its default mode */
 void Meter_setMode(Meter* this, int modeIndex);
 
+/* The mode after the current one that the meter supports */
+int Meter_nextSupportedMode(const Meter* this);
+
 ListItem* Meter_toListItem(const Meter* this, bool moving);
 
+bool Meter_isDue(const Meter* this, uint64_t nowMs);
+
+void Meter_cycleInterval(Meter* this);
+
+void Meter_sampleGraph(Meter* this);
+
+unsigned int GraphData_levelsFor(int historyHours, int delay);
+
+void GraphData_push(GraphData* data, double value);
+
 extern const MeterMode* const Meter_modes[];
 
 extern const MeterClass BlankMeter_class;
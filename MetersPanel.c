@@ -20,9 +20,9 @@ in the source distribution for its full text.
 
 // Note: In code the meters are known to have bar/text/graph "Modes", but in UI
 // we call them "Styles".
-static const char* const MetersFunctions[] = {"Stil ", "Taşı  ", "                                         ", "Sil", "Tamam  ", NULL};
-static const char* const MetersKeys[] = {"Boşluk", "Enter", "", "Del", "F10"};
-static const int MetersEvents[] = {' ', 13, ERR, KEY_DC, KEY_F(10)};
+static const char* const MetersFunctions[] = {"Stil ", "Taşı  ", "Aralık ", "                                  ", "Sil", "Tamam  ", NULL};
+static const char* const MetersKeys[] = {"Boşluk", "Enter", "i", "", "Del", "F10"};
+static const int MetersEvents[] = {' ', 13, 'i', ERR, KEY_DC, KEY_F(10)};
 
 // We avoid UTF-8 arrows ← → here as they might display full-width on Chinese
 // terminals, breaking our aligning.
@@ -109,9 +109,17 @@ static HandlerResult MetersPanel_eventHandler(Panel* super, int ch) {
          if (!Vector_size(this->meters))
             break;
          Meter* meter = (Meter*) Vector_get(this->meters, selected);
-         int mode = meter->mode + 1;
-         if (mode == LAST_METERMODE) mode = 1;
-         Meter_setMode(meter, mode);
+         Meter_setMode(meter, Meter_nextSupportedMode(meter));
+         Panel_set(super, selected, (Object*) Meter_toListItem(meter, this->moving));
+         result = HANDLED;
+         break;
+      }
+      case 'i':
+      {
+         if (!Vector_size(this->meters))
+            break;
+         Meter* meter = (Meter*) Vector_get(this->meters, selected);
+         Meter_cycleInterval(meter);
          Panel_set(super, selected, (Object*) Meter_toListItem(meter, this->moving));
          result = HANDLED;
          break;
@@ -10,6 +10,8 @@ in the source distribution for its full text.
 #include "OpenFilesScreen.h"
 
 #include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -19,51 +21,73 @@ in the source distribution for its full text.
 
 #include "Macros.h"
 #include "Panel.h"
+#include "Platform.h"
 #include "ProvideCurses.h"
-#include "Vector.h"
 #include "XUtils.h"
 
 
-typedef struct OpenFiles_Data_ {
-   char* data[7];
-} OpenFiles_Data;
-
-typedef struct OpenFiles_ProcessData_ {
-   OpenFiles_Data data;
-   int error;
-   struct OpenFiles_FileData_* files;
-} OpenFiles_ProcessData;
-
-typedef struct OpenFiles_FileData_ {
-   OpenFiles_Data data;
-   struct OpenFiles_FileData_* next;
-} OpenFiles_FileData;
-
-static size_t getIndexForType(char type) {
-   switch (type) {
-   case 'f':
-      return 0;
-   case 'a':
-      return 1;
-   case 'D':
-      return 2;
-   case 'i':
-      return 3;
-   case 'n':
-      return 4;
-   case 's':
-      return 5;
-   case 't':
-      return 6;
+OpenFiles_ProcessData* OpenFiles_ProcessData_new(void) {
+   OpenFiles_ProcessData* this = xCalloc(1, sizeof(OpenFiles_ProcessData));
+   OpenFiles_ProcessData_addName(this, "");
+   return this;
+}
+
+void OpenFiles_ProcessData_delete(OpenFiles_ProcessData* this) {
+   if (!this)
+      return;
+
+   free(this->files);
+   free(this->names);
+   free(this);
+}
+
+OpenFiles_FileData* OpenFiles_ProcessData_add(OpenFiles_ProcessData* this) {
+   if (this->nFiles == this->capacity) {
+      this->capacity = MAXIMUM(this->capacity * 2, 64);
+      this->files = xReallocArray(this->files, this->capacity, sizeof(OpenFiles_FileData));
    }
+   OpenFiles_FileData* fdata = &this->files[this->nFiles++];
+   memset(fdata, 0, sizeof(OpenFiles_FileData));
+   return fdata;
+}
 
-   /* should never reach here */
-   abort();
+size_t OpenFiles_ProcessData_addName(OpenFiles_ProcessData* this, const char* name) {
+   size_t len = strlen(name) + 1;
+   if (this->namesSize + len > this->namesCapacity) {
+      this->namesCapacity = MAXIMUM(this->namesCapacity * 2, this->namesSize + len + 4096);
+      this->names = xRealloc(this->names, this->namesCapacity);
+   }
+   size_t offset = this->namesSize;
+   memcpy(this->names + offset, name, len);
+   this->namesSize += len;
+   return offset;
 }
 
-static const char* getDataForType(const OpenFiles_Data* data, char type) {
-   size_t index = getIndexForType(type);
-   return data->data[index] ? data->data[index] : "";
+static int OpenFiles_FileData_compare(const void* v1, const void* v2) {
+   const OpenFiles_FileData* f1 = v1;
+   const OpenFiles_FileData* f2 = v2;
+   if (f1->number != f2->number)
+      return f1->number < f2->number ? -1 : 1;
+   // names are added in the order the entries were read, which keeps that order among equal descriptors
+   return f1->name < f2->name ? -1 : f1->name > f2->name ? 1 : 0;
+}
+
+void OpenFiles_ProcessData_sort(OpenFiles_ProcessData* this) {
+   if (this->nFiles > 1)
+      qsort(this->files, this->nFiles, sizeof(OpenFiles_FileData), OpenFiles_FileData_compare);
+}
+
+const OpenFiles_FileData* OpenFiles_ProcessData_find(const OpenFiles_ProcessData* this, int number) {
+   size_t lo = 0;
+   size_t hi = this->nFiles;
+   while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (this->files[mid].number < number)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo < this->nFiles && this->files[lo].number == number ? &this->files[lo] : NULL;
 }
 
 OpenFilesScreen* OpenFilesScreen_new(const Process* process) {
@@ -74,10 +98,12 @@ OpenFilesScreen* OpenFilesScreen_new(const Process* process) {
    } else {
       this->pid = process->pid;
    }
-   return (OpenFilesScreen*) InfoScreen_init(&this->super, process, NULL, LINES - 2, "   FD TYPE    MODE DEVICE           SIZE       NODE  NAME");
+   this->previous = NULL;
+   return (OpenFilesScreen*) InfoScreen_init(&this->super, process, NULL, LINES - 2, "   FD TYPE    MODE DEVICE           SIZE     OFFSET       NODE  NAME");
 }
 
 void OpenFilesScreen_delete(Object* this) {
+   OpenFiles_ProcessData_delete(((OpenFilesScreen*)this)->previous);
    free(InfoScreen_done((InfoScreen*)this));
 }
 
@@ -85,13 +111,25 @@ static void OpenFilesScreen_draw(InfoScreen* this) {
    InfoScreen_drawTitled(this, "İşlem sırasında açılan dosyaların anlık görüntüsü %d - %s", ((OpenFilesScreen*)this)->pid, Process_getCommand(this->process));
 }
 
-static OpenFiles_ProcessData* OpenFilesScreen_getProcessData(pid_t pid) {
-   OpenFiles_ProcessData* pdata = xCalloc(1, sizeof(OpenFiles_ProcessData));
+static int OpenFilesScreen_lsofNumber(const char* fd) {
+   if (String_eq(fd, "cwd"))
+      return OPENFILES_FD_CWD;
+   if (String_eq(fd, "rtd"))
+      return OPENFILES_FD_ROOT;
+   if (String_eq(fd, "txt"))
+      return OPENFILES_FD_TEXT;
 
+   char* end;
+   long number = strtol(fd, &end, 10);
+   return end != fd && number >= 0 && number <= INT_MAX ? (int)number : OPENFILES_FD_OTHER;
+}
+
+/* Runs lsof, for platforms that can not list the descriptors of a process themselves */
+static void OpenFilesScreen_getLsofData(pid_t pid, OpenFiles_ProcessData* pdata) {
    int fdpair[2] = {0, 0};
    if (pipe(fdpair) == -1) {
       pdata->error = 1;
-      return pdata;
+      return;
    }
 
    pid_t child = fork();
@@ -99,7 +137,7 @@ static OpenFiles_ProcessData* OpenFilesScreen_getProcessData(pid_t pid) {
       close(fdpair[1]);
       close(fdpair[0]);
       pdata->error = 1;
-      return pdata;
+      return;
    }
 
    if (child == 0) {
@@ -120,14 +158,14 @@ static OpenFiles_ProcessData* OpenFilesScreen_getProcessData(pid_t pid) {
    }
    close(fdpair[1]);
 
-   OpenFiles_Data* item = &(pdata->data);
-   OpenFiles_FileData* fdata = NULL;
-
    FILE* fd = fdopen(fdpair[0], "r");
    if (!fd) {
       pdata->error = 1;
-      return pdata;
+      return;
    }
+
+   // entries are appended while parsing, so they are addressed by index
+   size_t current = SIZE_MAX;
    for (;;) {
       char* line = String_readLine(fd);
       if (!line) {
@@ -135,45 +173,40 @@ static OpenFiles_ProcessData* OpenFilesScreen_getProcessData(pid_t pid) {
       }
 
       unsigned char cmd = line[0];
-      switch (cmd) {
-      case 'f':  /* file descriptor */
-      {
-         OpenFiles_FileData* nextFile = xCalloc(1, sizeof(OpenFiles_FileData));
-         if (fdata == NULL) {
-            pdata->files = nextFile;
-         } else {
-            fdata->next = nextFile;
+      const char* value = line + 1;
+      if (cmd == 'f') {  /* file descriptor */
+         OpenFiles_FileData* fdata = OpenFiles_ProcessData_add(pdata);
+         String_safeStrncpy(fdata->fd, value, sizeof(fdata->fd));
+         fdata->number = OpenFilesScreen_lsofNumber(value);
+         current = pdata->nFiles - 1;
+      } else if (current != SIZE_MAX) {
+         OpenFiles_FileData* fdata = &pdata->files[current];
+         switch (cmd) {
+         case 'a':  /* file access mode */
+            String_safeStrncpy(fdata->mode, value, sizeof(fdata->mode));
+            break;
+         case 'D':  /* file's major/minor device number */
+            String_safeStrncpy(fdata->device, value, sizeof(fdata->device));
+            break;
+         case 'i':  /* file's inode number */
+            String_safeStrncpy(fdata->node, value, sizeof(fdata->node));
+            break;
+         case 'n':  /* file name, comment, Internet address */
+            fdata->name = OpenFiles_ProcessData_addName(pdata, value);
+            break;
+         case 'o':  /* file's offset */
+            String_safeStrncpy(fdata->offset, value, sizeof(fdata->offset));
+            break;
+         case 's':  /* file's size */
+            String_safeStrncpy(fdata->size, value, sizeof(fdata->size));
+            break;
+         case 't':  /* file's type */
+            String_safeStrncpy(fdata->type, value, sizeof(fdata->type));
+            break;
+         default:
+            /* ignore */
+            break;
          }
-         fdata = nextFile;
-         item = &(fdata->data);
-      } /* FALLTHRU */
-      case 'a':  /* file access mode */
-      case 'D':  /* file's major/minor device number */
-      case 'i':  /* file's inode number */
-      case 'n':  /* file name, comment, Internet address */
-      case 's':  /* file's size */
-      case 't':  /* file's type */
-      {
-         size_t index = getIndexForType(cmd);
-         free(item->data[index]);
-         item->data[index] = xStrdup(line + 1);
-         break;
-      }
-      case 'c':  /* process command name  */
-      case 'd':  /* file's device character code */
-      case 'g':  /* process group ID */
-      case 'G':  /* file flags */
-      case 'k':  /* link count */
-      case 'l':  /* file's lock status */
-      case 'L':  /* process login name */
-      case 'o':  /* file's offset */
-      case 'p':  /* process ID */
-      case 'P':  /* protocol name */
-      case 'R':  /* parent process ID */
-      case 'T':  /* TCP/TPI information, identified by prefixes */
-      case 'u':  /* process user ID */
-         /* ignore */
-         break;
       }
       free(line);
    }
@@ -182,7 +215,7 @@ static OpenFiles_ProcessData* OpenFilesScreen_getProcessData(pid_t pid) {
    int wstatus;
    if (waitpid(child, &wstatus, 0) == -1) {
       pdata->error = 1;
-      return pdata;
+      return;
    }
 
    if (!WIFEXITED(wstatus)) {
@@ -190,50 +223,46 @@ static OpenFiles_ProcessData* OpenFilesScreen_getProcessData(pid_t pid) {
    } else {
       pdata->error = WEXITSTATUS(wstatus);
    }
-
-   return pdata;
-}
-
-static void OpenFiles_Data_clear(OpenFiles_Data* data) {
-   for (size_t i = 0; i < ARRAYSIZE(data->data); i++)
-      free(data->data[i]);
 }
 
-static void OpenFilesScreen_scan(InfoScreen* this) {
-   Panel* panel = this->display;
+static void OpenFilesScreen_scan(InfoScreen* super) {
+   OpenFilesScreen* this = (OpenFilesScreen*)super;
+   Panel* panel = super->display;
    int idx = Panel_getSelectedIndex(panel);
    Panel_prune(panel);
-   OpenFiles_ProcessData* pdata = OpenFilesScreen_getProcessData(((OpenFilesScreen*)this)->pid);
+
+   OpenFiles_ProcessData* pdata = OpenFiles_ProcessData_new();
+   if (!Platform_getProcessFiles(this->pid, this->previous, pdata))
+      OpenFilesScreen_getLsofData(this->pid, pdata);
+
    if (pdata->error == 127) {
-      InfoScreen_addLine(this, "'Lsof' yürütülemedi. Lütfen ürününüzde mevcut olduğundan emin olun. $PATH.");
+      InfoScreen_addLine(super, "'Lsof' yürütülemedi. Lütfen ürününüzde mevcut olduğundan emin olun. $PATH.");
    } else if (pdata->error == 1) {
-      InfoScreen_addLine(this, "Açık dosyalar listelenemedi.");
+      InfoScreen_addLine(super, "Açık dosyalar listelenemedi.");
    } else {
-      OpenFiles_FileData* fdata = pdata->files;
-      while (fdata) {
-         OpenFiles_Data* data = &fdata->data;
-         size_t lenN = strlen(getDataForType(data, 'n'));
-         size_t sizeEntry = 5 + 7 + 4 + 10 + 10 + 10 + lenN + 7 /*spaces*/ + 1 /*null*/;
+      OpenFiles_ProcessData_sort(pdata);
+      for (size_t i = 0; i < pdata->nFiles; i++) {
+         const OpenFiles_FileData* fdata = &pdata->files[i];
+         const char* name = OpenFiles_ProcessData_name(pdata, fdata->name);
+         size_t sizeEntry = 5 + 7 + 4 + 10 + 10 + 10 + 10 + strlen(name) + 8 /*spaces*/ + 1 /*null*/;
          char entry[sizeEntry];
-         xSnprintf(entry, sizeof(entry), "%5.5s %-7.7s %-4.4s %-10.10s %10.10s %10.10s  %s",
-                   getDataForType(data, 'f'),
-                   getDataForType(data, 't'),
-                   getDataForType(data, 'a'),
-                   getDataForType(data, 'D'),
-                   getDataForType(data, 's'),
-                   getDataForType(data, 'i'),
-                   getDataForType(data, 'n'));
-         InfoScreen_addLine(this, entry);
-         OpenFiles_Data_clear(data);
-         OpenFiles_FileData* old = fdata;
-         fdata = fdata->next;
-         free(old);
+         xSnprintf(entry, sizeof(entry), "%5.5s %-7.7s %-4.4s %-10.10s %10.10s %10.10s %10.10s  %s",
+                   fdata->fd,
+                   fdata->type,
+                   fdata->mode,
+                   fdata->device,
+                   fdata->size,
+                   fdata->offset,
+                   fdata->node,
+                   name);
+         InfoScreen_addLine(super, entry);
       }
-      OpenFiles_Data_clear(&pdata->data);
    }
-   free(pdata);
-   Vector_insertionSort(this->lines);
-   Vector_insertionSort(panel->items);
+
+   OpenFiles_ProcessData_delete(this->previous);
+   this->previous = pdata->error ? NULL : pdata;
+   if (pdata->error)
+      OpenFiles_ProcessData_delete(pdata);
    Panel_setSelected(panel, idx);
 }
 
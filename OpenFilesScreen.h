@@ -7,17 +7,74 @@ Released under the GNU GPLv2, see the COPYING file
 in the source distribution for its full text.
 */
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <sys/types.h>
 
 #include "InfoScreen.h"
 #include "Object.h"
 #include "Process.h"
 
+
+/* The descriptors that are not numbered sort before the numbered ones */
+#define OPENFILES_FD_CWD  (-3)
+#define OPENFILES_FD_ROOT (-2)
+#define OPENFILES_FD_TEXT (-1)
+#define OPENFILES_FD_OTHER (-4)
+
+typedef struct OpenFiles_FileData_ {
+   int number;                /* the descriptor, or one of the OPENFILES_FD_ values */
+   char fd[8];
+   char type[8];
+   char mode[4];
+   char device[16];
+   char size[24];
+   char offset[24];
+   char node[24];
+   size_t name;               /* offset of the name in the names arena */
+   size_t link;               /* offset of what the descriptor pointed to when it was read, 0 if unknown */
+} OpenFiles_FileData;
+
+/*
+ * The open files of a process as one flat array sorted by descriptor.
+ * Names are kept in a single arena so that a listing of many thousand
+ * descriptors is a handful of allocations.
+ */
+typedef struct OpenFiles_ProcessData_ {
+   int error;
+   OpenFiles_FileData* files;
+   size_t nFiles;
+   size_t capacity;
+   char* names;               /* NUL separated, starting with an empty string */
+   size_t namesSize;
+   size_t namesCapacity;
+} OpenFiles_ProcessData;
+
 typedef struct OpenFilesScreen_ {
    InfoScreen super;
    pid_t pid;
+   OpenFiles_ProcessData* previous;   /* the last listing, a refresh only reads again what changed */
 } OpenFilesScreen;
 
+OpenFiles_ProcessData* OpenFiles_ProcessData_new(void);
+
+void OpenFiles_ProcessData_delete(OpenFiles_ProcessData* this);
+
+/* Appends a zeroed entry, valid until the next one is added */
+OpenFiles_FileData* OpenFiles_ProcessData_add(OpenFiles_ProcessData* this);
+
+/* Copies a string into the arena and returns its offset */
+size_t OpenFiles_ProcessData_addName(OpenFiles_ProcessData* this, const char* name);
+
+static inline const char* OpenFiles_ProcessData_name(const OpenFiles_ProcessData* this, size_t offset) {
+   return this->names + offset;
+}
+
+/* The entry of a descriptor in a listing sorted by OpenFiles_ProcessData_sort, NULL if there is none */
+const OpenFiles_FileData* OpenFiles_ProcessData_find(const OpenFiles_ProcessData* this, int number);
+
+void OpenFiles_ProcessData_sort(OpenFiles_ProcessData* this);
+
 extern const InfoScreenClass OpenFilesScreen_class;
 
 OpenFilesScreen* OpenFilesScreen_new(const Process* process);
@@ -10,6 +10,7 @@ in the source distribution for its full text.
 #include <assert.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
@@ -17,6 +18,7 @@ in the source distribution for its full text.
 #include "CRT.h"
 #include "ListItem.h"
 #include "Macros.h"
+#include "Profile.h"
 #include "ProvideCurses.h"
 #include "RichString.h"
 #include "XUtils.h"
@@ -211,6 +213,7 @@ void Panel_splice(Panel* this, Vector* from) {
 void Panel_draw(Panel* this, bool force_redraw, bool focus, bool highlightSelected, bool hideFunctionBar) {
    assert (this != NULL);
 
+   uint64_t start = Profile_start();
    int size = Vector_size(this->items);
    int scrollH = this->scrollH;
    int y = this->y;
@@ -331,6 +334,7 @@ void Panel_draw(Panel* this, bool force_redraw, bool focus, bool highlightSelect
    this->wasFocus = focus;
    this->needsRedraw = false;
    move(0, 0);
+   Profile_stop(PROFILE_PANEL_DRAW, start);
 }
 
 static int Panel_headerHeight(const Panel* this) {
@@ -294,6 +294,7 @@ void Process_writeField(const Process* this, RichString* str, ProcessField field
       Process_writeCommand(this, attr, baseattr, str);
       return;
    }
+   case HOST: xSnprintf(buffer, n, "%-12.12s ", ProcessList_hostName(this->processList, this->pid)); break;
    case MAJFLT: Process_colorNumber(str, this->majflt, coloring); return;
    case MINFLT: Process_colorNumber(str, this->minflt, coloring); return;
    case M_RESIDENT: Process_humanNumber(str, this->m_resident, coloring); return;
@@ -339,8 +340,8 @@ void Process_writeField(const Process* this, RichString* str, ProcessField field
       }
       break;
    case PGRP: xSnprintf(buffer, n, "%*d ", Process_pidDigits, this->pgrp); break;
-   case PID: xSnprintf(buffer, n, "%*d ", Process_pidDigits, this->pid); break;
-   case PPID: xSnprintf(buffer, n, "%*d ", Process_pidDigits, this->ppid); break;
+   case PID: xSnprintf(buffer, n, "%*d ", Process_pidDigits, Process_localPid(this->pid)); break;
+   case PPID: xSnprintf(buffer, n, "%*d ", Process_pidDigits, Process_localPid(this->ppid)); break;
    case PRIORITY:
       if (this->priority <= -100)
          xSnprintf(buffer, n, " RT ");
@@ -371,7 +372,7 @@ void Process_writeField(const Process* this, RichString* str, ProcessField field
       if (this->tgid == this->pid)
          attr = CRT_colors[PROCESS_SHADOW];
 
-      xSnprintf(buffer, n, "%*d ", Process_pidDigits, this->tgid);
+      xSnprintf(buffer, n, "%*d ", Process_pidDigits, Process_localPid(this->tgid));
       break;
    case TPGID: xSnprintf(buffer, n, "%*d ", Process_pidDigits, this->tpgid); break;
    case TTY_NR: {
@@ -568,6 +569,8 @@ int Process_compareByKey_Base(const Process* p1, const Process* p2, ProcessField
       return SPACESHIP_NUMBER(p1->m_resident, p2->m_resident);
    case COMM:
       return SPACESHIP_NULLSTR(Process_getCommand(p1), Process_getCommand(p2));
+   case HOST:
+      return SPACESHIP_NULLSTR(ProcessList_hostName(p1->processList, p1->pid), ProcessList_hostName(p2->processList, p2->pid));
    case MAJFLT:
       return SPACESHIP_NUMBER(p1->majflt, p2->majflt);
    case MINFLT:
@@ -46,6 +46,7 @@ typedef enum ProcessField_ {
    NLWP = 51,
    TGID = 52,
    PERCENT_NORM_CPU = 53,
+   HOST = 54,
 
    /* Platform specific fields, defined in ${platform}/ProcessField.h */
    PLATFORM_PROCESS_FIELDS
@@ -220,19 +221,35 @@ typedef Process*(*Process_New)(const struct Settings_*);
 typedef void (*Process_WriteField)(const Process*, RichString*, ProcessField);
 typedef int (*Process_CompareByKey)(const Process*, const Process*, ProcessField);
 typedef const char* (*Process_GetCommandStr)(const Process*);
+typedef const char* (*Process_GetListenPorts)(const Process*);
 
 typedef struct ProcessClass_ {
    const ObjectClass super;
    const Process_WriteField writeField;
    const Process_CompareByKey compareByKey;
    const Process_GetCommandStr getCommandStr;
+   const Process_GetListenPorts getListenPorts;
 } ProcessClass;
 
 #define As_Process(this_)                              ((const ProcessClass*)((this_)->super.klass))
 
 #define Process_getCommand(this_)                      (As_Process(this_)->getCommandStr ? As_Process(this_)->getCommandStr((const Process*)(this_)) : ((const Process*)(this_))->comm)
+/* ":22 :8080" for a process listening on those ports, NULL if it listens on none or the platform does not know */
+#define Process_getListenPorts(this_)                  (As_Process(this_)->getListenPorts ? As_Process(this_)->getListenPorts((const Process*)(this_)) : NULL)
 #define Process_compareByKey(p1_, p2_, key_)           (As_Process(p1_)->compareByKey ? (As_Process(p1_)->compareByKey(p1_, p2_, key_)) : Process_compareByKey_Base(p1_, p2_, key_))
 
+/* Processes of other hosts are told apart by the host number above the bits of a pid */
+#define PROCESS_HOST_SHIFT 22
+#define PROCESS_MAX_HOSTS ((1U << (31 - PROCESS_HOST_SHIFT)) - 1)
+
+static inline pid_t Process_localPid(pid_t pid) {
+   return pid & ((1 << PROCESS_HOST_SHIFT) - 1);
+}
+
+static inline unsigned int Process_hostIndex(pid_t pid) {
+   return (unsigned int)pid >> PROCESS_HOST_SHIFT;
+}
+
 static inline pid_t Process_getParentPid(const Process* this) {
    return this->tgid == this->pid ? this->ppid : this->tgid;
 }
@@ -8,6 +8,7 @@ in the source distribution for its full text.
 #include "ProcessList.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/time.h>
@@ -16,6 +17,8 @@ in the source distribution for its full text.
 #include "Hashtable.h"
 #include "Macros.h"
 #include "Platform.h"
+#include "Profile.h"
+#include "Snapshot.h"
 #include "Vector.h"
 #include "XUtils.h"
 
@@ -38,6 +41,10 @@ ProcessList* ProcessList_init(ProcessList* this, const ObjectClass* klass, Users
 
    this->monotonicMs = 0;
 
+   this->snapshot = NULL;
+   this->hostNames = NULL;
+   this->hostCount = 0;
+
 #ifdef HAVE_LIBHWLOC
    this->topologyOk = false;
    if (hwloc_topology_init(&this->topology) == 0) {
@@ -76,6 +83,11 @@ void ProcessList_done(ProcessList* this) {
    Vector_delete(this->processes);
 }
 
+const char* ProcessList_hostName(const ProcessList* this, pid_t pid) {
+   unsigned int host = Process_hostIndex(pid);
+   return host && host <= this->hostCount ? this->hostNames[host - 1] : "";
+}
+
 void ProcessList_setPanel(ProcessList* this, Panel* panel) {
    this->panel = panel;
 }
@@ -470,12 +482,14 @@ static void ProcessList_buildTree(ProcessList* this) {
 }
 
 void ProcessList_sort(ProcessList* this) {
+   uint64_t start = Profile_start();
    if (this->settings->treeView) {
       ProcessList_updateTreeSet(this);
       Vector_quickSortCustomCompare(this->processes, ProcessList_treeProcessCompare);
    } else {
       Vector_insertionSort(this->processes);
    }
+   Profile_stop(PROFILE_SORT, start);
 }
 
 ProcessField ProcessList_keyAt(const ProcessList* this, int at) {
@@ -511,6 +525,7 @@ void ProcessList_collapseAllBranches(ProcessList* this) {
 }
 
 void ProcessList_rebuildPanel(ProcessList* this) {
+   uint64_t start = Profile_start();
    const char* incFilter = this->incFilter;
 
    const int currPos = Panel_getSelectedIndex(this->panel);
@@ -566,6 +581,7 @@ void ProcessList_rebuildPanel(ProcessList* this) {
 
       this->panel->scrollV = currScrollV;
    }
+   Profile_stop(PROFILE_REBUILD, start);
 }
 
 Process* ProcessList_getProcess(ProcessList* this, pid_t pid, bool* preExisting, Process_New constructor) {
@@ -583,9 +599,16 @@ Process* ProcessList_getProcess(ProcessList* this, pid_t pid, bool* preExisting,
 }
 
 void ProcessList_scan(ProcessList* this, bool pauseProcessUpdate) {
+   Profile_tick();
+
    // in pause mode only gather global data for meters (CPU/memory/...)
    if (pauseProcessUpdate) {
+      if (this->snapshot)
+         return;
+
+      uint64_t start = Profile_start();
       ProcessList_goThroughEntries(this, true);
+      Profile_stop(PROFILE_SCAN, start);
       return;
    }
 
@@ -612,7 +635,13 @@ void ProcessList_scan(ProcessList* this, bool pauseProcessUpdate) {
       firstScanDone = true;
    }
 
-   ProcessList_goThroughEntries(this, false);
+   if (this->snapshot) {
+      Snapshot_restoreProcesses(this->snapshot, this);
+   } else {
+      uint64_t start = Profile_start();
+      ProcessList_goThroughEntries(this, false);
+      Profile_stop(PROFILE_SCAN, start);
+   }
 
    for (int i = Vector_size(this->processes) - 1; i >= 0; i--) {
       Process* p = (Process*) Vector_get(this->processes, i);
@@ -56,6 +56,7 @@ typedef struct ProcessList_ {
    int following;
    uid_t userId;
    const char* incFilter;
+   bool wantListenPorts;      /* a port was searched for, collect listening ports even if no column shows them */
    Hashtable* pidMatchList;
 
    #ifdef HAVE_LIBHWLOC
@@ -80,6 +81,13 @@ typedef struct ProcessList_ {
    memory_t cachedSwap;
 
    unsigned int cpuCount;
+
+   /* when set, scans take the processes from this snapshot instead of the system */
+   const struct Snapshot_* snapshot;
+
+   /* names of the hosts whose processes are shown, see Process_hostIndex() */
+   const char* const* hostNames;
+   unsigned int hostCount;
 } ProcessList;
 
 ProcessList* ProcessList_new(UsersTable* usersTable, Hashtable* pidMatchList, uid_t userId);
@@ -91,6 +99,9 @@ ProcessList* ProcessList_init(ProcessList* this, const ObjectClass* klass, Users
 
 void ProcessList_done(ProcessList* this);
 
+/* Name of the host a process runs on, empty for this system */
+const char* ProcessList_hostName(const ProcessList* this, pid_t pid);
+
 void ProcessList_setPanel(ProcessList* this, Panel* panel);
 
 void ProcessList_printHeader(const ProcessList* this, RichString* header);
@@ -12,7 +12,9 @@ in the source distribution for its full text.
 #include <inttypes.h>
 #include <limits.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "FunctionBar.h"
 #include "Panel.h"
 #include "Platform.h"
 #include "ProvideCurses.h"
@@ -20,6 +22,39 @@ in the source distribution for its full text.
 #include "XUtils.h"
 
 
+static const char* const ProcessLocksScreenFunctions[] = {"Ara ", "Filtrele ", "Yenile", "Tüm kilitler ", "Tamam   ", NULL};
+
+static const char* const ProcessLocksScreenKeys[] = {"F3", "F4", "F5", "F6", "Esc"};
+
+static const int ProcessLocksScreenEvents[] = {KEY_F(3), KEY_F(4), KEY_F(5), KEY_F(6), 27};
+
+#define PROCESS_LOCKS_HEADER "        ID  TYPE       EXCLUSION  READ/WRITE DEVICE:INODE                              START                  END  FILENAME"
+
+FileLocks_Data* FileLocks_ProcessData_add(FileLocks_ProcessData* this) {
+   if (this->nLocks == this->capacity) {
+      this->capacity = this->capacity ? this->capacity * 2 : 16;
+      this->locks = xReallocArray(this->locks, this->capacity, sizeof(FileLocks_Data));
+   }
+   FileLocks_Data* data = &this->locks[this->nLocks++];
+   memset(data, 0, sizeof(FileLocks_Data));
+   return data;
+}
+
+void FileLocks_ProcessData_delete(FileLocks_ProcessData* this) {
+   if (!this)
+      return;
+
+   for (size_t i = 0; i < this->nLocks; i++) {
+      FileLocks_Data* data = &this->locks[i];
+      free(data->locktype);
+      free(data->exclusive);
+      free(data->readwrite);
+      free(data->filename);
+   }
+   free(this->locks);
+   free(this);
+}
+
 ProcessLocksScreen* ProcessLocksScreen_new(const Process* process) {
    ProcessLocksScreen* this = xMalloc(sizeof(ProcessLocksScreen));
    Object_setClass(this, Class(ProcessLocksScreen));
@@ -27,79 +62,99 @@ ProcessLocksScreen* ProcessLocksScreen_new(const Process* process) {
       this->pid = process->tgid;
    else
       this->pid = process->pid;
-   return (ProcessLocksScreen*) InfoScreen_init(&this->super, process, NULL, LINES - 2, "        ID  TYPE       EXCLUSION  READ/WRITE DEVICE:INODE                              START                  END  FILENAME");
+   this->allProcesses = false;
+   FunctionBar* fuBar = FunctionBar_new(ProcessLocksScreenFunctions, ProcessLocksScreenKeys, ProcessLocksScreenEvents);
+   return (ProcessLocksScreen*) InfoScreen_init(&this->super, process, fuBar, LINES - 2, PROCESS_LOCKS_HEADER);
 }
 
 void ProcessLocksScreen_delete(Object* this) {
    free(InfoScreen_done((InfoScreen*)this));
 }
 
-static void ProcessLocksScreen_draw(InfoScreen* this) {
-   InfoScreen_drawTitled(this, "Snapshot of file locks of process %d - %s", ((ProcessLocksScreen*)this)->pid, Process_getCommand(this->process));
+static void ProcessLocksScreen_draw(InfoScreen* super) {
+   const ProcessLocksScreen* this = (const ProcessLocksScreen*)super;
+   if (this->allProcesses) {
+      InfoScreen_drawTitled(super, "Snapshot of file locks of all processes");
+   } else {
+      InfoScreen_drawTitled(super, "Snapshot of file locks of process %d - %s", this->pid, Process_getCommand(super->process));
+   }
 }
 
-static inline void FileLocks_Data_clear(FileLocks_Data* data) {
-   free(data->locktype);
-   free(data->exclusive);
-   free(data->readwrite);
-   free(data->filename);
+static int FileLocks_Data_compare(const void* v1, const void* v2) {
+   const FileLocks_Data* data1 = (const FileLocks_Data*)v1;
+   const FileLocks_Data* data2 = (const FileLocks_Data*)v2;
+   if (data1->pid != data2->pid)
+      return data1->pid < data2->pid ? -1 : 1;
+   return (data1->id > data2->id) - (data1->id < data2->id);
 }
 
-static void ProcessLocksScreen_scan(InfoScreen* this) {
-   Panel* panel = this->display;
+static void ProcessLocksScreen_scan(InfoScreen* super) {
+   const ProcessLocksScreen* this = (const ProcessLocksScreen*)super;
+   Panel* panel = super->display;
    int idx = Panel_getSelectedIndex(panel);
    Panel_prune(panel);
-   FileLocks_ProcessData* pdata = Platform_getProcessLocks(((ProcessLocksScreen*)this)->pid);
+   FileLocks_ProcessData* pdata = Platform_getProcessLocks(this->allProcesses ? 0 : this->pid);
    if (!pdata) {
-      InfoScreen_addLine(this, "Bu özellik, platformunuzda desteklenmiyor.");
+      InfoScreen_addLine(super, "Bu özellik, platformunuzda desteklenmiyor.");
    } else if (pdata->error) {
-      InfoScreen_addLine(this, "Dosya kilitleri belirlenemedi.");
+      InfoScreen_addLine(super, "Dosya kilitleri belirlenemedi.");
+   } else if (pdata->nLocks == 0) {
+      InfoScreen_addLine(super, this->allProcesses ? "Sistemde kilit bulunamadı." : "Seçilen işlem için kilit bulunamadı.");
    } else {
-      FileLocks_LockData* ldata = pdata->locks;
-      if (!ldata) {
-         InfoScreen_addLine(this, "Seçilen işlem için kilit bulunamadı.");
-      }
-      while (ldata) {
-         FileLocks_Data* data = &ldata->data;
+      qsort(pdata->locks, pdata->nLocks, sizeof(FileLocks_Data), FileLocks_Data_compare);
 
-         char entry[512];
+      for (size_t i = 0; i < pdata->nLocks; i++) {
+         const FileLocks_Data* data = &pdata->locks[i];
+
+         char pid[16] = "";
+         if (this->allProcesses)
+            xSnprintf(pid, sizeof(pid), "%7d  ", (int)data->pid);
+
+         char end[24];
          if (ULLONG_MAX == data->end) {
-            xSnprintf(entry, sizeof(entry), "%10d  %-10s %-10s %-10s %02x:%02x:%020"PRIu64" %20"PRIu64" %20s  %s",
-               data->id,
-               data->locktype, data->exclusive, data->readwrite,
-               data->dev[0], data->dev[1], data->inode,
-               data->start, "<END OF FILE>",
-               data->filename ? data->filename : "<N/A>"
-            );
+            xSnprintf(end, sizeof(end), "%s", "<END OF FILE>");
          } else {
-            xSnprintf(entry, sizeof(entry), "%10d  %-10s %-10s %-10s %02x:%02x:%020"PRIu64" %20"PRIu64" %20"PRIu64"  %s",
-               data->id,
-               data->locktype, data->exclusive, data->readwrite,
-               data->dev[0], data->dev[1], data->inode,
-               data->start, data->end,
-               data->filename ? data->filename : "<N/A>"
-            );
+            xSnprintf(end, sizeof(end), "%"PRIu64, data->end);
          }
 
-         InfoScreen_addLine(this, entry);
-         FileLocks_Data_clear(&ldata->data);
-
-         FileLocks_LockData* old = ldata;
-         ldata = ldata->next;
-         free(old);
+         char entry[512];
+         xSnprintf(entry, sizeof(entry), "%s%10d  %-10s %-10s %-10s %02x:%02x:%020"PRIu64" %20"PRIu64" %20s  %s",
+            pid, data->id,
+            data->locktype, data->exclusive, data->readwrite,
+            data->dev[0], data->dev[1], data->inode,
+            data->start, end,
+            data->filename ? data->filename : "<N/A>"
+         );
+         InfoScreen_addLine(super, entry);
       }
    }
-   free(pdata);
-   Vector_insertionSort(this->lines);
-   Vector_insertionSort(panel->items);
+   FileLocks_ProcessData_delete(pdata);
    Panel_setSelected(panel, idx);
 }
 
+static bool ProcessLocksScreen_onKey(InfoScreen* super, int ch) {
+   ProcessLocksScreen* this = (ProcessLocksScreen*)super;
+   switch (ch) {
+      case 'a':
+      case KEY_F(6):
+         this->allProcesses = !this->allProcesses;
+         FunctionBar_setLabel(super->display->defaultBar, KEY_F(6), this->allProcesses ? "Bu işlem     " : "Tüm kilitler ");
+         Panel_setHeader(super->display, this->allProcesses ? "    PID  " PROCESS_LOCKS_HEADER : PROCESS_LOCKS_HEADER);
+         Vector_prune(super->lines);
+         InfoScreen_scan(super);
+         Panel_setSelected(super->display, 0);
+         InfoScreen_draw(super);
+         return true;
+   }
+   return false;
+}
+
 const InfoScreenClass ProcessLocksScreen_class = {
    .super = {
       .extends = Class(Object),
       .delete = ProcessLocksScreen_delete
    },
    .scan = ProcessLocksScreen_scan,
-   .draw = ProcessLocksScreen_draw
+   .draw = ProcessLocksScreen_draw,
+   .onKey = ProcessLocksScreen_onKey,
 };
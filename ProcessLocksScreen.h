@@ -8,6 +8,7 @@ in the source distribution for its full text.
 */
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <sys/types.h>
 
@@ -19,6 +20,7 @@ in the source distribution for its full text.
 typedef struct ProcessLocksScreen_ {
    InfoScreen super;
    pid_t pid;
+   bool allProcesses;
 } ProcessLocksScreen;
 
 typedef struct FileLocks_Data_ {
@@ -27,22 +29,25 @@ typedef struct FileLocks_Data_ {
    char* readwrite;
    char* filename;
    int id;
+   pid_t pid;
    unsigned int dev[2];
    uint64_t inode;
    uint64_t start;
    uint64_t end;
 } FileLocks_Data;
 
-typedef struct FileLocks_LockData_ {
-   FileLocks_Data data;
-   struct FileLocks_LockData_* next;
-} FileLocks_LockData;
-
 typedef struct FileLocks_ProcessData_ {
    bool error;
-   struct FileLocks_LockData_* locks;
+   FileLocks_Data* locks;
+   size_t nLocks;
+   size_t capacity;
 } FileLocks_ProcessData;
 
+/* Appends a cleared lock, pointers into locks are invalidated */
+FileLocks_Data* FileLocks_ProcessData_add(FileLocks_ProcessData* this);
+
+void FileLocks_ProcessData_delete(FileLocks_ProcessData* this);
+
 extern const InfoScreenClass ProcessLocksScreen_class;
 
 ProcessLocksScreen* ProcessLocksScreen_new(const Process* process);
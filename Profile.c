@@ -0,0 +1,142 @@
+/*
+htop - Profile.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "Profile.h"
+
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+
+#include "Macros.h"
+
+
+bool Profile_enabled;
+
+ProfileTick Profile_current;
+
+static unsigned int Profile_users;
+static ProfileTick Profile_lastTick;
+static ProfileTick Profile_total;
+static ProfileTick Profile_max;
+static uint64_t Profile_ticks;
+
+static const char* const Profile_phaseNames[PROFILE_PHASES] = {
+   [PROFILE_SCAN] = "tarama",
+   [PROFILE_READ_STAT] = "  stat",
+   [PROFILE_READ_STATM] = "  statm",
+   [PROFILE_READ_CMDLINE] = "  cmdline",
+   [PROFILE_READ_SMAPS] = "  smaps",
+   [PROFILE_READ_IO] = "  io",
+   [PROFILE_READ_CGROUP] = "  cgroup",
+   [PROFILE_READ_STATUS] = "  status",
+   [PROFILE_READ_SOCKETS] = "  soketler",
+   [PROFILE_READ_SYSTEM] = "  sistem dosyaları",
+   [PROFILE_SORT] = "sıralama",
+   [PROFILE_REBUILD] = "panel oluşturma",
+   [PROFILE_HEADER_DRAW] = "başlık çizimi",
+   [PROFILE_PANEL_DRAW] = "panel çizimi",
+};
+
+static const char* const Profile_counterNames[PROFILE_COUNTERS] = {
+   [PROFILE_FILES_OPENED] = "açılan dosya",
+   [PROFILE_BYTES_READ] = "okunan bayt",
+   [PROFILE_ALLOCATIONS] = "bellek ayırma",
+   [PROFILE_FRAMES] = "çizilen kare",
+};
+
+uint64_t Profile_nowNs(void) {
+#if defined(HAVE_CLOCK_GETTIME)
+   struct timespec ts;
+   if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+      return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+#endif
+   struct timeval tv;
+   gettimeofday(&tv, NULL);
+   return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+
+void Profile_enable(void) {
+   Profile_users++;
+   Profile_enabled = true;
+}
+
+void Profile_disable(void) {
+   if (Profile_users > 0)
+      Profile_users--;
+   Profile_enabled = Profile_users > 0;
+}
+
+void Profile_tick(void) {
+   if (!Profile_enabled)
+      return;
+
+   for (int i = 0; i < PROFILE_PHASES; i++) {
+      Profile_total.phaseNs[i] += Profile_current.phaseNs[i];
+      Profile_max.phaseNs[i] = MAXIMUM(Profile_max.phaseNs[i], Profile_current.phaseNs[i]);
+   }
+   for (int i = 0; i < PROFILE_COUNTERS; i++) {
+      Profile_total.counters[i] += Profile_current.counters[i];
+      Profile_max.counters[i] = MAXIMUM(Profile_max.counters[i], Profile_current.counters[i]);
+   }
+   Profile_ticks++;
+
+   Profile_lastTick = Profile_current;
+   memset(&Profile_current, 0, sizeof(Profile_current));
+}
+
+const ProfileTick* Profile_last(void) {
+   return &Profile_lastTick;
+}
+
+const char* Profile_phaseName(ProfilePhase phase) {
+   return Profile_phaseNames[phase];
+}
+
+void Profile_report(FILE* out) {
+   // the tick still running counts as well if anything was measured in it
+   static const ProfileTick empty;
+   if (memcmp(&Profile_current, &empty, sizeof(empty)) != 0)
+      Profile_tick();
+
+   uint64_t ticks = MAXIMUM(Profile_ticks, 1);
+   fprintf(out, "htop profil raporu: %llu tık\n", (unsigned long long)Profile_ticks);
+   fprintf(out, "%12s %12s %12s  %s\n", "toplam ms", "ort. ms", "maks. ms", "aşama");
+   for (int i = 0; i < PROFILE_PHASES; i++) {
+      fprintf(out, "%12.3f %12.3f %12.3f  %s\n",
+              Profile_total.phaseNs[i] / 1e6,
+              Profile_total.phaseNs[i] / 1e6 / ticks,
+              Profile_max.phaseNs[i] / 1e6,
+              Profile_phaseNames[i]);
+   }
+   fprintf(out, "%12s %12s %12s  %s\n", "toplam", "ort.", "maks.", "sayaç");
+   for (int i = 0; i < PROFILE_COUNTERS; i++) {
+      fprintf(out, "%12llu %12.1f %12llu  %s\n",
+              (unsigned long long)Profile_total.counters[i],
+              (double)Profile_total.counters[i] / ticks,
+              (unsigned long long)Profile_max.counters[i],
+              Profile_counterNames[i]);
+   }
+}
+
+void Profile_sum(ProfileTick* sum) {
+   for (int i = 0; i < PROFILE_PHASES; i++)
+      sum->phaseNs[i] = Profile_total.phaseNs[i] + Profile_current.phaseNs[i];
+   for (int i = 0; i < PROFILE_COUNTERS; i++)
+      sum->counters[i] = Profile_total.counters[i] + Profile_current.counters[i];
+}
+
+int Profile_fclose(FILE* stream) {
+   if (Profile_enabled) {
+      Profile_current.counters[PROFILE_FILES_OPENED]++;
+      long pos = ftell(stream);
+      if (pos > 0)
+         Profile_current.counters[PROFILE_BYTES_READ] += (uint64_t)pos;
+   }
+   return fclose(stream);
+}
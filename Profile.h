@@ -0,0 +1,97 @@
+#ifndef HEADER_Profile
+#define HEADER_Profile
+/*
+htop - Profile.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+/*
+ * Accounting of where htop spends its own time.  Phases are timed with a
+ * monotonic clock and counters are summed per tick, where a tick starts
+ * with every process list scan.  Nothing is measured unless a user (the
+ * internals meter or --profile-report) has enabled it, so the disabled
+ * cost at every call site is the test of a single flag.
+ */
+
+typedef enum ProfilePhase_ {
+   PROFILE_SCAN,
+   PROFILE_READ_STAT,
+   PROFILE_READ_STATM,
+   PROFILE_READ_CMDLINE,
+   PROFILE_READ_SMAPS,
+   PROFILE_READ_IO,
+   PROFILE_READ_CGROUP,
+   PROFILE_READ_STATUS,
+   PROFILE_READ_SOCKETS,
+   PROFILE_READ_SYSTEM,
+   PROFILE_SORT,
+   PROFILE_REBUILD,
+   PROFILE_HEADER_DRAW,
+   PROFILE_PANEL_DRAW,
+   PROFILE_PHASES
+} ProfilePhase;
+
+typedef enum ProfileCounter_ {
+   PROFILE_FILES_OPENED,
+   PROFILE_BYTES_READ,
+   PROFILE_ALLOCATIONS,
+   PROFILE_FRAMES,
+   PROFILE_COUNTERS
+} ProfileCounter;
+
+typedef struct ProfileTick_ {
+   uint64_t phaseNs[PROFILE_PHASES];
+   uint64_t counters[PROFILE_COUNTERS];
+} ProfileTick;
+
+extern bool Profile_enabled;
+
+extern ProfileTick Profile_current;
+
+uint64_t Profile_nowNs(void);
+
+/* Starts measuring for one more user, measurements stop once all have disabled it */
+void Profile_enable(void);
+
+void Profile_disable(void);
+
+/* Ends the running tick and starts the next one */
+void Profile_tick(void);
+
+/* The last complete tick, zero before the first one ended */
+const ProfileTick* Profile_last(void);
+
+/* Writes totals, averages and maxima per tick of everything measured so far */
+void Profile_report(FILE* out);
+
+/* Everything measured so far, the running tick included */
+void Profile_sum(ProfileTick* sum);
+
+const char* Profile_phaseName(ProfilePhase phase);
+
+static inline uint64_t Profile_start(void) {
+   return Profile_enabled ? Profile_nowNs() : 0;
+}
+
+static inline void Profile_stop(ProfilePhase phase, uint64_t start) {
+   // a start of 0 was taken before measuring was enabled
+   if (Profile_enabled && start)
+      Profile_current.phaseNs[phase] += Profile_nowNs() - start;
+}
+
+static inline void Profile_count(ProfileCounter counter, uint64_t n) {
+   if (Profile_enabled)
+      Profile_current.counters[counter] += n;
+}
+
+/* fclose() for streams that were only read, accounting the open and the bytes consumed */
+int Profile_fclose(FILE* stream);
+
+#endif
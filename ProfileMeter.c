@@ -0,0 +1,100 @@
+/*
+htop - ProfileMeter.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "ProfileMeter.h"
+
+#include <stdint.h>
+
+#include "CRT.h"
+#include "Macros.h"
+#include "Meter.h"
+#include "Object.h"
+#include "Profile.h"
+#include "RichString.h"
+#include "XUtils.h"
+
+
+static const int ProfileMeter_attributes[] = {
+   METER_VALUE
+};
+
+static void ProfileMeter_init(ATTR_UNUSED Meter* this) {
+   Profile_enable();
+}
+
+static void ProfileMeter_done(ATTR_UNUSED Meter* this) {
+   Profile_disable();
+}
+
+static double ProfileMeter_drawMs(const ProfileTick* tick) {
+   return (tick->phaseNs[PROFILE_HEADER_DRAW] + tick->phaseNs[PROFILE_PANEL_DRAW]) / 1e6;
+}
+
+static void ProfileMeter_updateValues(Meter* this) {
+   const ProfileTick* tick = Profile_last();
+   this->values[0] = tick->phaseNs[PROFILE_SCAN] / 1e6;
+
+   char bytes[16];
+   Meter_humanUnit(bytes, (unsigned long int)(tick->counters[PROFILE_BYTES_READ] / 1024), sizeof(bytes));
+   xSnprintf(this->txtBuffer, sizeof(this->txtBuffer), "tarama %.1f ms, sıralama %.1f ms, çizim %.1f ms, %llu dosya, %s okundu, %llu ayırma",
+             tick->phaseNs[PROFILE_SCAN] / 1e6,
+             (tick->phaseNs[PROFILE_SORT] + tick->phaseNs[PROFILE_REBUILD]) / 1e6,
+             ProfileMeter_drawMs(tick),
+             (unsigned long long)tick->counters[PROFILE_FILES_OPENED],
+             bytes,
+             (unsigned long long)tick->counters[PROFILE_ALLOCATIONS]);
+}
+
+static void ProfileMeter_display(ATTR_UNUSED const Object* cast, RichString* out) {
+   const ProfileTick* tick = Profile_last();
+   char buffer[32];
+
+   xSnprintf(buffer, sizeof(buffer), "%.1f", tick->phaseNs[PROFILE_SCAN] / 1e6);
+   RichString_writeAscii(out, CRT_colors[METER_TEXT], "tarama ");
+   RichString_appendAscii(out, CRT_colors[METER_VALUE], buffer);
+
+   xSnprintf(buffer, sizeof(buffer), "%.1f", (tick->phaseNs[PROFILE_SORT] + tick->phaseNs[PROFILE_REBUILD]) / 1e6);
+   RichString_appendWide(out, CRT_colors[METER_TEXT], " ms, sıralama ");
+   RichString_appendAscii(out, CRT_colors[METER_VALUE], buffer);
+
+   xSnprintf(buffer, sizeof(buffer), "%.1f", ProfileMeter_drawMs(tick));
+   RichString_appendWide(out, CRT_colors[METER_TEXT], " ms, çizim ");
+   RichString_appendAscii(out, CRT_colors[METER_VALUE], buffer);
+
+   xSnprintf(buffer, sizeof(buffer), "%llu", (unsigned long long)tick->counters[PROFILE_FILES_OPENED]);
+   RichString_appendAscii(out, CRT_colors[METER_TEXT], " ms, ");
+   RichString_appendAscii(out, CRT_colors[METER_VALUE], buffer);
+
+   Meter_humanUnit(buffer, (unsigned long int)(tick->counters[PROFILE_BYTES_READ] / 1024), sizeof(buffer));
+   RichString_appendAscii(out, CRT_colors[METER_TEXT], " dosya, ");
+   RichString_appendAscii(out, CRT_colors[METER_VALUE], buffer);
+
+   xSnprintf(buffer, sizeof(buffer), "%llu", (unsigned long long)tick->counters[PROFILE_ALLOCATIONS]);
+   RichString_appendAscii(out, CRT_colors[METER_TEXT], " okundu, ");
+   RichString_appendAscii(out, CRT_colors[METER_VALUE], buffer);
+   RichString_appendWide(out, CRT_colors[METER_TEXT], " ayırma");
+}
+
+const MeterClass ProfileMeter_class = {
+   .super = {
+      .extends = Class(Meter),
+      .delete = Meter_delete,
+      .display = ProfileMeter_display,
+   },
+   .updateValues = ProfileMeter_updateValues,
+   .defaultMode = TEXT_METERMODE,
+   .supportedModes = (1 << TEXT_METERMODE),
+   .maxItems = 1,
+   .total = 100.0,
+   .attributes = ProfileMeter_attributes,
+   .name = "Profile",
+   .uiName = "htop iç işleyişi",
+   .caption = "htop: ",
+   .description = "htop'un tarama, sıralama ve çizim süreleri, dosya ve bellek sayaçları",
+   .init = ProfileMeter_init,
+   .done = ProfileMeter_done,
+};
@@ -0,0 +1,14 @@
+#ifndef HEADER_ProfileMeter
+#define HEADER_ProfileMeter
+/*
+htop - ProfileMeter.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "Meter.h"
+
+extern const MeterClass ProfileMeter_class;
+
+#endif
@@ -0,0 +1,155 @@
+/*
+htop - Recorder.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "Recorder.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "XUtils.h"
+
+
+void Recorder_writeHeader(SnapshotBuffer* out) {
+   SnapshotBuffer layout;
+   SnapshotBuffer_init(&layout);
+   Snapshot_writeLayout(&layout);
+
+   uint8_t fixed[RECORDING_MAGIC_LEN + 8];
+   memcpy(fixed, RECORDING_MAGIC, RECORDING_MAGIC_LEN);
+   for (int i = 0; i < 4; i++) {
+      fixed[RECORDING_MAGIC_LEN + i] = (uint8_t)(RECORDING_VERSION >> (8 * i));
+      fixed[RECORDING_MAGIC_LEN + 4 + i] = (uint8_t)(layout.size >> (8 * i));
+   }
+   SnapshotBuffer_append(out, fixed, sizeof(fixed));
+   SnapshotBuffer_append(out, layout.data, layout.size);
+   SnapshotBuffer_done(&layout);
+}
+
+/* Returns the end of the last complete frame of an existing recording
+ * written with the same layout, or -1 */
+static off_t Recorder_validEnd(int fd, const SnapshotBuffer* header, off_t size) {
+   if (size < (off_t)header->size)
+      return -1;
+
+   uint8_t* existing = xMalloc(header->size);
+   bool same = pread(fd, existing, header->size, 0) == (ssize_t)header->size && memcmp(existing, header->data, header->size) == 0;
+   free(existing);
+   if (!same)
+      return -1;
+
+   off_t offset = header->size;
+   uint8_t frame[SNAPSHOT_FRAME_HEADER_SIZE];
+   while (pread(fd, frame, sizeof(frame), offset) == (ssize_t)sizeof(frame)) {
+      uint32_t len, flags;
+      uint64_t realtimeMs;
+      Snapshot_getFrameHeader(frame, &len, &flags, &realtimeMs);
+      if (offset + (off_t)sizeof(frame) + (off_t)len > size)
+         break;
+      offset += sizeof(frame) + len;
+   }
+   return offset;
+}
+
+Recorder* Recorder_new(const char* path) {
+   int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+   if (fd < 0)
+      return NULL;
+
+   SnapshotBuffer header;
+   SnapshotBuffer_init(&header);
+   Recorder_writeHeader(&header);
+
+   struct stat sb;
+   off_t end = -1;
+   if (fstat(fd, &sb) == 0) {
+      if (sb.st_size == 0) {
+         if (full_write(fd, header.data, header.size) == (ssize_t)header.size)
+            end = header.size;
+      } else {
+         // continue an earlier recording, dropping a frame cut short by a crash
+         end = Recorder_validEnd(fd, &header, sb.st_size);
+         if (end < 0)
+            errno = EINVAL;
+         else if (ftruncate(fd, end) < 0 || lseek(fd, end, SEEK_SET) < 0)
+            end = -1;
+      }
+   }
+   SnapshotBuffer_done(&header);
+
+   if (end < 0) {
+      int err = errno;
+      close(fd);
+      errno = err;
+      return NULL;
+   }
+
+   Recorder* this = xCalloc(1, sizeof(Recorder));
+   this->fd = fd;
+   this->end = end;
+   this->current = Snapshot_new();
+   this->previous = Snapshot_new();
+   SnapshotBuffer_init(&this->buffer);
+   return this;
+}
+
+void Recorder_delete(Recorder* this) {
+   if (!this)
+      return;
+
+   if (this->fd >= 0)
+      close(this->fd);
+   Snapshot_delete(this->current);
+   Snapshot_delete(this->previous);
+   SnapshotBuffer_done(&this->buffer);
+   free(this);
+}
+
+void Recorder_append(Recorder* this, const ProcessList* pl, const Header* header) {
+   if (this->fd < 0)
+      return;
+
+   bool keyframe = this->frames % RECORDING_KEYFRAME_INTERVAL == 0;
+   Snapshot_capture(this->current, this->previous, pl, header);
+
+   static const uint8_t placeholder[SNAPSHOT_FRAME_HEADER_SIZE];
+   SnapshotBuffer_reset(&this->buffer);
+   SnapshotBuffer_append(&this->buffer, placeholder, sizeof(placeholder));
+   Snapshot_encode(this->current, keyframe ? NULL : this->previous, &this->buffer);
+   Snapshot_putFrameHeader(this->buffer.data, this->buffer.size - SNAPSHOT_FRAME_HEADER_SIZE, keyframe ? SNAPSHOT_FRAME_KEY : 0, this->current->realtimeMs);
+
+   errno = 0;
+   if (full_write(this->fd, this->buffer.data, this->buffer.size) != (ssize_t)this->buffer.size) {
+      this->error = errno ? errno : EIO;
+      if (ftruncate(this->fd, this->end) < 0) {
+         // the next run drops the partial frame when it continues the recording
+      }
+      close(this->fd);
+      this->fd = -1;
+      return;
+   }
+   this->end += this->buffer.size;
+
+   Snapshot* t = this->previous;
+   this->previous = this->current;
+   this->current = t;
+   this->frames++;
+}
+
+bool Recorder_status(const Recorder* this, char* buffer, size_t size) {
+   if (!this->error)
+      return false;
+
+   xSnprintf(buffer, size, "KAYIT DURDU: %s", strerror(this->error));
+   return true;
+}
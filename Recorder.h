@@ -0,0 +1,56 @@
+#ifndef HEADER_Recorder
+#define HEADER_Recorder
+/*
+htop - Recorder.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "Header.h"
+#include "ProcessList.h"
+#include "Snapshot.h"
+
+
+/*
+ * A recording is a file header (magic, version, length of the field
+ * layout and the layout itself) followed by frames, each a 16 byte frame
+ * header (payload size, flags, wall clock time in ms) and an encoded
+ * snapshot.  Every RECORDING_KEYFRAME_INTERVAL-th frame is a keyframe
+ * that decodes on its own, all others are deltas to their predecessor.
+ */
+#define RECORDING_MAGIC "htoprec\n"
+#define RECORDING_MAGIC_LEN 8
+#define RECORDING_VERSION 1
+#define RECORDING_KEYFRAME_INTERVAL 64
+
+typedef struct Recorder_ {
+   int fd;
+   off_t end;     /* of the last complete frame */
+   int error;     /* errno of the write that stopped the recording */
+   Snapshot* current;
+   Snapshot* previous;
+   unsigned int frames;
+   SnapshotBuffer buffer;
+} Recorder;
+
+/* Appends the file header of a recording, which also starts an agent stream */
+void Recorder_writeHeader(SnapshotBuffer* out);
+
+/* Opens (or continues) a recording, returns NULL with errno set on failure */
+Recorder* Recorder_new(const char* path);
+
+void Recorder_delete(Recorder* this);
+
+/* Appends the current scan; stops recording on a write error, dropping the
+ * frame it cut short */
+void Recorder_append(Recorder* this, const ProcessList* pl, const Header* header);
+
+/* Describes why the recording stopped, returns false while it goes on */
+bool Recorder_status(const Recorder* this, char* buffer, size_t size);
+
+#endif
@@ -0,0 +1,251 @@
+/*
+htop - Replay.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "Replay.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Macros.h"
+#include "Platform.h"
+#include "Recorder.h"
+#include "XUtils.h"
+
+
+#define REPLAY_MAX_SPEED 64
+
+ssize_t Replay_parseHeader(const uint8_t* data, size_t size, SnapshotCodec* codec) {
+   const size_t fixed = RECORDING_MAGIC_LEN + 8;
+   if (memcmp(data, RECORDING_MAGIC, MINIMUM(size, (size_t)RECORDING_MAGIC_LEN)) != 0)
+      return -1;
+   if (size < fixed)
+      return 0;
+
+   uint32_t version = 0;
+   uint32_t layoutLen = 0;
+   for (int i = 0; i < 4; i++) {
+      version |= (uint32_t)data[RECORDING_MAGIC_LEN + i] << (8 * i);
+      layoutLen |= (uint32_t)data[RECORDING_MAGIC_LEN + 4 + i] << (8 * i);
+   }
+   if (version != RECORDING_VERSION)
+      return -1;
+   if (layoutLen > size - fixed)
+      return 0;
+   if (!SnapshotCodec_init(codec, data + fixed, layoutLen))
+      return -1;
+   return fixed + layoutLen;
+}
+
+static bool Replay_index(Replay* this) {
+   ssize_t headerLen = Replay_parseHeader(this->data, this->size, &this->codec);
+   if (headerLen <= 0)
+      return false;
+
+   // only the frame headers are read here, a cut off last frame is ignored
+   unsigned int framesCapacity = 0;
+   unsigned int keyframesCapacity = 0;
+   size_t offset = headerLen;
+   while (this->size - offset >= SNAPSHOT_FRAME_HEADER_SIZE) {
+      uint32_t len, flags;
+      uint64_t realtimeMs;
+      Snapshot_getFrameHeader(this->data + offset, &len, &flags, &realtimeMs);
+      offset += SNAPSHOT_FRAME_HEADER_SIZE;
+      if (len > this->size - offset)
+         break;
+
+      if (this->nFrames == framesCapacity) {
+         framesCapacity = MAXIMUM(framesCapacity * 2, 256U);
+         this->frames = xReallocArray(this->frames, framesCapacity, sizeof(ReplayFrame));
+      }
+      bool keyframe = flags & SNAPSHOT_FRAME_KEY;
+      this->frames[this->nFrames] = (ReplayFrame) {
+         .offset = offset,
+         .size = len,
+         .keyframe = keyframe,
+         .realtimeMs = realtimeMs,
+      };
+
+      if (keyframe) {
+         if (this->nKeyframes == keyframesCapacity) {
+            keyframesCapacity = MAXIMUM(keyframesCapacity * 2, 64U);
+            this->keyframes = xReallocArray(this->keyframes, keyframesCapacity, sizeof(unsigned int));
+         }
+         this->keyframes[this->nKeyframes++] = this->nFrames;
+      }
+
+      this->nFrames++;
+      offset += len;
+   }
+
+   return this->nKeyframes > 0;
+}
+
+static bool Replay_decode(Replay* this, unsigned int index) {
+   const ReplayFrame* frame = &this->frames[index];
+   if (!frame->keyframe && this->position + 1 != index)
+      return false;
+
+   if (!Snapshot_decode(this->previous, frame->keyframe ? NULL : this->current, &this->codec, this->data + frame->offset, frame->size))
+      return false;
+   this->previous->realtimeMs = frame->realtimeMs;
+
+   Snapshot* t = this->current;
+   this->current = this->previous;
+   this->previous = t;
+   this->position = index;
+   return true;
+}
+
+/* Decodes the given frame, starting from the closest keyframe before it
+ * unless it is a short way ahead of the current one */
+static bool Replay_load(Replay* this, unsigned int target) {
+   if (target == this->position)
+      return true;
+
+   unsigned int from;
+   if (target > this->position && target - this->position <= RECORDING_KEYFRAME_INTERVAL) {
+      from = this->position + 1;
+   } else {
+      unsigned int l = 0;
+      unsigned int r = this->nKeyframes;
+      while (r - l > 1) {
+         unsigned int c = l + (r - l) / 2;
+         if (this->keyframes[c] <= target)
+            l = c;
+         else
+            r = c;
+      }
+      from = this->keyframes[l];
+      target = MAXIMUM(target, from);
+   }
+
+   for (unsigned int i = from; i <= target; i++) {
+      if (!Replay_decode(this, i))
+         return false;
+   }
+   return true;
+}
+
+/* Last frame taken at or before the given time */
+static unsigned int Replay_frameAt(const Replay* this, uint64_t realtimeMs) {
+   unsigned int l = 0;
+   unsigned int r = this->nFrames;
+   while (r - l > 1) {
+      unsigned int c = l + (r - l) / 2;
+      if (this->frames[c].realtimeMs <= realtimeMs)
+         l = c;
+      else
+         r = c;
+   }
+   return l;
+}
+
+Replay* Replay_new(const char* path) {
+   int fd = open(path, O_RDONLY | O_CLOEXEC);
+   if (fd < 0)
+      return NULL;
+
+   struct stat sb;
+   int err = 0;
+   if (fstat(fd, &sb) < 0)
+      err = errno;
+   else if (!S_ISREG(sb.st_mode) || sb.st_size == 0)
+      err = EINVAL;
+   if (err) {
+      close(fd);
+      errno = err;
+      return NULL;
+   }
+
+   void* map = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   err = errno;
+   close(fd);
+   if (map == MAP_FAILED) {
+      errno = err;
+      return NULL;
+   }
+
+   Replay* this = xCalloc(1, sizeof(Replay));
+   this->data = map;
+   this->size = sb.st_size;
+   this->current = Snapshot_new();
+   this->previous = Snapshot_new();
+   this->speed = 1;
+
+   if (!Replay_index(this) || !Replay_decode(this, this->keyframes[0])) {
+      Replay_delete(this);
+      errno = EINVAL;
+      return NULL;
+   }
+
+   this->clockMs = this->frames[this->position].realtimeMs;
+   return this;
+}
+
+void Replay_delete(Replay* this) {
+   if (!this)
+      return;
+
+   munmap(this->data, this->size);
+   free(this->frames);
+   free(this->keyframes);
+   Snapshot_delete(this->current);
+   Snapshot_delete(this->previous);
+   free(this);
+}
+
+static void Replay_setClock(Replay* this, uint64_t clockMs) {
+   uint64_t first = this->frames[this->keyframes[0]].realtimeMs;
+   uint64_t last = this->frames[this->nFrames - 1].realtimeMs;
+   this->clockMs = CLAMP(clockMs, first, last);
+}
+
+void Replay_advance(Replay* this, ProcessList* pl, bool paused) {
+   uint64_t now;
+   Platform_gettime_monotonic(&now);
+   if (!paused && this->lastMonotonicMs && now > this->lastMonotonicMs)
+      Replay_setClock(this, this->clockMs + (now - this->lastMonotonicMs) * this->speed);
+   this->lastMonotonicMs = now;
+
+   Replay_load(this, Replay_frameAt(this, this->clockMs));
+   pl->snapshot = this->current;
+}
+
+void Replay_seek(Replay* this, int64_t deltaMs) {
+   if (deltaMs < 0 && (uint64_t)-deltaMs > this->clockMs)
+      Replay_setClock(this, 0);
+   else
+      Replay_setClock(this, this->clockMs + deltaMs);
+}
+
+void Replay_step(Replay* this, int frames) {
+   int64_t target = (int64_t)this->position + frames;
+   target = CLAMP(target, (int64_t)this->keyframes[0], (int64_t)this->nFrames - 1);
+   Replay_setClock(this, this->frames[target].realtimeMs);
+}
+
+void Replay_cycleSpeed(Replay* this) {
+   this->speed = this->speed >= REPLAY_MAX_SPEED ? 1 : this->speed * 2;
+}
+
+void Replay_status(const Replay* this, char* buffer, size_t size) {
+   time_t t = this->frames[this->position].realtimeMs / 1000;
+   struct tm tm;
+   char when[32];
+   if (!localtime_r(&t, &tm) || !strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tm))
+      String_safeStrncpy(when, "?", sizeof(when));
+
+   xSnprintf(buffer, size, "OYNATMA %s x%u [%u/%u]", when, this->speed, this->position + 1, this->nFrames);
+}
@@ -0,0 +1,65 @@
+#ifndef HEADER_Replay
+#define HEADER_Replay
+/*
+htop - Replay.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "ProcessList.h"
+#include "Snapshot.h"
+
+
+typedef struct ReplayFrame_ {
+   size_t offset;          /* of the payload in the mapping */
+   uint32_t size;
+   bool keyframe;
+   uint64_t realtimeMs;
+} ReplayFrame;
+
+typedef struct Replay_ {
+   uint8_t* data;             /* read-only mapping of the recording */
+   size_t size;
+   SnapshotCodec codec;
+
+   ReplayFrame* frames;
+   unsigned int nFrames;
+   unsigned int* keyframes;   /* indices into frames */
+   unsigned int nKeyframes;
+
+   Snapshot* current;         /* decoded frames[position] */
+   Snapshot* previous;
+   unsigned int position;
+
+   uint64_t clockMs;          /* playback position in recording time */
+   uint64_t lastMonotonicMs;
+   unsigned int speed;
+} Replay;
+
+/* Reads the file header of a recording or agent stream, returns its length,
+ * 0 if more data is needed or -1 if it is not a stream this build can read */
+ssize_t Replay_parseHeader(const uint8_t* data, size_t size, SnapshotCodec* codec);
+
+/* Maps a recording, returns NULL with errno set on failure */
+Replay* Replay_new(const char* path);
+
+void Replay_delete(Replay* this);
+
+/* Moves playback along with the wall clock and points pl at the frame to show */
+void Replay_advance(Replay* this, ProcessList* pl, bool paused);
+
+void Replay_seek(Replay* this, int64_t deltaMs);
+
+void Replay_step(Replay* this, int frames);
+
+void Replay_cycleSpeed(Replay* this);
+
+void Replay_status(const Replay* this, char* buffer, size_t size);
+
+#endif
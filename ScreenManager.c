@@ -13,11 +13,17 @@ in the source distribution for its full text.
 #include <sys/time.h>
 
 #include "CRT.h"
+#include "Cluster.h"
 #include "FunctionBar.h"
+#include "History.h"
 #include "Object.h"
 #include "Platform.h"
 #include "ProcessList.h"
+#include "Profile.h"
 #include "ProvideCurses.h"
+#include "Recorder.h"
+#include "Replay.h"
+#include "SharedScan.h"
 #include "XUtils.h"
 
 
@@ -105,11 +111,27 @@ static void checkRecalculation(ScreenManager* this, double* oldTime, int* sortTi
 
    if (*rescan) {
       *oldTime = newTime;
+      if (this->state->replay)
+         Replay_advance(this->state->replay, pl, this->state->pauseProcessUpdate);
+      else if (this->state->shared)
+         SharedScan_advance(this->state->shared, pl, this->state->pauseProcessUpdate);
+      else if (this->state->cluster)
+         Cluster_advance(this->state->cluster, pl, this->state->pauseProcessUpdate);
+      else if (this->state->history)
+         pl->snapshot = History_frame(this->state->history);
+      // a recorded frame is shown while paused as well, only live updates stop
+      bool pauseUpdate = this->state->pauseProcessUpdate && !pl->snapshot;
       // scan processes first - some header values are calculated there
-      ProcessList_scan(pl, this->state->pauseProcessUpdate);
+      ProcessList_scan(pl, pauseUpdate);
       // always update header, especially to avoid gaps in graph meters
       Header_updateData(this->header);
-      if (!this->state->pauseProcessUpdate && (*sortTimeout == 0 || this->settings->treeView)) {
+      if (!pauseUpdate && !pl->snapshot) {
+         if (this->state->recorder)
+            Recorder_append(this->state->recorder, pl, this->header);
+         if (this->state->history)
+            History_append(this->state->history, pl, this->header, (size_t)this->settings->historyMemoryMB * ONE_K * ONE_K);
+      }
+      if (!pauseUpdate && (*sortTimeout == 0 || this->settings->treeView)) {
          ProcessList_sort(pl);
          *sortTimeout = 1;
       }
@@ -133,6 +155,7 @@ static void ScreenManager_drawPanels(ScreenManager* this, int focus, bool force_
                  State_hideFunctionBar(this->state));
       mvvline(panel->y, panel->x + panel->w, ' ', panel->h + (State_hideFunctionBar(this->state) ? 1 : 0));
    }
+   Profile_count(PROFILE_FRAMES, 1);
 }
 
 void ScreenManager_run(ScreenManager* this, Panel** lastFocus, int* lastKey) {
@@ -255,7 +278,8 @@ void ScreenManager_run(ScreenManager* this, Panel** lastFocus, int* lastKey) {
       switch (ch) {
       case KEY_RESIZE:
       {
-         ScreenManager_resize(this, this->x1, this->y1, this->x2, this->y2);
+         // the header may have been hidden or changed its height meanwhile
+         ScreenManager_resize(this, this->x1, this->header->height, this->x2, this->y2);
          continue;
       }
       case KEY_LEFT:
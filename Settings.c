@@ -26,6 +26,7 @@ void Settings_delete(Settings* this) {
    for (unsigned int i = 0; i < ARRAYSIZE(this->columns); i++) {
       String_freeArray(this->columns[i].names);
       free(this->columns[i].modes);
+      free(this->columns[i].intervals);
    }
    free(this);
 }
@@ -54,6 +55,24 @@ static void Settings_readMeterModes(Settings* this, const char* line, int column
    this->columns[column].modes = modes;
 }
 
+static void Settings_readMeterIntervals(Settings* this, const char* line, int column) {
+   char* trim = String_trim(line);
+   char** ids = String_split(trim, ' ', NULL);
+   free(trim);
+   int len = 0;
+   for (int i = 0; ids[i]; i++) {
+      len++;
+   }
+   free(this->columns[column].intervals);
+   this->columns[column].intervalsLen = len;
+   int* intervals = len ? xCalloc(len, sizeof(int)) : NULL;
+   for (int i = 0; i < len; i++) {
+      intervals[i] = CLAMP(atoi(ids[i]), -1, 36000);
+   }
+   String_freeArray(ids);
+   this->columns[column].intervals = intervals;
+}
+
 static void Settings_defaultMeters(Settings* this, unsigned int initialCpuCount) {
    int sizes[] = { 3, 3 };
    if (initialCpuCount > 4 && initialCpuCount <= 128) {
@@ -236,8 +255,18 @@ static bool Settings_read(Settings* this, const char* fileName, unsigned int ini
       } else if (String_eq(option[0], "right_meter_modes")) {
          Settings_readMeterModes(this, option[1], 1);
          didReadMeters = true;
+      } else if (String_eq(option[0], "left_meter_intervals")) {
+         Settings_readMeterIntervals(this, option[1], 0);
+      } else if (String_eq(option[0], "right_meter_intervals")) {
+         Settings_readMeterIntervals(this, option[1], 1);
       } else if (String_eq(option[0], "hide_function_bar")) {
          this->hideFunctionBar = atoi(option[1]);
+      } else if (String_eq(option[0], "graph_history_hours")) {
+         this->graphHistoryHours = CLAMP(atoi(option[1]), 0, 48);
+      } else if (String_eq(option[0], "graph_history_persist")) {
+         this->graphHistoryPersist = !!atoi(option[1]);
+      } else if (String_eq(option[0], "history_memory_mb")) {
+         this->historyMemoryMB = CLAMP(atoi(option[1]), 0, 1024);
       #ifdef HAVE_LIBHWLOC
       } else if (String_eq(option[0], "topology_affinity")) {
          this->topologyAffinity = !!atoi(option[1]);
@@ -281,6 +310,15 @@ static void writeMeterModes(const Settings* this, FILE* fd, int column) {
    fprintf(fd, "\n");
 }
 
+static void writeMeterIntervals(const Settings* this, FILE* fd, int column) {
+   const char* sep = "";
+   for (int i = 0; i < this->columns[column].intervalsLen; i++) {
+      fprintf(fd, "%s%d", sep, this->columns[column].intervals[i]);
+      sep = " ";
+   }
+   fprintf(fd, "\n");
+}
+
 int Settings_write(const Settings* this) {
    FILE* fd = fopen(this->filename, "w");
    if (fd == NULL)
@@ -328,7 +366,12 @@ int Settings_write(const Settings* this) {
    fprintf(fd, "left_meter_modes="); writeMeterModes(this, fd, 0);
    fprintf(fd, "right_meters="); writeMeters(this, fd, 1);
    fprintf(fd, "right_meter_modes="); writeMeterModes(this, fd, 1);
+   fprintf(fd, "left_meter_intervals="); writeMeterIntervals(this, fd, 0);
+   fprintf(fd, "right_meter_intervals="); writeMeterIntervals(this, fd, 1);
    fprintf(fd, "hide_function_bar=%d\n", (int) this->hideFunctionBar);
+   fprintf(fd, "graph_history_hours=%d\n", (int) this->graphHistoryHours);
+   fprintf(fd, "graph_history_persist=%d\n", (int) this->graphHistoryPersist);
+   fprintf(fd, "history_memory_mb=%d\n", (int) this->historyMemoryMB);
    #ifdef HAVE_LIBHWLOC
    fprintf(fd, "topology_affinity=%d\n", (int) this->topologyAffinity);
    #endif
@@ -376,6 +419,9 @@ Settings* Settings_new(unsigned int initialCpuCount) {
    this->stripExeFromCmdline = true;
    this->showMergedCommand = false;
    this->hideFunctionBar = 0;
+   this->graphHistoryHours = DEFAULT_GRAPH_HISTORY_HOURS;
+   this->graphHistoryPersist = false;
+   this->historyMemoryMB = DEFAULT_HISTORY_MEMORY_MB;
    #ifdef HAVE_LIBHWLOC
    this->topologyAffinity = false;
    #endif
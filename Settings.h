@@ -16,11 +16,15 @@ in the source distribution for its full text.
 
 
 #define DEFAULT_DELAY 15
+#define DEFAULT_GRAPH_HISTORY_HOURS 1
+#define DEFAULT_HISTORY_MEMORY_MB 0
 
 typedef struct {
    int len;
    char** names;
    int* modes;
+   int intervalsLen;
+   int* intervals;            /* per meter refresh period, -1 for the meter's default */
 } MeterColumnSettings;
 
 typedef struct Settings_ {
@@ -66,6 +70,9 @@ typedef struct Settings_ {
    bool headerMargin;
    bool enableMouse;
    int hideFunctionBar;  // 0 - off, 1 - on ESC until next input, 2 - permanently
+   int graphHistoryHours;
+   bool graphHistoryPersist;
+   int historyMemoryMB;
    #ifdef HAVE_LIBHWLOC
    bool topologyAffinity;
    #endif
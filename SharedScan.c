@@ -0,0 +1,479 @@
+/*
+htop - SharedScan.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "SharedScan.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "CRT.h"
+#include "Macros.h"
+#include "Platform.h"
+#include "XUtils.h"
+
+
+#define SHARED_SCAN_READ_ATTEMPTS 4
+#define SHARED_SCAN_RECHECK_MS 2000
+
+static volatile sig_atomic_t SharedScan_stopped;
+
+static void SharedScan_stop(ATTR_UNUSED int sgn) {
+   SharedScan_stopped = 1;
+}
+
+static size_t SharedScan_dataOffset(uint32_t layoutSize) {
+   return (sizeof(SharedScanSegment) + layoutSize + 63) & ~(size_t)63;
+}
+
+static size_t SharedScan_slotOffset(const SharedScanSegment* segment, uint64_t slotCapacity, unsigned int slot) {
+   return SharedScan_dataOffset(segment->layoutSize) + slot * slotCapacity;
+}
+
+/* Segment names are a slash followed by a name without further slashes */
+static char* SharedScan_name(const char* name) {
+   if (!name || !*name)
+      name = SHARED_SCAN_DEFAULT_NAME;
+   if (strchr(name + 1, '/')) {
+      errno = EINVAL;
+      return NULL;
+   }
+
+   char* result;
+   xAsprintf(&result, "%s%s", name[0] == '/' ? "" : "/", name);
+   return result;
+}
+
+static bool SharedScan_isAlive(pid_t pid) {
+   return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+static SharedScan* SharedScan_alloc(char* name) {
+   SharedScan* this = xCalloc(1, sizeof(SharedScan));
+   this->name = name;
+   this->fd = -1;
+   SnapshotBuffer_init(&this->buffer);
+   return this;
+}
+
+static bool SharedScan_inGroup(gid_t gid) {
+   if (gid == getegid())
+      return true;
+
+   int n = getgroups(0, NULL);
+   if (n <= 0)
+      return false;
+
+   gid_t* groups = xCalloc(n, sizeof(gid_t));
+   n = getgroups(n, groups);
+   bool found = false;
+   for (int i = 0; i < n && !found; i++)
+      found = groups[i] == gid;
+   free(groups);
+   return found;
+}
+
+/* Segments of this user or root are trusted, and those a collector shared
+ * with one of this user's groups (see SharedScan_create); in either case
+ * nobody else may write to them */
+static bool SharedScan_isTrusted(const struct stat* sb) {
+   if (sb->st_mode & (S_IWGRP | S_IWOTH))
+      return false;
+   if (sb->st_uid == geteuid() || sb->st_uid == 0)
+      return true;
+   return (sb->st_mode & 0777) == 0640 && SharedScan_inGroup(sb->st_gid);
+}
+
+/* Validates and maps the segment currently behind the name, unless it is the one already mapped */
+static bool SharedScan_map(SharedScan* this) {
+   int fd = shm_open(this->name, O_RDONLY, 0);
+   if (fd < 0)
+      return false;
+
+   struct stat sb;
+   int err = 0;
+   if (fstat(fd, &sb) < 0)
+      err = errno;
+   else if (!SharedScan_isTrusted(&sb))
+      err = EPERM;
+   else if (this->segment && sb.st_ino == this->inode && (size_t)sb.st_size <= this->mapSize)
+      err = EEXIST;
+   else if (sb.st_size < (off_t)sizeof(SharedScanSegment))
+      err = EINVAL;
+   if (err) {
+      close(fd);
+      errno = err;
+      return false;
+   }
+
+   void* map = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   err = errno;
+   close(fd);
+   if (map == MAP_FAILED) {
+      errno = err;
+      return false;
+   }
+
+   const SharedScanSegment* segment = map;
+   SnapshotCodec codec;
+   bool valid = memcmp(segment->magic, SHARED_SCAN_MAGIC, sizeof(segment->magic)) == 0
+             && segment->version == SHARED_SCAN_VERSION
+             && segment->layoutSize <= (size_t)sb.st_size
+             && SharedScan_dataOffset(segment->layoutSize) + 2 * segment->slotCapacity <= (uint64_t)sb.st_size
+             && SnapshotCodec_init(&codec, (const uint8_t*)(segment + 1), segment->layoutSize);
+   if (!valid) {
+      munmap(map, sb.st_size);
+      errno = EINVAL;
+      return false;
+   }
+
+   // the same segment grown by its collector still holds the shown scan
+   if (sb.st_ino != this->inode)
+      this->generation = 0;
+   if (this->segment)
+      munmap(this->segment, this->mapSize);
+   this->segment = map;
+   this->mapSize = sb.st_size;
+   this->inode = sb.st_ino;
+   this->codec = codec;
+   return true;
+}
+
+SharedScan* SharedScan_create(const char* name, gid_t group) {
+   char* path = SharedScan_name(name);
+   if (!path)
+      return NULL;
+
+   SnapshotBuffer layout;
+   SnapshotBuffer_init(&layout);
+   Snapshot_writeLayout(&layout);
+   size_t mapSize = SharedScan_dataOffset(layout.size) + 2 * (size_t)SHARED_SCAN_INITIAL_SLOT_CAPACITY;
+
+   int fd = shm_open(path, O_RDWR | O_CREAT | O_EXCL, 0600);
+   if (fd < 0 && errno == EEXIST) {
+      // a segment left behind by a collector that is gone is replaced, as is one of
+      // ours that is no segment of this version; those of other users are left alone
+      SharedScan* other = SharedScan_alloc(xStrdup(path));
+      bool mapped = SharedScan_map(other);
+      int mapErr = errno;
+      bool stale = mapped ? !SharedScan_isAlive(other->segment->collector) : mapErr == EINVAL;
+      SharedScan_delete(other);
+      if (stale && shm_unlink(path) == 0)
+         fd = shm_open(path, O_RDWR | O_CREAT | O_EXCL, 0600);
+      else
+         errno = mapped || mapErr == EINVAL ? EEXIST : mapErr;
+   }
+
+   // the group is set before the mode lets it read anything
+   bool shared = group != (gid_t)-1;
+   if (fd >= 0 && shared && (fchown(fd, (uid_t)-1, group) < 0 || fchmod(fd, 0640) < 0)) {
+      int err = errno;
+      close(fd);
+      shm_unlink(path);
+      fd = -1;
+      errno = err;
+   }
+
+   struct stat sb;
+   void* map = MAP_FAILED;
+   if (fd >= 0 && ftruncate(fd, mapSize) == 0 && fstat(fd, &sb) == 0)
+      map = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   int err = errno;
+   if (map == MAP_FAILED) {
+      if (fd >= 0)
+         close(fd);
+      if (fd >= 0)
+         shm_unlink(path);
+      SnapshotBuffer_done(&layout);
+      free(path);
+      errno = err;
+      return NULL;
+   }
+
+   SharedScan* this = SharedScan_alloc(path);
+   this->owner = true;
+   this->shared = shared;
+   this->fd = fd;
+   this->segment = map;
+   this->mapSize = mapSize;
+   this->inode = sb.st_ino;
+   this->current = Snapshot_new();
+   this->previous = Snapshot_new();
+
+   SharedScanSegment* segment = this->segment;
+   segment->version = SHARED_SCAN_VERSION;
+   segment->layoutSize = layout.size;
+   segment->slotCapacity = SHARED_SCAN_INITIAL_SLOT_CAPACITY;
+   segment->collector = getpid();
+   memcpy(segment + 1, layout.data, layout.size);
+   SnapshotBuffer_done(&layout);
+
+   // viewers only look at a segment once the magic says it is complete
+   __atomic_thread_fence(__ATOMIC_RELEASE);
+   memcpy(segment->magic, SHARED_SCAN_MAGIC, sizeof(segment->magic));
+   return this;
+}
+
+SharedScan* SharedScan_attach(const char* name) {
+   char* path = SharedScan_name(name);
+   if (!path)
+      return NULL;
+
+   SharedScan* this = SharedScan_alloc(path);
+   if (!SharedScan_map(this)) {
+      int err = errno;
+      SharedScan_delete(this);
+      errno = err;
+      return NULL;
+   }
+
+   this->view = Snapshot_new();
+   this->scratch = Snapshot_new();
+   return this;
+}
+
+void SharedScan_delete(SharedScan* this) {
+   if (!this)
+      return;
+
+   if (this->segment) {
+      if (this->owner)
+         shm_unlink(this->name);
+      munmap(this->segment, this->mapSize);
+   }
+   if (this->fd >= 0)
+      close(this->fd);
+   Snapshot_delete(this->current);
+   Snapshot_delete(this->previous);
+   Snapshot_delete(this->view);
+   Snapshot_delete(this->scratch);
+   SnapshotBuffer_done(&this->buffer);
+   free(this->copy);
+   free(this->name);
+   free(this);
+}
+
+/* Doubles the slots until a scan of size bytes fits; slot 1 moves, so both
+ * sequences are odd meanwhile and viewers copying out of either retry */
+static bool SharedScan_grow(SharedScan* this, size_t size) {
+   SharedScanSegment* segment = this->segment;
+   uint64_t capacity = segment->slotCapacity;
+   while (capacity < size)
+      capacity *= 2;
+   if (capacity > UINT32_MAX) {
+      errno = EFBIG;
+      return false;
+   }
+
+   size_t mapSize = SharedScan_dataOffset(segment->layoutSize) + 2 * capacity;
+   if (ftruncate(this->fd, mapSize) < 0)
+      return false;
+   void* map = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+   if (map == MAP_FAILED)
+      return false;
+   munmap(this->segment, this->mapSize);
+   this->segment = segment = map;
+   this->mapSize = mapSize;
+
+   uint32_t sequences[2];
+   for (unsigned int i = 0; i < 2; i++) {
+      sequences[i] = segment->slots[i].sequence;
+      __atomic_store_n(&segment->slots[i].sequence, sequences[i] + 1, __ATOMIC_RELAXED);
+   }
+   __atomic_thread_fence(__ATOMIC_RELEASE);
+
+   // what slot 1 held stayed behind at its old offset
+   __atomic_store_n(&segment->slotCapacity, capacity, __ATOMIC_RELAXED);
+   __atomic_store_n(&segment->slots[1].size, 0, __ATOMIC_RELAXED);
+
+   for (unsigned int i = 0; i < 2; i++)
+      __atomic_store_n(&segment->slots[i].sequence, sequences[i] + 2, __ATOMIC_RELEASE);
+   return true;
+}
+
+static void SharedScan_publish(SharedScan* this, const ProcessList* pl, const Header* header) {
+   Snapshot_capture(this->current, this->previous, pl, header);
+   if (this->shared)
+      Snapshot_dropRestricted(this->current);
+
+   // viewers may skip scans, so every one of them is a keyframe
+   SnapshotBuffer_reset(&this->buffer);
+   Snapshot_encode(this->current, NULL, &this->buffer);
+
+   Snapshot* t = this->previous;
+   this->previous = this->current;
+   this->current = t;
+
+   if (this->buffer.size > this->segment->slotCapacity && !SharedScan_grow(this, this->buffer.size)) {
+      // viewers only see the scans stop, so say why once
+      if (!this->tooLarge)
+         fprintf(stderr, "Hata: %zu baytlık tarama paylaşımlı belleğe sığmıyor: %s\n", this->buffer.size, strerror(errno));
+      this->tooLarge = true;
+      return;
+   }
+   this->tooLarge = false;
+
+   SharedScanSegment* segment = this->segment;
+   uint32_t generation = segment->generation + 1;
+   SharedScanSlot* slot = &segment->slots[generation % 2];
+   uint32_t sequence = slot->sequence;
+   __atomic_store_n(&slot->sequence, sequence + 1, __ATOMIC_RELAXED);
+   __atomic_thread_fence(__ATOMIC_RELEASE);
+
+   memcpy((uint8_t*)segment + SharedScan_slotOffset(segment, segment->slotCapacity, generation % 2), this->buffer.data, this->buffer.size);
+   __atomic_store_n(&slot->size, (uint32_t)this->buffer.size, __ATOMIC_RELAXED);
+   __atomic_store_n(&slot->realtimeMs, this->previous->realtimeMs, __ATOMIC_RELAXED);
+
+   __atomic_store_n(&slot->sequence, sequence + 2, __ATOMIC_RELEASE);
+   __atomic_store_n(&segment->generation, generation, __ATOMIC_RELEASE);
+}
+
+static void SharedScan_sleepUntil(uint64_t deadlineMs) {
+   uint64_t now;
+   Platform_gettime_monotonic(&now);
+   if (now >= deadlineMs)
+      return;
+
+   uint64_t ms = deadlineMs - now;
+   struct timespec req = {
+      .tv_sec = (time_t)(ms / 1000),
+      .tv_nsec = (long)(ms % 1000) * 1000000L
+   };
+   while (nanosleep(&req, &req) == -1 && !SharedScan_stopped) {
+      continue;
+   }
+}
+
+int SharedScan_run(SharedScan* this, ProcessList* pl, Header* header, const Settings* settings) {
+   CRT_initHeadless(settings);
+   this->segment->delayMs = 100 * (uint32_t)settings->delay;
+
+   // leave through SharedScan_delete so the segment is removed
+   struct sigaction act;
+   memset(&act, 0, sizeof(act));
+   act.sa_handler = SharedScan_stop;
+   sigemptyset(&act.sa_mask);
+   sigaction(SIGINT, &act, NULL);
+   sigaction(SIGTERM, &act, NULL);
+   sigaction(SIGHUP, &act, NULL);
+
+   // prime the CPU counters, the first scan has nothing to compare against
+   Platform_gettime_realtime(&pl->realtime, &pl->realtimeMs);
+   ProcessList_scan(pl, false);
+
+   uint64_t next;
+   Platform_gettime_monotonic(&next);
+
+   while (!SharedScan_stopped) {
+      next += 100 * (uint64_t)settings->delay;
+      SharedScan_sleepUntil(next);
+      if (SharedScan_stopped)
+         break;
+
+      Platform_gettime_realtime(&pl->realtime, &pl->realtimeMs);
+      ProcessList_scan(pl, false);
+      Header_updateData(header);
+      SharedScan_publish(this, pl, header);
+   }
+   return 0;
+}
+
+/* Copies the newest scan out of the segment and decodes it, false if there is none */
+static bool SharedScan_read(SharedScan* this) {
+   for (int attempt = 0; attempt < SHARED_SCAN_READ_ATTEMPTS; attempt++) {
+      const SharedScanSegment* segment = this->segment;
+      uint32_t generation = __atomic_load_n(&segment->generation, __ATOMIC_ACQUIRE);
+      if (generation == this->generation)
+         return false;
+
+      const SharedScanSlot* slot = &segment->slots[generation % 2];
+      uint32_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+      if (sequence % 2)
+         continue;
+
+      uint32_t size = __atomic_load_n(&slot->size, __ATOMIC_RELAXED);
+      uint64_t realtimeMs = __atomic_load_n(&slot->realtimeMs, __ATOMIC_RELAXED);
+      uint64_t capacity = __atomic_load_n(&segment->slotCapacity, __ATOMIC_RELAXED);
+      if (size > capacity)
+         continue;
+
+      size_t offset = SharedScan_slotOffset(segment, capacity, generation % 2);
+      if (offset + size > this->mapSize) {
+         // the collector grew the segment for a larger scan
+         if (!SharedScan_map(this))
+            return false;
+         continue;
+      }
+
+      if (size > this->copyCapacity) {
+         this->copyCapacity = size;
+         this->copy = xRealloc(this->copy, size);
+      }
+      memcpy(this->copy, (const uint8_t*)segment + offset, size);
+
+      // the collector lapped this viewer and overwrote the slot while it was copied
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) != sequence)
+         continue;
+
+      this->generation = generation;
+      if (!Snapshot_decode(this->scratch, NULL, &this->codec, this->copy, size))
+         return false;
+      this->scratch->realtimeMs = realtimeMs;
+
+      Snapshot* t = this->view;
+      this->view = this->scratch;
+      this->scratch = t;
+      return true;
+   }
+   return false;
+}
+
+void SharedScan_advance(SharedScan* this, ProcessList* pl, bool paused) {
+   if (!paused && !SharedScan_read(this)) {
+      // a collector that was restarted publishes into a new segment of the same name
+      uint64_t now;
+      Platform_gettime_monotonic(&now);
+      if (now - this->lastCheckMs >= SHARED_SCAN_RECHECK_MS && !SharedScan_isAlive(this->segment->collector)) {
+         this->lastCheckMs = now;
+         if (SharedScan_map(this))
+            SharedScan_read(this);
+      }
+   }
+   pl->snapshot = this->view;
+}
+
+bool SharedScan_staleStatus(const SharedScan* this, char* buffer, size_t size) {
+   if (this->generation == 0) {
+      xSnprintf(buffer, size, "TOPLAYICI BEKLENİYOR %s", this->name);
+      return true;
+   }
+
+   struct timeval tv;
+   uint64_t now;
+   Platform_gettime_realtime(&tv, &now);
+   bool alive = SharedScan_isAlive(this->segment->collector);
+   if (alive && now < this->view->realtimeMs + 2 * (uint64_t)this->segment->delayMs + 2000)
+      return false;
+
+   time_t t = this->view->realtimeMs / 1000;
+   struct tm tm;
+   char when[16];
+   if (!localtime_r(&t, &tm) || !strftime(when, sizeof(when), "%H:%M:%S", &tm))
+      String_safeStrncpy(when, "?", sizeof(when));
+   xSnprintf(buffer, size, "%s %s", alive ? "ESKİ VERİ" : "TOPLAYICI YOK", when);
+   return true;
+}
@@ -0,0 +1,96 @@
+#ifndef HEADER_SharedScan
+#define HEADER_SharedScan
+/*
+htop - SharedScan.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "Header.h"
+#include "ProcessList.h"
+#include "Settings.h"
+#include "Snapshot.h"
+
+
+#define SHARED_SCAN_MAGIC "htopshm\n"
+#define SHARED_SCAN_VERSION 2
+#define SHARED_SCAN_DEFAULT_NAME "/htop"
+#define SHARED_SCAN_INITIAL_SLOT_CAPACITY (1024 * 1024)
+
+typedef struct SharedScanSlot_ {
+   uint32_t sequence;         /* odd while the collector is writing the slot */
+   uint32_t size;
+   uint64_t realtimeMs;
+} SharedScanSlot;
+
+/*
+ * Start of the shared memory segment, followed by the field layout and
+ * two slots of slotCapacity bytes.  Every scan is encoded as a snapshot
+ * keyframe into the slot the previous scan did not use, then published by
+ * raising the generation.  Viewers copy the newest slot out and retry if
+ * its sequence changed meanwhile, so the collector never waits for them
+ * and they only ever lose a race against a full scan.  A scan that does
+ * not fit grows the segment and doubles slotCapacity while both sequences
+ * are odd; viewers map the segment again once a slot ends past their map.
+ */
+typedef struct SharedScanSegment_ {
+   char magic[8];
+   uint32_t version;
+   uint32_t layoutSize;
+   uint64_t slotCapacity;
+   pid_t collector;
+   uint32_t delayMs;
+   uint32_t generation;       /* number of published scans, the newest is in slots[generation % 2] */
+   SharedScanSlot slots[2];
+} SharedScanSegment;
+
+typedef struct SharedScan_ {
+   char* name;
+   bool owner;                /* created by this process, which publishes into it */
+   bool shared;               /* readable by a group, which gets no restricted fields */
+   SharedScanSegment* segment;
+   size_t mapSize;
+   ino_t inode;
+
+   /* collector */
+   int fd;
+   bool tooLarge;             /* the last scan could not be published */
+   Snapshot* current;
+   Snapshot* previous;
+   SnapshotBuffer buffer;
+
+   /* viewer */
+   SnapshotCodec codec;
+   uint32_t generation;
+   uint8_t* copy;
+   size_t copyCapacity;
+   Snapshot* view;
+   Snapshot* scratch;
+   uint64_t lastCheckMs;
+} SharedScan;
+
+/* Creates the segment for a collector, only readable by its user unless a group
+ * other than (gid_t)-1 is given; returns NULL with errno set on failure */
+SharedScan* SharedScan_create(const char* name, gid_t group);
+
+/* Attaches a viewer to the segment of a running collector, returns NULL with errno set on failure */
+SharedScan* SharedScan_attach(const char* name);
+
+void SharedScan_delete(SharedScan* this);
+
+/* Scans every update interval and publishes the result until interrupted */
+int SharedScan_run(SharedScan* this, ProcessList* pl, Header* header, const Settings* settings);
+
+/* Points pl at the newest published scan, keeps the current one while paused */
+void SharedScan_advance(SharedScan* this, ProcessList* pl, bool paused);
+
+/* Describes the shown scan if the collector stopped publishing, returns false otherwise */
+bool SharedScan_staleStatus(const SharedScan* this, char* buffer, size_t size);
+
+#endif
@@ -0,0 +1,1034 @@
+/*
+htop - Snapshot.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "Snapshot.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Macros.h"
+#include "Platform.h"
+#include "UsersTable.h"
+#include "Vector.h"
+#include "XUtils.h"
+
+
+/*
+ * Encoded frame layout (all integers are LEB128 varints, deltas are
+ * zigzag encoded and taken against the previous frame, or against zero
+ * in a keyframe):
+ *
+ *   globals    count, then one delta per ProcessList counter
+ *   rows       count, then the pids as ascending differences
+ *   columns    one run-length column per field, in layout order
+ *   meters     count, layout flag (+ name/param of every slot if set),
+ *              then per slot: item count, run-length column of the
+ *              values and the total, and the text buffer
+ *
+ * A run-length column is a sequence of (unchanged count, payload) pairs,
+ * which makes a column of idle processes cost a single byte.  Integer
+ * payloads are deltas, string payloads are length + 1 (0 for NULL)
+ * followed by the bytes, meter values are IEEE doubles (little endian).
+ */
+
+static const SnapshotField Snapshot_processFields[] = {
+   SNAPSHOT_FIELD(Process, ppid, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, tgid, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, pgrp, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, session, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, tpgid, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, tty_nr, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(Process, st_uid, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(Process, comm, SNAPSHOT_STRING),
+   SNAPSHOT_FIELD(Process, basenameOffset, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, processor, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, percent_cpu, SNAPSHOT_REAL),
+   SNAPSHOT_FIELD(Process, percent_mem, SNAPSHOT_REAL),
+   SNAPSHOT_FIELD(Process, priority, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, nice, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, nlwp, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, starttime_ctime, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, m_virt, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, m_resident, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, minflt, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(Process, majflt, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(Process, time, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(Process, state, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(Process, show, SNAPSHOT_INT),
+};
+
+static const SnapshotField Snapshot_globalFields[] = {
+   SNAPSHOT_FIELD(ProcessList, totalTasks, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(ProcessList, runningTasks, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(ProcessList, userlandThreads, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(ProcessList, kernelThreads, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(ProcessList, totalMem, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(ProcessList, usedMem, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(ProcessList, buffersMem, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(ProcessList, cachedMem, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(ProcessList, sharedMem, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(ProcessList, availableMem, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(ProcessList, totalSwap, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(ProcessList, usedSwap, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(ProcessList, cachedSwap, SNAPSHOT_UINT),
+};
+
+#define SNAPSHOT_GLOBALS ARRAYSIZE(Snapshot_globalFields)
+
+/* Generic fields followed by the platform ones; each maps to an integer or a string column */
+static struct {
+   unsigned int nFields;
+   const SnapshotField* fields[SNAPSHOT_MAX_FIELDS];
+   unsigned int column[SNAPSHOT_MAX_FIELDS];
+   unsigned int nInts;
+   unsigned int nStrings;
+} Snapshot_layout;
+
+static void Snapshot_initLayout(void) {
+   if (Snapshot_layout.nFields)
+      return;
+
+   const SnapshotField* tables[] = { Snapshot_processFields, Platform_snapshotLayout.fields };
+   const unsigned int sizes[] = { ARRAYSIZE(Snapshot_processFields), Platform_snapshotLayout.nFields };
+
+   for (unsigned int t = 0; t < ARRAYSIZE(tables); t++) {
+      for (unsigned int i = 0; i < sizes[t]; i++) {
+         assert(Snapshot_layout.nFields < SNAPSHOT_MAX_FIELDS);
+         const SnapshotField* field = &tables[t][i];
+         unsigned int n = Snapshot_layout.nFields++;
+         Snapshot_layout.fields[n] = field;
+         Snapshot_layout.column[n] = field->type == SNAPSHOT_STRING ? Snapshot_layout.nStrings++ : Snapshot_layout.nInts++;
+      }
+   }
+}
+
+static inline bool Snapshot_isString(unsigned int field) {
+   return Snapshot_layout.fields[field]->type == SNAPSHOT_STRING;
+}
+
+static inline int64_t* Snapshot_intColumn(const Snapshot* this, unsigned int field) {
+   return &this->values[(size_t)Snapshot_layout.column[field] * this->capacity];
+}
+
+static inline SnapshotString** Snapshot_stringColumn(const Snapshot* this, unsigned int field) {
+   return &this->strings[(size_t)Snapshot_layout.column[field] * this->capacity];
+}
+
+unsigned int Snapshot_fieldCount(void) {
+   Snapshot_initLayout();
+   return Snapshot_layout.nFields;
+}
+
+const SnapshotField* Snapshot_field(unsigned int field) {
+   Snapshot_initLayout();
+   assert(field < Snapshot_layout.nFields);
+   return Snapshot_layout.fields[field];
+}
+
+int Snapshot_fieldIndex(const char* name) {
+   Snapshot_initLayout();
+   for (unsigned int i = 0; i < Snapshot_layout.nFields; i++) {
+      if (String_eq(Snapshot_layout.fields[i]->name, name))
+         return i;
+   }
+   return -1;
+}
+
+/* ---------------------------------------- */
+
+void SnapshotBuffer_init(SnapshotBuffer* this) {
+   this->data = NULL;
+   this->size = 0;
+   this->capacity = 0;
+}
+
+void SnapshotBuffer_done(SnapshotBuffer* this) {
+   free(this->data);
+   SnapshotBuffer_init(this);
+}
+
+uint8_t* SnapshotBuffer_reserve(SnapshotBuffer* this, size_t len) {
+   if (this->size + len > this->capacity) {
+      this->capacity = MAXIMUM(this->size + len, MAXIMUM(this->capacity * 2, (size_t)4096));
+      this->data = xRealloc(this->data, this->capacity);
+   }
+   return this->data + this->size;
+}
+
+void SnapshotBuffer_append(SnapshotBuffer* this, const void* data, size_t len) {
+   memcpy(SnapshotBuffer_reserve(this, len), data, len);
+   this->size += len;
+}
+
+void SnapshotBuffer_putVarint(SnapshotBuffer* this, uint64_t value) {
+   uint8_t* out = SnapshotBuffer_reserve(this, 10);
+   size_t n = 0;
+   while (value >= 0x80) {
+      out[n++] = (uint8_t)(value | 0x80);
+      value >>= 7;
+   }
+   out[n++] = (uint8_t)value;
+   this->size += n;
+}
+
+bool Snapshot_getVarint(const uint8_t** pos, const uint8_t* end, uint64_t* value) {
+   uint64_t result = 0;
+   for (unsigned int shift = 0; shift < 64 && *pos < end; shift += 7) {
+      uint8_t byte = *(*pos)++;
+      result |= (uint64_t)(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+         *value = result;
+         return true;
+      }
+   }
+   return false;
+}
+
+static inline uint64_t zigzag(uint64_t delta) {
+   return (delta << 1) ^ (uint64_t)((int64_t)delta >> 63);
+}
+
+static inline uint64_t unzigzag(uint64_t value) {
+   return (value >> 1) ^ (~(value & 1) + 1);
+}
+
+static void SnapshotBuffer_putDouble(SnapshotBuffer* this, double value) {
+   uint64_t bits;
+   memcpy(&bits, &value, sizeof(bits));
+   uint8_t* out = SnapshotBuffer_reserve(this, 8);
+   for (int i = 0; i < 8; i++)
+      out[i] = (uint8_t)(bits >> (8 * i));
+   this->size += 8;
+}
+
+static bool Snapshot_getDouble(const uint8_t** pos, const uint8_t* end, double* value) {
+   if (end - *pos < 8)
+      return false;
+
+   uint64_t bits = 0;
+   for (int i = 0; i < 8; i++)
+      bits |= (uint64_t)(*pos)[i] << (8 * i);
+   *pos += 8;
+   memcpy(value, &bits, sizeof(bits));
+   return true;
+}
+
+static void SnapshotBuffer_putBytes(SnapshotBuffer* this, const char* text, size_t len) {
+   SnapshotBuffer_putVarint(this, len);
+   SnapshotBuffer_append(this, text, len);
+}
+
+void Snapshot_putFrameHeader(uint8_t* out, uint32_t size, uint32_t flags, uint64_t realtimeMs) {
+   for (int i = 0; i < 4; i++) {
+      out[i] = (uint8_t)(size >> (8 * i));
+      out[4 + i] = (uint8_t)(flags >> (8 * i));
+   }
+   for (int i = 0; i < 8; i++)
+      out[8 + i] = (uint8_t)(realtimeMs >> (8 * i));
+}
+
+void Snapshot_getFrameHeader(const uint8_t* in, uint32_t* size, uint32_t* flags, uint64_t* realtimeMs) {
+   *size = 0;
+   *flags = 0;
+   *realtimeMs = 0;
+   for (int i = 0; i < 4; i++) {
+      *size |= (uint32_t)in[i] << (8 * i);
+      *flags |= (uint32_t)in[4 + i] << (8 * i);
+   }
+   for (int i = 0; i < 8; i++)
+      *realtimeMs |= (uint64_t)in[8 + i] << (8 * i);
+}
+
+/* ---------------------------------------- */
+
+static SnapshotString* SnapshotString_new(const char* text, size_t len) {
+   SnapshotString* this = xMalloc(sizeof(SnapshotString) + len + 1);
+   this->refs = 1;
+   this->len = len;
+   memcpy(this->text, text, len);
+   this->text[len] = '\0';
+   return this;
+}
+
+static inline SnapshotString* SnapshotString_ref(SnapshotString* this) {
+   if (this)
+      this->refs++;
+   return this;
+}
+
+static inline void SnapshotString_unref(SnapshotString* this) {
+   if (this && --this->refs == 0)
+      free(this);
+}
+
+static inline bool SnapshotString_equals(const SnapshotString* this, const char* text) {
+   if (!this || !text)
+      return !this && !text;
+   return String_eq(this->text, text);
+}
+
+/* ---------------------------------------- */
+
+static int64_t SnapshotField_get(const SnapshotField* field, const void* base) {
+   const char* p = (const char*)base + field->offset;
+
+   switch (field->type) {
+   case SNAPSHOT_INT:
+      switch (field->size) {
+      case 1: { int8_t v; memcpy(&v, p, sizeof(v)); return v; }
+      case 2: { int16_t v; memcpy(&v, p, sizeof(v)); return v; }
+      case 4: { int32_t v; memcpy(&v, p, sizeof(v)); return v; }
+      default: { int64_t v; memcpy(&v, p, sizeof(v)); return v; }
+      }
+   case SNAPSHOT_UINT:
+      switch (field->size) {
+      case 1: { uint8_t v; memcpy(&v, p, sizeof(v)); return v; }
+      case 2: { uint16_t v; memcpy(&v, p, sizeof(v)); return v; }
+      case 4: { uint32_t v; memcpy(&v, p, sizeof(v)); return v; }
+      default: { uint64_t v; memcpy(&v, p, sizeof(v)); return (int64_t)v; }
+      }
+   case SNAPSHOT_REAL: {
+      double v;
+      if (field->size == sizeof(float)) {
+         float f;
+         memcpy(&f, p, sizeof(f));
+         v = f;
+      } else {
+         memcpy(&v, p, sizeof(v));
+      }
+      return isnan(v) ? SNAPSHOT_NAN : llround(v * 100.0);
+   }
+   case SNAPSHOT_STRING:
+      break;
+   }
+   return 0;
+}
+
+static void SnapshotField_set(const SnapshotField* field, void* base, int64_t value) {
+   char* p = (char*)base + field->offset;
+
+   switch (field->type) {
+   case SNAPSHOT_INT:
+   case SNAPSHOT_UINT:
+      switch (field->size) {
+      case 1: { uint8_t v = (uint8_t)value; memcpy(p, &v, sizeof(v)); break; }
+      case 2: { uint16_t v = (uint16_t)value; memcpy(p, &v, sizeof(v)); break; }
+      case 4: { uint32_t v = (uint32_t)value; memcpy(p, &v, sizeof(v)); break; }
+      default: memcpy(p, &value, sizeof(value)); break;
+      }
+      break;
+   case SNAPSHOT_REAL: {
+      double v = value == SNAPSHOT_NAN ? NAN : value / 100.0;
+      if (field->size == sizeof(float)) {
+         float f = (float)v;
+         memcpy(p, &f, sizeof(f));
+      } else {
+         memcpy(p, &v, sizeof(v));
+      }
+      break;
+   }
+   case SNAPSHOT_STRING:
+      break;
+   }
+}
+
+/* ---------------------------------------- */
+
+Snapshot* Snapshot_new(void) {
+   Snapshot_initLayout();
+   Snapshot* this = xCalloc(1, sizeof(Snapshot));
+   this->globals = xCalloc(SNAPSHOT_GLOBALS, sizeof(int64_t));
+   return this;
+}
+
+void Snapshot_clear(Snapshot* this) {
+   for (unsigned int s = 0; s < Snapshot_layout.nStrings; s++) {
+      SnapshotString** column = &this->strings[(size_t)s * this->capacity];
+      for (unsigned int i = 0; i < this->nRows; i++) {
+         SnapshotString_unref(column[i]);
+         column[i] = NULL;
+      }
+   }
+   this->nRows = 0;
+   this->nMeters = 0;
+   this->realtimeMs = 0;
+   memset(this->globals, 0, SNAPSHOT_GLOBALS * sizeof(int64_t));
+}
+
+void Snapshot_delete(Snapshot* this) {
+   if (!this)
+      return;
+
+   Snapshot_clear(this);
+   for (unsigned int i = 0; i < this->metersCapacity; i++)
+      free(this->meters[i].values);
+   free(this->meters);
+   free(this->pids);
+   free(this->values);
+   free(this->strings);
+   free(this->globals);
+   free(this);
+}
+
+/* Grows the columns to hold at least rows entries; the first nRows are kept */
+static void Snapshot_reserve(Snapshot* this, unsigned int rows) {
+   if (rows <= this->capacity)
+      return;
+
+   unsigned int capacity = MAXIMUM(rows, MAXIMUM(this->capacity * 2, 64U));
+
+   int64_t* values = xCalloc((size_t)Snapshot_layout.nInts * capacity + 1, sizeof(int64_t));
+   SnapshotString** strings = xCalloc((size_t)Snapshot_layout.nStrings * capacity + 1, sizeof(SnapshotString*));
+   for (unsigned int c = 0; c < Snapshot_layout.nInts; c++)
+      memcpy(&values[(size_t)c * capacity], &this->values[(size_t)c * this->capacity], this->nRows * sizeof(int64_t));
+   for (unsigned int c = 0; c < Snapshot_layout.nStrings; c++)
+      memcpy(&strings[(size_t)c * capacity], &this->strings[(size_t)c * this->capacity], this->nRows * sizeof(SnapshotString*));
+
+   free(this->values);
+   free(this->strings);
+   this->values = values;
+   this->strings = strings;
+   this->pids = xReallocArray(this->pids, capacity, sizeof(pid_t));
+   this->capacity = capacity;
+}
+
+static SnapshotMeter* Snapshot_addMeter(Snapshot* this) {
+   if (this->nMeters == this->metersCapacity) {
+      unsigned int capacity = MAXIMUM(this->metersCapacity * 2, 16U);
+      this->meters = xReallocArray(this->meters, capacity, sizeof(SnapshotMeter));
+      memset(&this->meters[this->metersCapacity], 0, (capacity - this->metersCapacity) * sizeof(SnapshotMeter));
+      this->metersCapacity = capacity;
+   }
+   return &this->meters[this->nMeters++];
+}
+
+static void SnapshotMeter_reserve(SnapshotMeter* this, unsigned int items) {
+   if (items > this->valuesCapacity) {
+      this->values = xReallocArray(this->values, items, sizeof(double));
+      this->valuesCapacity = items;
+   }
+}
+
+int64_t Snapshot_value(const Snapshot* this, unsigned int row, unsigned int field) {
+   assert(row < this->nRows && !Snapshot_isString(field));
+   return Snapshot_intColumn(this, field)[row];
+}
+
+const char* Snapshot_string(const Snapshot* this, unsigned int row, unsigned int field) {
+   assert(row < this->nRows && Snapshot_isString(field));
+   const SnapshotString* s = Snapshot_stringColumn(this, field)[row];
+   return s ? s->text : NULL;
+}
+
+int Snapshot_findRow(const Snapshot* this, pid_t pid) {
+   unsigned int l = 0;
+   unsigned int r = this->nRows;
+   while (l < r) {
+      unsigned int c = l + (r - l) / 2;
+      if (this->pids[c] == pid)
+         return c;
+      if (this->pids[c] < pid)
+         l = c + 1;
+      else
+         r = c;
+   }
+   return -1;
+}
+
+size_t Snapshot_memoryUsage(const Snapshot* this) {
+   size_t size = sizeof(Snapshot) + SNAPSHOT_GLOBALS * sizeof(int64_t);
+   size += (size_t)this->capacity * (sizeof(pid_t) + Snapshot_layout.nInts * sizeof(int64_t) + Snapshot_layout.nStrings * sizeof(SnapshotString*));
+   for (unsigned int i = 0; i < this->metersCapacity; i++)
+      size += sizeof(SnapshotMeter) + this->meters[i].valuesCapacity * sizeof(double);
+   return size;
+}
+
+/* For every row of this the row with the same pid in prev, or -1; both are sorted by pid */
+static int* Snapshot_match(const Snapshot* this, const Snapshot* prev) {
+   int* match = xMallocArray(this->nRows + 1, sizeof(int));
+   unsigned int j = 0;
+   for (unsigned int i = 0; i < this->nRows; i++) {
+      while (prev && j < prev->nRows && prev->pids[j] < this->pids[i])
+         j++;
+      match[i] = (prev && j < prev->nRows && prev->pids[j] == this->pids[i]) ? (int)j : -1;
+   }
+   return match;
+}
+
+/* ---------------------------------------- */
+
+static int Snapshot_comparePids(const void* v1, const void* v2) {
+   const Process* p1 = *(const Process* const*)v1;
+   const Process* p2 = *(const Process* const*)v2;
+   return SPACESHIP_NUMBER(p1->pid, p2->pid);
+}
+
+static void Snapshot_captureMeter(Snapshot* this, const Meter* meter) {
+   SnapshotMeter* m = Snapshot_addMeter(this);
+   String_safeStrncpy(m->name, Meter_name(meter), sizeof(m->name));
+   m->param = meter->param;
+   m->curItems = meter->values ? meter->curItems : 0;
+   SnapshotMeter_reserve(m, m->curItems);
+   if (m->curItems)
+      memcpy(m->values, meter->values, m->curItems * sizeof(double));
+   m->total = meter->total;
+   String_safeStrncpy(m->txtBuffer, meter->txtBuffer, sizeof(m->txtBuffer));
+}
+
+void Snapshot_capture(Snapshot* this, const Snapshot* prev, const ProcessList* pl, const Header* header) {
+   Snapshot_clear(this);
+   this->realtimeMs = pl->realtimeMs;
+   for (unsigned int g = 0; g < SNAPSHOT_GLOBALS; g++)
+      this->globals[g] = SnapshotField_get(&Snapshot_globalFields[g], pl);
+
+   unsigned int n = Vector_size(pl->processes);
+   Snapshot_reserve(this, n);
+
+   const Process** order = xMallocArray(n + 1, sizeof(Process*));
+   for (unsigned int i = 0; i < n; i++)
+      order[i] = (const Process*) Vector_get(pl->processes, i);
+   qsort(order, n, sizeof(Process*), Snapshot_comparePids);
+
+   for (unsigned int i = 0; i < n; i++)
+      this->pids[i] = order[i]->pid;
+   this->nRows = n;
+
+   int* match = Snapshot_match(this, prev);
+   for (unsigned int f = 0; f < Snapshot_layout.nFields; f++) {
+      const SnapshotField* field = Snapshot_layout.fields[f];
+      if (field->type != SNAPSHOT_STRING) {
+         int64_t* column = Snapshot_intColumn(this, f);
+         for (unsigned int i = 0; i < n; i++)
+            column[i] = SnapshotField_get(field, order[i]);
+         continue;
+      }
+
+      SnapshotString** column = Snapshot_stringColumn(this, f);
+      SnapshotString* const* prevColumn = prev ? Snapshot_stringColumn(prev, f) : NULL;
+      for (unsigned int i = 0; i < n; i++) {
+         const char* text;
+         memcpy(&text, (const char*)order[i] + field->offset, sizeof(text));
+         SnapshotString* old = match[i] >= 0 ? prevColumn[match[i]] : NULL;
+         if (SnapshotString_equals(old, text))
+            column[i] = SnapshotString_ref(old);
+         else
+            column[i] = text ? SnapshotString_new(text, strlen(text)) : NULL;
+      }
+   }
+   free(match);
+   free(order);
+
+   if (!header)
+      return;
+
+   Header_forEachColumn(header, col) {
+      const Vector* meters = header->columns[col];
+      for (int i = 0; i < Vector_size(meters); i++) {
+         const Meter* meter = (const Meter*) Vector_get(meters, i);
+         Snapshot_captureMeter(this, meter);
+         if (As_Meter(meter)->subMeters) {
+            int count;
+            Meter* const* sub = As_Meter(meter)->subMeters(meter, &count);
+            for (int j = 0; j < count; j++)
+               Snapshot_captureMeter(this, sub[j]);
+         }
+      }
+   }
+}
+
+void Snapshot_append(Snapshot* this, const Snapshot* other, pid_t pidBase) {
+   assert(this->nRows == 0 || pidBase > this->pids[this->nRows - 1]);
+
+   // the totals and meters of the first snapshot stand for all of them, so the
+   // tasks and memory counts agree with the meters that show them
+   bool firstHost = this->realtimeMs == 0;
+   this->realtimeMs = MAXIMUM(this->realtimeMs, other->realtimeMs);
+   if (firstHost) {
+      memcpy(this->globals, other->globals, SNAPSHOT_GLOBALS * sizeof(int64_t));
+      for (unsigned int i = 0; i < other->nMeters; i++) {
+         const SnapshotMeter* src = &other->meters[i];
+         SnapshotMeter* m = Snapshot_addMeter(this);
+         memcpy(m->name, src->name, sizeof(m->name));
+         m->param = src->param;
+         m->curItems = src->curItems;
+         SnapshotMeter_reserve(m, m->curItems);
+         if (m->curItems)
+            memcpy(m->values, src->values, m->curItems * sizeof(double));
+         m->total = src->total;
+         memcpy(m->txtBuffer, src->txtBuffer, sizeof(m->txtBuffer));
+      }
+   }
+
+   unsigned int first = this->nRows;
+   unsigned int n = other->nRows;
+   Snapshot_reserve(this, first + n);
+   for (unsigned int i = 0; i < n; i++)
+      this->pids[first + i] = other->pids[i] | pidBase;
+
+   const int ppidField = Snapshot_fieldIndex("ppid");
+   const int tgidField = Snapshot_fieldIndex("tgid");
+   for (unsigned int f = 0; f < Snapshot_layout.nFields; f++) {
+      if (Snapshot_isString(f)) {
+         SnapshotString** column = Snapshot_stringColumn(this, f) + first;
+         SnapshotString* const* src = Snapshot_stringColumn(other, f);
+         for (unsigned int i = 0; i < n; i++)
+            column[i] = SnapshotString_ref(src[i]);
+         continue;
+      }
+
+      int64_t* column = Snapshot_intColumn(this, f) + first;
+      memcpy(column, Snapshot_intColumn(other, f), n * sizeof(int64_t));
+      // parents and thread groups keep pointing into the same host
+      if ((int)f == ppidField || (int)f == tgidField) {
+         for (unsigned int i = 0; i < n; i++)
+            if (column[i] > 0)
+               column[i] |= pidBase;
+      }
+   }
+   this->nRows = first + n;
+}
+
+void Snapshot_dropRestricted(Snapshot* this) {
+   for (unsigned int f = 0; f < Snapshot_layout.nFields; f++) {
+      const SnapshotField* field = Snapshot_layout.fields[f];
+      if (!field->restricted)
+         continue;
+
+      if (Snapshot_isString(f)) {
+         SnapshotString** column = Snapshot_stringColumn(this, f);
+         for (unsigned int i = 0; i < this->nRows; i++) {
+            SnapshotString_unref(column[i]);
+            column[i] = NULL;
+         }
+         continue;
+      }
+
+      int64_t* column = Snapshot_intColumn(this, f);
+      for (unsigned int i = 0; i < this->nRows; i++)
+         column[i] = field->unreadable;
+   }
+}
+
+void Snapshot_restoreProcesses(const Snapshot* this, ProcessList* pl) {
+   pl->realtimeMs = this->realtimeMs;
+   pl->realtime.tv_sec = this->realtimeMs / 1000;
+   pl->realtime.tv_usec = (this->realtimeMs % 1000) * 1000;
+   for (unsigned int g = 0; g < SNAPSHOT_GLOBALS; g++)
+      SnapshotField_set(&Snapshot_globalFields[g], pl, this->globals[g]);
+
+   for (unsigned int i = 0; i < this->nRows; i++) {
+      bool preExisting;
+      Process* proc = ProcessList_getProcess(pl, this->pids[i], &preExisting, Platform_snapshotLayout.newProcess);
+      time_t starttime = proc->starttime_ctime;
+
+      for (unsigned int f = 0; f < Snapshot_layout.nFields; f++) {
+         const SnapshotField* field = Snapshot_layout.fields[f];
+         if (field->type != SNAPSHOT_STRING) {
+            SnapshotField_set(field, proc, Snapshot_intColumn(this, f)[i]);
+            continue;
+         }
+
+         const SnapshotString* s = Snapshot_stringColumn(this, f)[i];
+         char** text = (char**)((char*)proc + field->offset);
+         if (!s) {
+            free(*text);
+            *text = NULL;
+         } else if (!*text || !String_eq(*text, s->text)) {
+            free_and_xStrdup(text, s->text);
+         }
+      }
+
+      // uids of other hosts name other users there, so they are shown as numbers
+      proc->user = Process_hostIndex(proc->pid) ? NULL : UsersTable_getRef(pl->usersTable, proc->st_uid);
+      proc->updated = true;
+
+      if (!preExisting) {
+         Process_fillStarttimeBuffer(proc);
+         ProcessList_add(pl, proc);
+      } else if (proc->starttime_ctime != starttime) {
+         Process_fillStarttimeBuffer(proc);
+      }
+   }
+}
+
+static void Snapshot_restoreMeter(const Snapshot* this, Meter* meter, bool* used, unsigned int* next) {
+   const SnapshotMeter* m = NULL;
+   for (unsigned int k = 0; k < this->nMeters; k++) {
+      unsigned int idx = (*next + k) % this->nMeters;
+      if (!used[idx] && meter->param == this->meters[idx].param && String_eq(Meter_name(meter), this->meters[idx].name)) {
+         m = &this->meters[idx];
+         used[idx] = true;
+         *next = idx + 1;
+         break;
+      }
+   }
+
+   if (!m) {
+      // not part of the snapshot, show it empty rather than with live data
+      if (meter->values)
+         memset(meter->values, 0, As_Meter(meter)->maxItems * sizeof(double));
+      meter->txtBuffer[0] = '\0';
+      return;
+   }
+
+   uint8_t items = meter->values ? MINIMUM(m->curItems, As_Meter(meter)->maxItems) : 0;
+   if (items)
+      memcpy(meter->values, m->values, items * sizeof(double));
+   meter->curItems = items;
+   meter->total = m->total;
+   String_safeStrncpy(meter->txtBuffer, m->txtBuffer, sizeof(meter->txtBuffer));
+}
+
+void Snapshot_restoreMeters(const Snapshot* this, Header* header) {
+   bool* used = xCalloc(this->nMeters + 1, sizeof(bool));
+   unsigned int next = 0;
+
+   Header_forEachColumn(header, col) {
+      Vector* meters = header->columns[col];
+      for (int i = 0; i < Vector_size(meters); i++) {
+         Meter* meter = (Meter*) Vector_get(meters, i);
+         Snapshot_restoreMeter(this, meter, used, &next);
+         if (As_Meter(meter)->subMeters) {
+            int count;
+            Meter* const* sub = As_Meter(meter)->subMeters(meter, &count);
+            for (int j = 0; j < count; j++) {
+               Snapshot_restoreMeter(this, sub[j], used, &next);
+               Meter_sampleGraph(sub[j]);
+            }
+         }
+      }
+   }
+   free(used);
+}
+
+/* ---------------------------------------- */
+
+void Snapshot_writeLayout(SnapshotBuffer* out) {
+   Snapshot_initLayout();
+   SnapshotBuffer_putVarint(out, Snapshot_layout.nFields);
+   for (unsigned int f = 0; f < Snapshot_layout.nFields; f++) {
+      const SnapshotField* field = Snapshot_layout.fields[f];
+      SnapshotBuffer_putBytes(out, field->name, strlen(field->name));
+      SnapshotBuffer_putVarint(out, field->type);
+   }
+   SnapshotBuffer_putVarint(out, SNAPSHOT_GLOBALS);
+}
+
+bool SnapshotCodec_init(SnapshotCodec* this, const uint8_t* data, size_t len) {
+   Snapshot_initLayout();
+   memset(this, 0, sizeof(SnapshotCodec));
+
+   const uint8_t* pos = data;
+   const uint8_t* end = data + len;
+   uint64_t n;
+   if (!Snapshot_getVarint(&pos, end, &n) || n > SNAPSHOT_MAX_FIELDS)
+      return false;
+
+   this->nColumns = n;
+   for (unsigned int c = 0; c < this->nColumns; c++) {
+      uint64_t nameLen, type;
+      if (!Snapshot_getVarint(&pos, end, &nameLen) || nameLen > (uint64_t)(end - pos))
+         return false;
+      const char* name = (const char*)pos;
+      pos += nameLen;
+      if (!Snapshot_getVarint(&pos, end, &type) || type > SNAPSHOT_STRING)
+         return false;
+
+      this->isString[c] = type == SNAPSHOT_STRING;
+      this->columns[c] = -1;
+      for (unsigned int f = 0; f < Snapshot_layout.nFields; f++) {
+         const SnapshotField* field = Snapshot_layout.fields[f];
+         if (this->present[f] || Snapshot_isString(f) != this->isString[c])
+            continue;
+         if (strlen(field->name) == nameLen && memcmp(field->name, name, nameLen) == 0) {
+            this->columns[c] = f;
+            this->present[f] = true;
+            break;
+         }
+      }
+   }
+
+   if (!Snapshot_getVarint(&pos, end, &n))
+      return false;
+   this->nGlobals = n;
+   return true;
+}
+
+static void Snapshot_encodeMeters(const Snapshot* this, const Snapshot* prev, SnapshotBuffer* out) {
+   bool sameLayout = prev && prev->nMeters == this->nMeters;
+   for (unsigned int i = 0; sameLayout && i < this->nMeters; i++)
+      sameLayout = this->meters[i].param == prev->meters[i].param && String_eq(this->meters[i].name, prev->meters[i].name);
+
+   SnapshotBuffer_putVarint(out, this->nMeters);
+   SnapshotBuffer_putVarint(out, !sameLayout);
+   if (!sameLayout) {
+      for (unsigned int i = 0; i < this->nMeters; i++) {
+         SnapshotBuffer_putBytes(out, this->meters[i].name, strlen(this->meters[i].name));
+         SnapshotBuffer_putVarint(out, this->meters[i].param);
+      }
+   }
+
+   for (unsigned int i = 0; i < this->nMeters; i++) {
+      const SnapshotMeter* m = &this->meters[i];
+      const SnapshotMeter* pm = sameLayout ? &prev->meters[i] : NULL;
+
+      SnapshotBuffer_putVarint(out, m->curItems);
+      uint64_t run = 0;
+      for (unsigned int k = 0; k <= m->curItems; k++) {
+         double value = k < m->curItems ? m->values[k] : m->total;
+         double base = 0.0;
+         if (pm)
+            base = k < m->curItems ? (k < pm->curItems ? pm->values[k] : 0.0) : pm->total;
+         if (memcmp(&value, &base, sizeof(double)) == 0) {
+            run++;
+            continue;
+         }
+         SnapshotBuffer_putVarint(out, run);
+         SnapshotBuffer_putDouble(out, value);
+         run = 0;
+      }
+      if (run)
+         SnapshotBuffer_putVarint(out, run);
+
+      if (pm && String_eq(m->txtBuffer, pm->txtBuffer)) {
+         SnapshotBuffer_putVarint(out, 0);
+      } else {
+         size_t len = strlen(m->txtBuffer);
+         SnapshotBuffer_putVarint(out, len + 1);
+         SnapshotBuffer_append(out, m->txtBuffer, len);
+      }
+   }
+}
+
+void Snapshot_encode(const Snapshot* this, const Snapshot* prev, SnapshotBuffer* out) {
+   SnapshotBuffer_putVarint(out, SNAPSHOT_GLOBALS);
+   for (unsigned int g = 0; g < SNAPSHOT_GLOBALS; g++)
+      SnapshotBuffer_putVarint(out, zigzag((uint64_t)this->globals[g] - (uint64_t)(prev ? prev->globals[g] : 0)));
+
+   SnapshotBuffer_putVarint(out, this->nRows);
+   pid_t last = 0;
+   for (unsigned int i = 0; i < this->nRows; i++) {
+      SnapshotBuffer_putVarint(out, zigzag((uint64_t)(int64_t)this->pids[i] - (uint64_t)(int64_t)last));
+      last = this->pids[i];
+   }
+
+   int* match = Snapshot_match(this, prev);
+   for (unsigned int f = 0; f < Snapshot_layout.nFields; f++) {
+      uint64_t run = 0;
+      if (!Snapshot_isString(f)) {
+         const int64_t* column = Snapshot_intColumn(this, f);
+         const int64_t* base = prev ? Snapshot_intColumn(prev, f) : NULL;
+         for (unsigned int i = 0; i < this->nRows; i++) {
+            uint64_t delta = (uint64_t)column[i] - (uint64_t)(match[i] >= 0 ? base[match[i]] : 0);
+            if (!delta) {
+               run++;
+               continue;
+            }
+            SnapshotBuffer_putVarint(out, run);
+            SnapshotBuffer_putVarint(out, zigzag(delta));
+            run = 0;
+         }
+      } else {
+         SnapshotString* const* column = Snapshot_stringColumn(this, f);
+         SnapshotString* const* base = prev ? Snapshot_stringColumn(prev, f) : NULL;
+         for (unsigned int i = 0; i < this->nRows; i++) {
+            const SnapshotString* s = column[i];
+            const SnapshotString* old = match[i] >= 0 ? base[match[i]] : NULL;
+            if (s == old || (s && old && s->len == old->len && memcmp(s->text, old->text, s->len) == 0)) {
+               run++;
+               continue;
+            }
+            SnapshotBuffer_putVarint(out, run);
+            SnapshotBuffer_putVarint(out, s ? s->len + 1 : 0);
+            if (s)
+               SnapshotBuffer_append(out, s->text, s->len);
+            run = 0;
+         }
+      }
+      if (run)
+         SnapshotBuffer_putVarint(out, run);
+   }
+   free(match);
+
+   Snapshot_encodeMeters(this, prev, out);
+}
+
+static bool Snapshot_decodeMeters(Snapshot* this, const Snapshot* prev, const uint8_t** pos, const uint8_t* end) {
+   uint64_t n, withLayout;
+   if (!Snapshot_getVarint(pos, end, &n) || n > (uint64_t)(end - *pos) || !Snapshot_getVarint(pos, end, &withLayout))
+      return false;
+   if (!withLayout && (!prev || prev->nMeters != n))
+      return false;
+
+   this->nMeters = 0;
+   for (unsigned int i = 0; i < n; i++) {
+      SnapshotMeter* m = Snapshot_addMeter(this);
+      if (!withLayout) {
+         memcpy(m->name, prev->meters[i].name, sizeof(m->name));
+         m->param = prev->meters[i].param;
+         continue;
+      }
+
+      uint64_t len, param;
+      if (!Snapshot_getVarint(pos, end, &len) || len > (uint64_t)(end - *pos))
+         return false;
+      size_t copy = MINIMUM(len, sizeof(m->name) - 1);
+      memcpy(m->name, *pos, copy);
+      m->name[copy] = '\0';
+      *pos += len;
+      if (!Snapshot_getVarint(pos, end, &param))
+         return false;
+      m->param = param;
+   }
+
+   for (unsigned int i = 0; i < n; i++) {
+      SnapshotMeter* m = &this->meters[i];
+      const SnapshotMeter* pm = withLayout ? NULL : &prev->meters[i];
+
+      uint64_t items;
+      if (!Snapshot_getVarint(pos, end, &items) || items > UINT8_MAX)
+         return false;
+      m->curItems = items;
+      SnapshotMeter_reserve(m, m->curItems);
+      for (unsigned int k = 0; k < m->curItems; k++)
+         m->values[k] = pm && k < pm->curItems ? pm->values[k] : 0.0;
+      m->total = pm ? pm->total : 0.0;
+
+      for (uint64_t k = 0; k <= items; k++) {
+         uint64_t run;
+         if (!Snapshot_getVarint(pos, end, &run) || run > items + 1 - k)
+            return false;
+         k += run;
+         if (k > items)
+            break;
+         double value;
+         if (!Snapshot_getDouble(pos, end, &value))
+            return false;
+         if (k < items)
+            m->values[k] = value;
+         else
+            m->total = value;
+      }
+
+      uint64_t len;
+      if (!Snapshot_getVarint(pos, end, &len))
+         return false;
+      if (len == 0) {
+         if (pm)
+            memcpy(m->txtBuffer, pm->txtBuffer, sizeof(m->txtBuffer));
+         else
+            m->txtBuffer[0] = '\0';
+         continue;
+      }
+      len--;
+      if (len > (uint64_t)(end - *pos))
+         return false;
+      size_t copy = MINIMUM(len, sizeof(m->txtBuffer) - 1);
+      memcpy(m->txtBuffer, *pos, copy);
+      m->txtBuffer[copy] = '\0';
+      *pos += len;
+   }
+   return true;
+}
+
+static bool Snapshot_decodeColumns(Snapshot* this, const Snapshot* prev, const SnapshotCodec* codec, const int* match, const uint8_t** pos, const uint8_t* end) {
+   for (unsigned int c = 0; c < codec->nColumns; c++) {
+      int f = codec->columns[c];
+      int64_t* column = f >= 0 && !codec->isString[c] ? Snapshot_intColumn(this, f) : NULL;
+      SnapshotString** strings = f >= 0 && codec->isString[c] ? Snapshot_stringColumn(this, f) : NULL;
+
+      for (unsigned int i = 0; f >= 0 && i < this->nRows; i++) {
+         if (column)
+            column[i] = match[i] >= 0 ? Snapshot_intColumn(prev, f)[match[i]] : 0;
+         else
+            strings[i] = match[i] >= 0 ? SnapshotString_ref(Snapshot_stringColumn(prev, f)[match[i]]) : NULL;
+      }
+
+      for (uint64_t i = 0; i < this->nRows; i++) {
+         uint64_t run, value;
+         if (!Snapshot_getVarint(pos, end, &run) || run > this->nRows - i)
+            return false;
+         i += run;
+         if (i == this->nRows)
+            break;
+         if (!Snapshot_getVarint(pos, end, &value))
+            return false;
+
+         if (!codec->isString[c]) {
+            if (column)
+               column[i] = (int64_t)((uint64_t)column[i] + unzigzag(value));
+            continue;
+         }
+
+         if (value > (uint64_t)(end - *pos) + 1)
+            return false;
+         if (strings) {
+            SnapshotString_unref(strings[i]);
+            strings[i] = value ? SnapshotString_new((const char*)*pos, value - 1) : NULL;
+         }
+         if (value)
+            *pos += value - 1;
+      }
+   }
+   return true;
+}
+
+bool Snapshot_decode(Snapshot* this, const Snapshot* prev, const SnapshotCodec* codec, const uint8_t* data, size_t len) {
+   Snapshot_clear(this);
+
+   const uint8_t* pos = data;
+   const uint8_t* end = data + len;
+   uint64_t n;
+
+   if (!Snapshot_getVarint(&pos, end, &n))
+      return false;
+   for (uint64_t g = 0; g < MAXIMUM(n, (uint64_t)SNAPSHOT_GLOBALS); g++) {
+      uint64_t delta = 0;
+      if (g < n && !Snapshot_getVarint(&pos, end, &delta))
+         return false;
+      if (g < SNAPSHOT_GLOBALS)
+         this->globals[g] = g < n ? (int64_t)((uint64_t)(prev ? prev->globals[g] : 0) + unzigzag(delta)) : 0;
+   }
+
+   // every row takes at least one byte for its pid
+   if (!Snapshot_getVarint(&pos, end, &n) || n > (uint64_t)(end - pos))
+      return false;
+   Snapshot_reserve(this, n);
+   // the rows are merged by pid and those of agents get their host above the
+   // pid bits, so anything but ascending pids below PROCESS_HOST_SHIFT is corrupt
+   pid_t last = 0;
+   for (uint64_t i = 0; i < n; i++) {
+      uint64_t delta;
+      if (!Snapshot_getVarint(&pos, end, &delta))
+         return false;
+      int64_t pid = (int64_t)((uint64_t)(int64_t)last + unzigzag(delta));
+      if (pid <= last || pid >= (int64_t)1 << PROCESS_HOST_SHIFT)
+         return false;
+      last = (pid_t)pid;
+      this->pids[i] = last;
+   }
+   for (unsigned int f = 0; f < Snapshot_layout.nFields; f++) {
+      if (Snapshot_isString(f))
+         memset(Snapshot_stringColumn(this, f), 0, n * sizeof(SnapshotString*));
+      else
+         memset(Snapshot_intColumn(this, f), 0, n * sizeof(int64_t));
+   }
+   this->nRows = n;
+
+   int* match = Snapshot_match(this, prev);
+   bool ok = Snapshot_decodeColumns(this, prev, codec, match, &pos, end)
+          && Snapshot_decodeMeters(this, prev, &pos, end);
+   free(match);
+
+   if (!ok)
+      Snapshot_clear(this);
+   return ok;
+}
@@ -0,0 +1,173 @@
+#ifndef HEADER_Snapshot
+#define HEADER_Snapshot
+/*
+htop - Snapshot.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "Header.h"
+#include "Meter.h"
+#include "Process.h"
+#include "ProcessList.h"
+
+
+#define SNAPSHOT_MAX_FIELDS 96
+#define SNAPSHOT_METER_NAME_LEN 32
+#define SNAPSHOT_FRAME_HEADER_SIZE 16
+#define SNAPSHOT_FRAME_KEY 0x1
+
+/* How a NaN of a SNAPSHOT_REAL field is stored */
+#define SNAPSHOT_NAN INT64_MIN
+
+typedef enum SnapshotFieldType_ {
+   SNAPSHOT_INT,       /* signed integer, char or bool of any width */
+   SNAPSHOT_UINT,      /* unsigned integer of any width */
+   SNAPSHOT_REAL,      /* float or double, kept in hundredths */
+   SNAPSHOT_STRING,    /* heap allocated char*, may be NULL */
+} SnapshotFieldType;
+
+/* A member of a process (or process list) structure that is carried in snapshots */
+typedef struct SnapshotField_ {
+   const char* name;
+   size_t offset;
+   size_t size;
+   SnapshotFieldType type;
+   bool restricted;           /* read from a file that needs ptrace access to the process */
+   int64_t unreadable;        /* stored value of a restricted field when that access is denied */
+} SnapshotField;
+
+#define SNAPSHOT_FIELD(type_, member_, kind_) \
+   { .name = #member_, .offset = offsetof(type_, member_), .size = sizeof(((type_*)0)->member_), .type = (kind_) }
+
+#define SNAPSHOT_RESTRICTED_FIELD(type_, member_, kind_, unreadable_) \
+   { .name = #member_, .offset = offsetof(type_, member_), .size = sizeof(((type_*)0)->member_), .type = (kind_), .restricted = true, .unreadable = (unreadable_) }
+
+/* Platform specific part of a process snapshot, see Platform_snapshotLayout */
+typedef struct SnapshotLayout_ {
+   Process_New newProcess;
+   const SnapshotField* fields;
+   unsigned int nFields;
+} SnapshotLayout;
+
+typedef struct SnapshotBuffer_ {
+   uint8_t* data;
+   size_t size;
+   size_t capacity;
+} SnapshotBuffer;
+
+/* Strings are shared between consecutive snapshots as long as they do not change */
+typedef struct SnapshotString_ {
+   unsigned int refs;
+   unsigned int len;
+   char text[];
+} SnapshotString;
+
+typedef struct SnapshotMeter_ {
+   char name[SNAPSHOT_METER_NAME_LEN];
+   unsigned int param;
+   uint8_t curItems;
+   double total;
+   double* values;
+   unsigned int valuesCapacity;
+   char txtBuffer[METER_TXTBUFFER_LEN];
+} SnapshotMeter;
+
+/*
+ * One scan of the process table and the header meters.  Process data is
+ * kept in columns indexed by row, rows are sorted by pid so two snapshots
+ * can be compared with a merge join.
+ */
+typedef struct Snapshot_ {
+   uint64_t realtimeMs;
+   int64_t* globals;
+   unsigned int nRows;
+   unsigned int capacity;
+   pid_t* pids;
+   int64_t* values;              /* integer columns, capacity entries each */
+   SnapshotString** strings;     /* string columns, capacity entries each */
+   unsigned int nMeters;
+   unsigned int metersCapacity;
+   SnapshotMeter* meters;
+} Snapshot;
+
+/* Maps the columns of an encoded stream onto the fields of this build */
+typedef struct SnapshotCodec_ {
+   unsigned int nColumns;
+   int columns[SNAPSHOT_MAX_FIELDS];        /* local field of every stream column, -1 if unknown */
+   bool isString[SNAPSHOT_MAX_FIELDS];
+   bool present[SNAPSHOT_MAX_FIELDS];       /* local fields carried by the stream */
+   unsigned int nGlobals;
+} SnapshotCodec;
+
+void SnapshotBuffer_init(SnapshotBuffer* this);
+
+void SnapshotBuffer_done(SnapshotBuffer* this);
+
+/* Makes room for len more bytes and returns where they go; size is not changed */
+uint8_t* SnapshotBuffer_reserve(SnapshotBuffer* this, size_t len);
+
+void SnapshotBuffer_append(SnapshotBuffer* this, const void* data, size_t len);
+
+void SnapshotBuffer_putVarint(SnapshotBuffer* this, uint64_t value);
+
+bool Snapshot_getVarint(const uint8_t** pos, const uint8_t* end, uint64_t* value);
+
+static inline void SnapshotBuffer_reset(SnapshotBuffer* this) {
+   this->size = 0;
+}
+
+Snapshot* Snapshot_new(void);
+
+void Snapshot_delete(Snapshot* this);
+
+void Snapshot_clear(Snapshot* this);
+
+unsigned int Snapshot_fieldCount(void);
+
+const SnapshotField* Snapshot_field(unsigned int field);
+
+int Snapshot_fieldIndex(const char* name);
+
+int64_t Snapshot_value(const Snapshot* this, unsigned int row, unsigned int field);
+
+const char* Snapshot_string(const Snapshot* this, unsigned int row, unsigned int field);
+
+int Snapshot_findRow(const Snapshot* this, pid_t pid);
+
+size_t Snapshot_memoryUsage(const Snapshot* this);
+
+void Snapshot_capture(Snapshot* this, const Snapshot* prev, const ProcessList* pl, const Header* header);
+
+/* Adds the rows of other with pidBase or-ed into their pids, parents and
+ * thread groups; pidBase takes bits above those of any pid and must be
+ * above all rows already present.  The totals and meters are those of the
+ * first snapshot appended after Snapshot_clear */
+void Snapshot_append(Snapshot* this, const Snapshot* other, pid_t pidBase);
+
+/* Sets the restricted fields of all rows to what a user without ptrace access would read */
+void Snapshot_dropRestricted(Snapshot* this);
+
+void Snapshot_restoreProcesses(const Snapshot* this, ProcessList* pl);
+
+void Snapshot_restoreMeters(const Snapshot* this, Header* header);
+
+void Snapshot_writeLayout(SnapshotBuffer* out);
+
+bool SnapshotCodec_init(SnapshotCodec* this, const uint8_t* data, size_t len);
+
+void Snapshot_encode(const Snapshot* this, const Snapshot* prev, SnapshotBuffer* out);
+
+bool Snapshot_decode(Snapshot* this, const Snapshot* prev, const SnapshotCodec* codec, const uint8_t* data, size_t len);
+
+void Snapshot_putFrameHeader(uint8_t* out, uint32_t size, uint32_t flags, uint64_t realtimeMs);
+
+void Snapshot_getFrameHeader(const uint8_t* in, uint32_t* size, uint32_t* flags, uint64_t* realtimeMs);
+
+#endif
@@ -0,0 +1,203 @@
+/*
+htop - Socket.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "Socket.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "XUtils.h"
+
+
+#define SOCKET_BACKLOG 16
+#define SOCKET_DEFAULT_HOST "127.0.0.1"
+
+static bool Socket_setFlags(int fd) {
+   int flags = fcntl(fd, F_GETFL);
+   return flags >= 0
+      && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0
+      && fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+}
+
+static int Socket_fail(int fd, int err) {
+   if (fd >= 0)
+      close(fd);
+   errno = err;
+   return -1;
+}
+
+static bool Socket_unixAddress(struct sockaddr_un* addr, const char* path) {
+   memset(addr, 0, sizeof(*addr));
+   addr->sun_family = AF_UNIX;
+   if (strlen(path) >= sizeof(addr->sun_path)) {
+      errno = ENAMETOOLONG;
+      return false;
+   }
+   String_safeStrncpy(addr->sun_path, path, sizeof(addr->sun_path));
+   return true;
+}
+
+static int Socket_listenUnix(const char* path) {
+   struct sockaddr_un addr;
+   if (!Socket_unixAddress(&addr, path))
+      return -1;
+
+   int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (fd < 0)
+      return -1;
+
+   // a socket file left behind by a process that is gone is replaced
+   struct stat sb;
+   if (lstat(path, &sb) == 0 && S_ISSOCK(sb.st_mode)) {
+      if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0)
+         return Socket_fail(fd, EADDRINUSE);
+      if (errno == ECONNREFUSED)
+         unlink(path);
+      close(fd);
+      fd = socket(AF_UNIX, SOCK_STREAM, 0);
+      if (fd < 0)
+         return -1;
+   }
+
+   if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, SOCKET_BACKLOG) < 0 || !Socket_setFlags(fd))
+      return Socket_fail(fd, errno);
+   return fd;
+}
+
+/* Resolves [HOST:]PORT, the result is released with freeaddrinfo() */
+static struct addrinfo* Socket_resolve(const char* address, int flags) {
+   char host[256];
+   const char* port;
+   const char* colon = strrchr(address, ':');
+   if (address[0] == '[') {
+      const char* end = strchr(address, ']');
+      if (!end || end[1] != ':' || (size_t)(end - address) > sizeof(host)) {
+         errno = EINVAL;
+         return NULL;
+      }
+      String_safeStrncpy(host, address + 1, end - address);
+      port = end + 2;
+   } else if (colon) {
+      if ((size_t)(colon - address) >= sizeof(host)) {
+         errno = EINVAL;
+         return NULL;
+      }
+      String_safeStrncpy(host, colon == address ? SOCKET_DEFAULT_HOST : address, colon == address ? sizeof(host) : (size_t)(colon - address) + 1);
+      port = colon + 1;
+   } else {
+      String_safeStrncpy(host, SOCKET_DEFAULT_HOST, sizeof(host));
+      port = address;
+   }
+
+   struct addrinfo hints;
+   memset(&hints, 0, sizeof(hints));
+   hints.ai_family = AF_UNSPEC;
+   hints.ai_socktype = SOCK_STREAM;
+   hints.ai_flags = flags | AI_NUMERICSERV;
+   struct addrinfo* info;
+   if (getaddrinfo(host, port, &hints, &info) != 0) {
+      errno = EADDRNOTAVAIL;
+      return NULL;
+   }
+   return info;
+}
+
+static int Socket_listenTcp(const char* address) {
+   struct addrinfo* info = Socket_resolve(address, AI_PASSIVE);
+   if (!info)
+      return -1;
+
+   int fd = -1;
+   int err = EADDRNOTAVAIL;
+   for (const struct addrinfo* ai = info; ai; ai = ai->ai_next) {
+      fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+      if (fd < 0) {
+         err = errno;
+         continue;
+      }
+
+      int one = 1;
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+      if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 && listen(fd, SOCKET_BACKLOG) == 0 && Socket_setFlags(fd))
+         break;
+
+      err = errno;
+      close(fd);
+      fd = -1;
+   }
+   freeaddrinfo(info);
+
+   return fd >= 0 ? fd : Socket_fail(-1, err);
+}
+
+int Socket_listen(const char* address) {
+   if (Socket_isUnixAddress(address))
+      return Socket_listenUnix(address);
+   return Socket_listenTcp(address);
+}
+
+int Socket_connect(const char* address) {
+   if (Socket_isUnixAddress(address)) {
+      struct sockaddr_un addr;
+      if (!Socket_unixAddress(&addr, address))
+         return -1;
+
+      int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+      if (fd < 0)
+         return -1;
+      if (!Socket_setFlags(fd) || (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS && errno != EAGAIN))
+         return Socket_fail(fd, errno);
+      return fd;
+   }
+
+   struct addrinfo* info = Socket_resolve(address, 0);
+   if (!info)
+      return -1;
+
+   // only the first address is tried, the connection completes in the background
+   int fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+   int err = errno;
+   if (fd >= 0 && (!Socket_setFlags(fd) || (connect(fd, info->ai_addr, info->ai_addrlen) < 0 && errno != EINPROGRESS))) {
+      err = errno;
+      close(fd);
+      fd = -1;
+   }
+   freeaddrinfo(info);
+
+   if (fd < 0)
+      errno = err;
+   return fd;
+}
+
+void Socket_close(int fd, const char* address) {
+   if (fd < 0)
+      return;
+
+   close(fd);
+   if (Socket_isUnixAddress(address))
+      unlink(address);
+}
+
+int Socket_accept(int fd) {
+   int client = accept(fd, NULL, NULL);
+   if (client < 0)
+      return -1;
+
+   if (!Socket_setFlags(client)) {
+      close(client);
+      return -1;
+   }
+   return client;
+}
@@ -0,0 +1,39 @@
+#ifndef HEADER_Socket
+#define HEADER_Socket
+/*
+htop - Socket.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+
+
+/*
+ * Addresses are either the path of a UNIX socket (anything containing a
+ * slash) or [HOST:]PORT for TCP, with HOST defaulting to the loopback
+ * address.  IPv6 hosts are written in brackets, e.g. [::1]:9100.
+ */
+
+static inline bool Socket_isUnixAddress(const char* address) {
+   for (; *address; address++)
+      if (*address == '/')
+         return true;
+   return false;
+}
+
+/* Returns a non-blocking listening socket, or -1 with errno set */
+int Socket_listen(const char* address);
+
+/* Starts connecting a non-blocking socket, which is writable once the
+ * connection is made; returns -1 with errno set if it failed right away */
+int Socket_connect(const char* address);
+
+/* Closes a listening socket and removes the file of a UNIX socket */
+void Socket_close(int fd, const char* address);
+
+/* Accepts a pending connection as a non-blocking socket, -1 if there is none */
+int Socket_accept(int fd);
+
+#endif
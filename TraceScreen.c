@@ -11,6 +11,7 @@ in the source distribution for its full text.
 
 #include <assert.h>
 #include <fcntl.h>
+#include <inttypes.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -24,16 +25,24 @@ in the source distribution for its full text.
 #include "CRT.h"
 #include "FunctionBar.h"
 #include "IncSet.h"
+#include "ListItem.h"
+#include "Macros.h"
 #include "Panel.h"
+#include "Platform.h"
 #include "ProvideCurses.h"
 #include "XUtils.h"
 
 
-static const char* const TraceScreenFunctions[] = {"Ara ", "Filtre ", "Otomatik kaydırma ", "İzlemeyi Durdur   ", "Tamam   ", NULL};
+static const char* const TraceScreenFunctions[] = {"Ara ", "Filtre ", "Özet      ", "Otomatik kaydırma ", "İzlemeyi Durdur   ", "Tamam   ", NULL};
 
-static const char* const TraceScreenKeys[] = {"F3", "F4", "F8", "F9", "Esc"};
+static const char* const TraceScreenKeys[] = {"F3", "F4", "F7", "F8", "F9", "Esc"};
 
-static const int TraceScreenEvents[] = {KEY_F(3), KEY_F(4), KEY_F(8), KEY_F(9), 27};
+static const int TraceScreenEvents[] = {KEY_F(3), KEY_F(4), KEY_F(7), KEY_F(8), KEY_F(9), 27};
+
+#define TRACE_SUMMARY_HEADER "SYSCALL                   CALLS   ERRORS      TOTAL s     AVG us     MAX us    <1us   <10us  <100us    <1ms   <10ms  <100ms     <1s    >=1s  LAST ERROR"
+
+/* The summary is rebuilt at most this often while the trace runs */
+#define TRACE_SUMMARY_INTERVAL_MS 1000
 
 TraceScreen* TraceScreen_new(const Process* process) {
    // This initializes all TraceScreen variables to "false" so only default = true ones need to be set below
@@ -42,7 +51,10 @@ TraceScreen* TraceScreen_new(const Process* process) {
    this->tracing = true;
    FunctionBar* fuBar = FunctionBar_new(TraceScreenFunctions, TraceScreenKeys, TraceScreenEvents);
    CRT_disableDelay();
-   return (TraceScreen*) InfoScreen_init(&this->super, process, fuBar, LINES - 2, " ");
+   InfoScreen_init(&this->super, process, fuBar, LINES - 2, " ");
+   this->tail = this->super.lines;
+   this->summaryLines = Vector_new(Class(ListItem), true, DEFAULT_SIZE);
+   return this;
 }
 
 void TraceScreen_delete(Object* cast) {
@@ -56,12 +68,20 @@ void TraceScreen_delete(Object* cast) {
       fclose(this->strace);
    }
 
+   // the vector not shown is not known to the InfoScreen
+   Vector_delete(this->summary ? this->tail : this->summaryLines);
+
    CRT_enableDelay();
    free(InfoScreen_done((InfoScreen*)this));
 }
 
-static void TraceScreen_draw(InfoScreen* this) {
-   InfoScreen_drawTitled(this, "Trace of process %d - %s", this->process->pid, Process_getCommand(this->process));
+static void TraceScreen_draw(InfoScreen* super) {
+   const TraceScreen* this = (const TraceScreen*) super;
+   if (this->summary) {
+      InfoScreen_drawTitled(super, "System call summary of process %d - %s", super->process->pid, Process_getCommand(super->process));
+   } else {
+      InfoScreen_drawTitled(super, "Trace of process %d - %s", super->process->pid, Process_getCommand(super->process));
+   }
 }
 
 bool TraceScreen_forkTracer(TraceScreen* this) {
@@ -114,6 +134,184 @@ err:
    return false;
 }
 
+static TraceSyscall* TraceScreen_syscall(TraceScreen* this, const char* name, size_t len) {
+   unsigned int hash = 5381;
+   for (size_t i = 0; i < len; i++)
+      hash = hash * 33 + (unsigned char)name[i];
+
+   for (unsigned int slot = hash & (TRACE_SYSCALL_SLOTS - 1);; slot = (slot + 1) & (TRACE_SYSCALL_SLOTS - 1)) {
+      TraceSyscall* syscall = &this->syscalls[slot];
+      if (syscall->name[0] == '\0') {
+         // keep the last slot for all names that did not fit
+         if (this->nSyscalls >= TRACE_SYSCALL_SLOTS - 2 && !(len == 1 && name[0] == '?'))
+            return TraceScreen_syscall(this, "?", 1);
+
+         memcpy(syscall->name, name, len);
+         syscall->name[len] = '\0';
+         this->nSyscalls++;
+         return syscall;
+      }
+      if (strncmp(syscall->name, name, len) == 0 && syscall->name[len] == '\0')
+         return syscall;
+   }
+}
+
+/*
+ * Accounts one line of strace -tt -T output, which looks like
+ *   12:00:00.000001 read(3, "..."..., 512) = 512 <0.000010>
+ *   12:00:00.000001 open("/x", O_RDONLY) = -1 ENOENT (No such file or directory) <0.000005>
+ *   12:00:00.000001 <... read resumed>"...", 512) = 512 <0.000010>
+ * Signals, exits, calls that did not finish yet and messages of strace have no latency and are skipped.
+ */
+static void TraceScreen_account(TraceScreen* this, const char* line) {
+   const char* name = strchr(line, ' ');
+   if (!name)
+      return;
+   name++;
+
+   bool resumed = String_startsWith(name, "<... ");
+   if (resumed)
+      name += strlen("<... ");
+
+   size_t len = strspn(name, "abcdefghijklmnopqrstuvwxyz0123456789_");
+   if (len == 0 || len >= sizeof(this->syscalls[0].name) || name[len] != (resumed ? ' ' : '('))
+      return;
+
+   const char* latency = strrchr(name, '<');
+   if (!latency)
+      return;
+   char* end;
+   double time = strtod(latency + 1, &end);
+   if (end == latency + 1 || *end != '>' || time < 0)
+      return;
+
+   const char* result = NULL;
+   for (const char* next = strstr(name, " = "); next && next < latency; next = strstr(next + 1, " = "))
+      result = next + strlen(" = ");
+   if (!result)
+      return;
+
+   TraceSyscall* syscall = TraceScreen_syscall(this, name, len);
+   syscall->calls++;
+   syscall->totalTime += time;
+   syscall->maxTime = MAXIMUM(syscall->maxTime, time);
+
+   int bucket = 0;
+   for (double limit = 1e-6; bucket < TRACE_LATENCY_BUCKETS - 1 && time >= limit; limit *= 10)
+      bucket++;
+   syscall->latency[bucket]++;
+
+   // the errno name follows the return value, e.g. "-1 ENOENT (...)" or "? ERESTARTSYS (...)"
+   const char* error = strchr(result, ' ');
+   if (error && error < latency && error[1] == 'E') {
+      error++;
+      size_t errorLen = strspn(error, "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_");
+      if (errorLen > 1 && errorLen < sizeof(syscall->lastError)) {
+         syscall->errors++;
+         memcpy(syscall->lastError, error, errorLen);
+         syscall->lastError[errorLen] = '\0';
+      }
+   }
+
+   this->summaryChanged = true;
+}
+
+static int TraceSyscall_compareByTime(const void* v1, const void* v2) {
+   const TraceSyscall* s1 = *(const TraceSyscall* const*)v1;
+   const TraceSyscall* s2 = *(const TraceSyscall* const*)v2;
+   if (s1->totalTime < s2->totalTime)
+      return 1;
+   if (s1->totalTime > s2->totalTime)
+      return -1;
+   if (s1->calls != s2->calls)
+      return s1->calls < s2->calls ? 1 : -1;
+   return strcmp(s1->name, s2->name);
+}
+
+static void TraceScreen_buildSummary(TraceScreen* this) {
+   Panel* panel = this->super.display;
+   int idx = Panel_getSelectedIndex(panel);
+   Panel_prune(panel);
+   Vector_prune(this->summaryLines);
+
+   const TraceSyscall* sorted[TRACE_SYSCALL_SLOTS];
+   unsigned int n = 0;
+   for (unsigned int i = 0; i < TRACE_SYSCALL_SLOTS; i++) {
+      if (this->syscalls[i].name[0])
+         sorted[n++] = &this->syscalls[i];
+   }
+   qsort(sorted, n, sizeof(sorted[0]), TraceSyscall_compareByTime);
+
+   if (n == 0)
+      InfoScreen_addLine(&this->super, "Henüz tamamlanan sistem çağrısı yok.");
+
+   for (unsigned int i = 0; i < n; i++) {
+      const TraceSyscall* syscall = sorted[i];
+      char entry[256];
+      int len = xSnprintf(entry, sizeof(entry), "%-20s %10"PRIu64" %8"PRIu64" %12.6f %10.1f %10.1f ",
+         syscall->name, syscall->calls, syscall->errors, syscall->totalTime,
+         syscall->totalTime * 1e6 / syscall->calls, syscall->maxTime * 1e6);
+      for (int b = 0; b < TRACE_LATENCY_BUCKETS; b++)
+         len += xSnprintf(entry + len, sizeof(entry) - len, "%7"PRIu64" ", syscall->latency[b]);
+      xSnprintf(entry + len, sizeof(entry) - len, " %s", syscall->lastError);
+      InfoScreen_addLine(&this->super, entry);
+   }
+
+   Panel_setSelected(panel, idx);
+   this->summaryChanged = false;
+   Platform_gettime_monotonic(&this->summaryMs);
+}
+
+/* Shows the raw lines of the tail that pass the filter */
+static void TraceScreen_fillPanel(TraceScreen* this) {
+   Panel* panel = this->super.display;
+   Panel_prune(panel);
+   const char* incFilter = IncSet_filter(this->super.inc);
+   for (int i = 0; i < Vector_size(this->tail); i++) {
+      ListItem* item = (ListItem*) Vector_get(this->tail, i);
+      if (!incFilter || String_contains_i(item->value, incFilter))
+         Panel_add(panel, (Object*) item);
+   }
+}
+
+/* Drops the oldest raw lines in one go once the tail has grown a quarter past its size */
+static void TraceScreen_trimTail(TraceScreen* this) {
+   int excess = Vector_size(this->tail) - TRACE_TAIL_LINES;
+   if (excess < TRACE_TAIL_LINES / 4)
+      return;
+
+   Vector_removeFirst(this->tail, excess);
+   if (this->summary)
+      return;
+
+   Panel* panel = this->super.display;
+   int idx = Panel_getSelectedIndex(panel);
+   TraceScreen_fillPanel(this);
+   Panel_setSelected(panel, idx - excess);
+}
+
+static void TraceScreen_addLine(TraceScreen* this, const char* line, bool complete) {
+   if (this->contLine) {
+      if (this->summary) {
+         ListItem_append((ListItem*) Vector_get(this->tail, Vector_size(this->tail) - 1), line);
+      } else {
+         InfoScreen_appendLine(&this->super, line);
+      }
+   } else {
+      if (this->summary) {
+         Vector_add(this->tail, ListItem_new(line, 0));
+      } else {
+         InfoScreen_addLine(&this->super, line);
+      }
+   }
+
+   this->contLine = !complete;
+   if (complete) {
+      const ListItem* last = (const ListItem*) Vector_get(this->tail, Vector_size(this->tail) - 1);
+      TraceScreen_account(this, last->value);
+   }
+}
+
 static void TraceScreen_updateTrace(InfoScreen* super) {
    TraceScreen* this = (TraceScreen*) super;
    char buffer[1025];
@@ -139,29 +337,51 @@ static void TraceScreen_updateTrace(InfoScreen* super) {
       for (size_t i = 0; i < nread; i++) {
          if (buffer[i] == '\n') {
             buffer[i] = '\0';
-            if (this->contLine) {
-               InfoScreen_appendLine(&this->super, line);
-               this->contLine = false;
-            } else {
-               InfoScreen_addLine(&this->super, line);
-            }
+            TraceScreen_addLine(this, line, true);
             line = buffer + i + 1;
          }
       }
       if (line < buffer + nread) {
-         InfoScreen_addLine(&this->super, line);
-         buffer[nread] = '\0';
-         this->contLine = true;
+         TraceScreen_addLine(this, line, false);
       }
-      if (this->follow) {
+      TraceScreen_trimTail(this);
+      if (this->follow && !this->summary) {
          Panel_setSelected(this->super.display, Panel_size(this->super.display) - 1);
       }
    }
+
+   if (this->summary && this->summaryChanged) {
+      uint64_t now;
+      Platform_gettime_monotonic(&now);
+      if (now - this->summaryMs >= TRACE_SUMMARY_INTERVAL_MS)
+         TraceScreen_buildSummary(this);
+   }
+}
+
+static void TraceScreen_showSummary(TraceScreen* this, bool summary) {
+   Panel* panel = this->super.display;
+   this->summary = summary;
+   this->super.lines = summary ? this->summaryLines : this->tail;
+   FunctionBar_setLabel(panel->defaultBar, KEY_F(7), summary ? "Canlı akış" : "Özet      ");
+   Panel_setHeader(panel, summary ? TRACE_SUMMARY_HEADER : " ");
+
+   if (summary) {
+      TraceScreen_buildSummary(this);
+      Panel_setSelected(panel, 0);
+   } else {
+      TraceScreen_fillPanel(this);
+      Panel_setSelected(panel, this->follow ? Panel_size(panel) - 1 : 0);
+   }
+   InfoScreen_draw(this);
 }
 
 static bool TraceScreen_onKey(InfoScreen* super, int ch) {
    TraceScreen* this = (TraceScreen*) super;
    switch(ch) {
+      case 's':
+      case KEY_F(7):
+         TraceScreen_showSummary(this, !this->summary);
+         return true;
       case 'f':
       case KEY_F(8):
          this->follow = !(this->follow);
@@ -8,14 +8,35 @@ in the source distribution for its full text.
 */
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <sys/types.h>
 
 #include "InfoScreen.h"
 #include "Object.h"
 #include "Process.h"
+#include "Vector.h"
 
 
+/* Raw lines of the trace that are kept, older ones are dropped */
+#define TRACE_TAIL_LINES 5000
+
+/* Size of the system call table, a power of two well above the number of system calls */
+#define TRACE_SYSCALL_SLOTS 1024
+
+/* Latency decades from below 1us up to 1s and more */
+#define TRACE_LATENCY_BUCKETS 8
+
+typedef struct TraceSyscall_ {
+   char name[24];             /* empty for an unused slot */
+   char lastError[16];        /* errno name of the last failed call */
+   uint64_t calls;
+   uint64_t errors;
+   double totalTime;          /* seconds spent in the call, as reported by strace -T */
+   double maxTime;
+   uint64_t latency[TRACE_LATENCY_BUCKETS];
+} TraceSyscall;
+
 typedef struct TraceScreen_ {
    InfoScreen super;
    bool tracing;
@@ -23,6 +44,13 @@ typedef struct TraceScreen_ {
    FILE* strace;
    bool contLine;
    bool follow;
+   bool summary;              /* showing the system call summary instead of the trace */
+   Vector* tail;              /* the last raw lines, super.lines while the trace is shown */
+   Vector* summaryLines;      /* super.lines while the summary is shown */
+   bool summaryChanged;
+   uint64_t summaryMs;        /* when the summary was last built */
+   unsigned int nSyscalls;
+   TraceSyscall syscalls[TRACE_SYSCALL_SLOTS];
 } TraceScreen;
 
 
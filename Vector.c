@@ -232,6 +232,18 @@ Object* Vector_take(Vector* this, int idx) {
    return removed;
 }
 
+void Vector_removeFirst(Vector* this, int n) {
+   assert(n >= 0 && n <= this->items);
+   assert(Vector_isConsistent(this));
+   if (this->owner) {
+      for (int i = 0; i < n; i++)
+         Object_delete(this->array[i]);
+   }
+   this->items -= n;
+   memmove(&this->array[0], &this->array[n], this->items * sizeof(this->array[0]));
+   assert(Vector_isConsistent(this));
+}
+
 Object* Vector_remove(Vector* this, int idx) {
    Object* removed = Vector_take(this, idx);
    if (this->owner) {
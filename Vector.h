@@ -44,6 +44,9 @@ Object* Vector_take(Vector* this, int idx);
 
 Object* Vector_remove(Vector* this, int idx);
 
+/* Removes the first n items at once, deleting them if the vector owns them */
+void Vector_removeFirst(Vector* this, int n);
+
 void Vector_moveUp(Vector* this, int idx);
 
 void Vector_moveDown(Vector* this, int idx);
@@ -19,6 +19,7 @@ in the source distribution for its full text.
 #include <unistd.h>
 
 #include "CRT.h"
+#include "Profile.h"
 
 
 void fail() {
@@ -34,6 +35,7 @@ void* xMalloc(size_t size) {
    if (!data) {
       fail();
    }
+   Profile_count(PROFILE_ALLOCATIONS, 1);
    return data;
 }
 
@@ -56,6 +58,7 @@ void* xCalloc(size_t nmemb, size_t size) {
    if (!data) {
       fail();
    }
+   Profile_count(PROFILE_ALLOCATIONS, 1);
    return data;
 }
 
@@ -66,6 +69,7 @@ void* xRealloc(void* ptr, size_t size) {
       free(ptr);
       fail();
    }
+   Profile_count(PROFILE_ALLOCATIONS, 1);
    return data;
 }
 
@@ -215,6 +219,7 @@ int xAsprintf(char** strp, const char* fmt, ...) {
       fail();
    }
 
+   Profile_count(PROFILE_ALLOCATIONS, 1);
    return r;
 }
 
@@ -236,6 +241,7 @@ char* xStrdup(const char* str) {
    if (!data) {
       fail();
    }
+   Profile_count(PROFILE_ALLOCATIONS, 1);
    return data;
 }
 
@@ -252,6 +258,7 @@ char* xStrndup(const char* str, size_t len) {
    if (!data) {
       fail();
    }
+   Profile_count(PROFILE_ALLOCATIONS, 1);
    return data;
 }
 
@@ -283,6 +290,8 @@ static ssize_t readfd_internal(int fd, void* buffer, size_t count) {
       if (count == 0 || res == 0) {
          close(fd);
          *((char*)buffer) = '\0';
+         Profile_count(PROFILE_FILES_OPENED, 1);
+         Profile_count(PROFILE_BYTES_READ, (uint64_t)alreadyRead);
          return alreadyRead;
       }
    }
@@ -303,3 +312,26 @@ ssize_t xReadfileat(openat_arg_t dirfd, const char* pathname, void* buffer, size
 
    return readfd_internal(fd, buffer, count);
 }
+
+ssize_t full_write(int fd, const void* buf, size_t count) {
+   ssize_t written = 0;
+
+   while (count > 0) {
+      ssize_t r = write(fd, buf, count);
+      if (r < 0) {
+         if (errno == EINTR)
+            continue;
+
+         return r;
+      }
+
+      if (r == 0)
+         break;
+
+      written += r;
+      buf = (const unsigned char*)buf + r;
+      count -= (size_t)r;
+   }
+
+   return written;
+}
@@ -30,6 +30,7 @@ in the source distribution for its full text.
 #include "Macros.h"
 #include "MemoryMeter.h"
 #include "ProcessLocksScreen.h"
+#include "ProfileMeter.h"
 #include "SwapMeter.h"
 #include "SysArchMeter.h"
 #include "TasksMeter.h"
@@ -100,6 +101,7 @@ const MeterClass* const Platform_meterTypes[] = {
    &HostnameMeter_class,
    &SysArchMeter_class,
    &UptimeMeter_class,
+   &ProfileMeter_class,
    &AllCPUsMeter_class,
    &AllCPUs2Meter_class,
    &AllCPUs4Meter_class,
@@ -112,12 +114,17 @@ const MeterClass* const Platform_meterTypes[] = {
    &RightCPUs4Meter_class,
    &LeftCPUs8Meter_class,
    &RightCPUs8Meter_class,
+   &CPUHeatmapMeter_class,
    &ZfsArcMeter_class,
    &ZfsCompressedArcMeter_class,
    &BlankMeter_class,
    NULL
 };
 
+const SnapshotLayout Platform_snapshotLayout = {
+   .newProcess = DarwinProcess_new,
+};
+
 double Platform_timebaseToNS = 1.0;
 
 long Platform_clockTicksPerSec = -1;
@@ -323,13 +330,19 @@ char* Platform_getProcessEnv(pid_t pid) {
    return env;
 }
 
-char* Platform_getInodeFilename(pid_t pid, ino_t inode) {
+FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
     (void)pid;
-    (void)inode;
     return NULL;
 }
 
-FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
+bool Platform_getProcessFiles(pid_t pid, const OpenFiles_ProcessData* previous, OpenFiles_ProcessData* pdata) {
+    (void)pid;
+    (void)previous;
+    (void)pdata;
+    return false;
+}
+
+FILE* Platform_openProcessSmaps(pid_t pid) {
     (void)pid;
     return NULL;
 }
@@ -11,6 +11,7 @@ in the source distribution for its full text.
 #include "Meter.h"
 #include "CPUMeter.h"
 #include "MemoryMeter.h"
+#include "ProfileMeter.h"
 #include "SwapMeter.h"
 #include "TasksMeter.h"
 #include "LoadAverageMeter.h"
@@ -84,6 +85,7 @@ const MeterClass* const Platform_meterTypes[] = {
    &SwapMeter_class,
    &TasksMeter_class,
    &UptimeMeter_class,
+   &ProfileMeter_class,
    &BatteryMeter_class,
    &HostnameMeter_class,
    &SysArchMeter_class,
@@ -99,10 +101,15 @@ const MeterClass* const Platform_meterTypes[] = {
    &RightCPUs4Meter_class,
    &LeftCPUs8Meter_class,
    &RightCPUs8Meter_class,
+   &CPUHeatmapMeter_class,
    &BlankMeter_class,
    NULL
 };
 
+const SnapshotLayout Platform_snapshotLayout = {
+   .newProcess = DragonFlyBSDProcess_new,
+};
+
 void Platform_init(void) {
    /* no platform-specific setup needed */
 }
@@ -218,13 +225,19 @@ char* Platform_getProcessEnv(pid_t pid) {
    return NULL;
 }
 
-char* Platform_getInodeFilename(pid_t pid, ino_t inode) {
+FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
     (void)pid;
-    (void)inode;
     return NULL;
 }
 
-FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
+bool Platform_getProcessFiles(pid_t pid, const OpenFiles_ProcessData* previous, OpenFiles_ProcessData* pdata) {
+    (void)pid;
+    (void)previous;
+    (void)pdata;
+    return false;
+}
+
+FILE* Platform_openProcessSmaps(pid_t pid) {
     (void)pid;
     return NULL;
 }
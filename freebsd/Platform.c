@@ -40,6 +40,7 @@ in the source distribution for its full text.
 #include "Meter.h"
 #include "NetworkIOMeter.h"
 #include "ProcessList.h"
+#include "ProfileMeter.h"
 #include "Settings.h"
 #include "SwapMeter.h"
 #include "SysArchMeter.h"
@@ -102,6 +103,7 @@ const MeterClass* const Platform_meterTypes[] = {
    &SwapMeter_class,
    &TasksMeter_class,
    &UptimeMeter_class,
+   &ProfileMeter_class,
    &BatteryMeter_class,
    &HostnameMeter_class,
    &SysArchMeter_class,
@@ -117,6 +119,7 @@ const MeterClass* const Platform_meterTypes[] = {
    &RightCPUs4Meter_class,
    &LeftCPUs8Meter_class,
    &RightCPUs8Meter_class,
+   &CPUHeatmapMeter_class,
    &BlankMeter_class,
    &ZfsArcMeter_class,
    &ZfsCompressedArcMeter_class,
@@ -125,6 +128,10 @@ const MeterClass* const Platform_meterTypes[] = {
    NULL
 };
 
+const SnapshotLayout Platform_snapshotLayout = {
+   .newProcess = FreeBSDProcess_new,
+};
+
 void Platform_init(void) {
    /* no platform-specific setup needed */
 }
@@ -266,13 +273,19 @@ char* Platform_getProcessEnv(pid_t pid) {
    return env;
 }
 
-char* Platform_getInodeFilename(pid_t pid, ino_t inode) {
+FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
     (void)pid;
-    (void)inode;
     return NULL;
 }
 
-FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
+bool Platform_getProcessFiles(pid_t pid, const OpenFiles_ProcessData* previous, OpenFiles_ProcessData* pdata) {
+    (void)pid;
+    (void)previous;
+    (void)pdata;
+    return false;
+}
+
+FILE* Platform_openProcessSmaps(pid_t pid) {
     (void)pid;
     return NULL;
 }
@@ -8,16 +8,20 @@ in the source distribution for its full text.
 */
 
 #include <stdbool.h>
+#include <stdio.h>
 #include <sys/types.h>
 
 #include "Action.h"
 #include "BatteryMeter.h"
 #include "DiskIOMeter.h"
+#include "Exporter.h"
 #include "Meter.h"
 #include "NetworkIOMeter.h"
 #include "Process.h"
+#include "OpenFilesScreen.h"
 #include "ProcessLocksScreen.h"
 #include "SignalsPanel.h"
+#include "Snapshot.h"
 #include "generic/gettime.h"
 #include "generic/hostname.h"
 #include "generic/uname.h"
@@ -31,6 +35,8 @@ extern const unsigned int Platform_numberOfSignals;
 
 extern const MeterClass* const Platform_meterTypes[];
 
+extern const SnapshotLayout Platform_snapshotLayout;
+
 void Platform_init(void);
 
 void Platform_done(void);
@@ -55,14 +61,20 @@ void Platform_setZfsCompressedArcValues(Meter* this);
 
 char* Platform_getProcessEnv(pid_t pid);
 
-char* Platform_getInodeFilename(pid_t pid, ino_t inode);
-
+/* The locks of process pid, or of all processes if pid is 0 */
 FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid);
 
+bool Platform_getProcessFiles(pid_t pid, const OpenFiles_ProcessData* previous, OpenFiles_ProcessData* pdata);
+
+/* The smaps listing of the memory mappings of process pid, NULL if there is none */
+FILE* Platform_openProcessSmaps(pid_t pid);
+
 bool Platform_getDiskIO(DiskIOData* data);
 
 bool Platform_getNetworkIO(NetworkIOData* data);
 
+static inline void Platform_exportMetrics(ATTR_UNUSED const ProcessList* pl, ATTR_UNUSED Exporter* out) { }
+
 void Platform_getBattery(double* percent, ACPresence* isOnAC);
 
 static inline void Platform_getHostname(char* buffer, size_t size) {
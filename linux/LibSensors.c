@@ -4,9 +4,17 @@
 
 #include <dlfcn.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <sensors/sensors.h>
 
+#include "Platform.h"
 #include "XUtils.h"
 
 
@@ -32,6 +40,43 @@ static void* dlopenHandle = NULL;
 
 #endif /* BUILD_STATIC */
 
+/*
+ * A temperature input of a CPU sensor, resolved once from the chips and
+ * features libsensors detected.  The value is read with pread from the
+ * hwmon file kept open in fd, or through libsensors if it can not be opened.
+ */
+typedef struct LibSensors_Temp_ {
+   const sensors_chip_name* chip;
+   int subfeature;
+   unsigned int index;        /* 0 for the package, 1 + core index for cores */
+   int fd;
+   bool dead;                 /* failed to read, skipped until the chips are detected again */
+} LibSensors_Temp;
+
+static LibSensors_Temp* temps = NULL;
+static size_t nTemps = 0;
+static size_t tempsCapacity = 0;
+
+/* How long inputs that failed to read are skipped before the chips are detected again */
+#define LIBSENSORS_RESCAN_INTERVAL_MS 60000
+
+/* The table is resolved on the first refresh, and again once an input vanished, the CPUs
+ * changed or some inputs stayed dead for the rescan interval */
+static bool tempsValid = false;
+static unsigned int tempsCpuCount = 0;
+static uint64_t tempsResolvedMs = 0;
+static size_t nDeadTemps = 0;
+
+static void LibSensors_forgetTemps(void) {
+   for (size_t i = 0; i < nTemps; i++) {
+      if (temps[i].fd >= 0)
+         close(temps[i].fd);
+   }
+   nTemps = 0;
+   nDeadTemps = 0;
+   tempsValid = false;
+}
+
 int LibSensors_init(FILE* input) {
 #ifdef BUILD_STATIC
 
@@ -83,6 +128,12 @@ dlfailure:
 }
 
 void LibSensors_cleanup(void) {
+   /* the chips of the table belong to libsensors */
+   LibSensors_forgetTemps();
+   free(temps);
+   temps = NULL;
+   tempsCapacity = 0;
+
 #ifdef BUILD_STATIC
 
    sym_sensors_cleanup();
@@ -120,18 +171,31 @@ static int tempDriverPriority(const sensors_chip_name* chip) {
    return -1;
 }
 
-void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int cpuCount) {
-   assert(cpuCount > 0 && cpuCount < 16384);
-   double data[cpuCount + 1];
-   for (size_t i = 0; i < cpuCount + 1; i++)
-      data[i] = NAN;
+static void LibSensors_addTemp(const sensors_chip_name* chip, const sensors_subfeature* subFeature, unsigned int index) {
+   if (nTemps == tempsCapacity) {
+      tempsCapacity = MAXIMUM(tempsCapacity * 2, 16);
+      temps = xReallocArray(temps, tempsCapacity, sizeof(LibSensors_Temp));
+   }
 
-#ifndef BUILD_STATIC
-   if (!dlopenHandle)
-      goto out;
-#endif /* !BUILD_STATIC */
+   LibSensors_Temp* temp = &temps[nTemps++];
+   temp->chip = chip;
+   temp->subfeature = subFeature->number;
+   temp->index = index;
+   temp->fd = -1;
+   temp->dead = false;
+
+   /* e.g. /sys/class/hwmon/hwmon2/temp1_input, in millidegrees */
+   if (chip->path && subFeature->name) {
+      char path[PATH_MAX];
+      if (snprintf(path, sizeof(path), "%s/%s", chip->path, subFeature->name) < (int)sizeof(path))
+         temp->fd = open(path, O_RDONLY | O_CLOEXEC);
+   }
+}
+
+/* Collects the temperature inputs of the CPU sensor chips with the best driver priority */
+static void LibSensors_resolveTemps(unsigned int cpuCount, uint64_t now) {
+   LibSensors_forgetTemps();
 
-   unsigned int coreTempCount = 0;
    int topPriority = 99;
 
    int n = 0;
@@ -144,9 +208,8 @@ void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int cpuCount) {
          continue;
 
       if (priority < topPriority) {
-         /* Clear data from lower priority sensor */
-         for (size_t i = 0; i < cpuCount + 1; i++)
-            data[i] = NAN;
+         /* Drop the inputs of lower priority sensors */
+         LibSensors_forgetTemps();
       }
 
       topPriority = priority;
@@ -173,20 +236,91 @@ void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int cpuCount) {
          if (!subFeature)
             continue;
 
-         double temp;
-         int r = sym_sensors_get_value(chip, subFeature->number, &temp);
-         if (r != 0)
-            continue;
+         LibSensors_addTemp(chip, subFeature, tempID);
+      }
+   }
+
+   tempsValid = true;
+   tempsCpuCount = cpuCount;
+   tempsResolvedMs = now;
+}
+
+/* Returns 0, or the errno of the failed read; EIO if there was no value */
+static int LibSensors_readTemp(const LibSensors_Temp* temp, double* value) {
+   if (temp->fd < 0)
+      return sym_sensors_get_value(temp->chip, temp->subfeature, value) == 0 ? 0 : EIO;
+
+   char buffer[32];
+   ssize_t len = pread(temp->fd, buffer, sizeof(buffer) - 1, 0);
+   if (len < 0)
+      return errno;
+   if (len == 0)
+      return EIO;
+   buffer[len] = '\0';
+
+   char* end;
+   long millidegrees = strtol(buffer, &end, 10);
+   if (end == buffer)
+      return EIO;
+
+   *value = millidegrees / 1000.0;
+   return 0;
+}
 
-         /* If already set, e.g. Ryzen reporting platform temperature for each die, use the bigger one */
-         if (isnan(data[tempID])) {
-            data[tempID] = temp;
-            if (tempID > 0)
-               coreTempCount++;
-         } else {
-            data[tempID] = MAXIMUM(data[tempID], temp);
-         }
+void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int cpuCount) {
+   assert(cpuCount > 0 && cpuCount < 16384);
+   double data[cpuCount + 1];
+   for (size_t i = 0; i < cpuCount + 1; i++)
+      data[i] = NAN;
+
+#ifndef BUILD_STATIC
+   if (!dlopenHandle)
+      goto out;
+#endif /* !BUILD_STATIC */
+
+   uint64_t now;
+   Platform_gettime_monotonic(&now);
+
+   if (!tempsValid || tempsCpuCount != cpuCount)
+      LibSensors_resolveTemps(cpuCount, now);
+
+   unsigned int coreTempCount = 0;
+
+   for (size_t i = 0; i < nTemps; i++) {
+      LibSensors_Temp* temp = &temps[i];
+      if (temp->dead)
+         continue;
+
+      double value;
+      int err = LibSensors_readTemp(temp, &value);
+      if (err) {
+         /* A single failing input is skipped; only a vanished sensor, e.g. of an unloaded
+            module, has the chips detected again on the next refresh */
+         temp->dead = true;
+         nDeadTemps++;
+         if (err == ENODEV || err == ENOENT)
+            tempsValid = false;
+         continue;
       }
+
+      /* If already set, e.g. Ryzen reporting platform temperature for each die, use the bigger one */
+      if (isnan(data[temp->index])) {
+         data[temp->index] = value;
+         if (temp->index > 0)
+            coreTempCount++;
+      } else {
+         data[temp->index] = MAXIMUM(data[temp->index], value);
+      }
+   }
+
+   if (nDeadTemps > 0 && now - tempsResolvedMs >= LIBSENSORS_RESCAN_INTERVAL_MS)
+      tempsValid = false;
+
+   if (!tempsValid) {
+      /* libsensors only detects chips in sensors_init */
+      LibSensors_forgetTemps();
+      sym_sensors_cleanup();
+      sym_sensors_init(NULL);
    }
 
    /* Adjust data for chips not providing a platform temperature */
@@ -62,6 +62,7 @@ const ProcessFieldData Process_fields[LAST_PROCESSFIELD] = {
    [ST_UID] = { .name = "ST_UID", .title = "  UID ", .description = "User ID of the process owner", .flags = 0, },
    [PERCENT_CPU] = { .name = "PERCENT_CPU", .title = "CPU% ", .description = "Percentage of the CPU time the process used in the last sampling", .flags = 0, .defaultSortDesc = true, },
    [PERCENT_NORM_CPU] = { .name = "PERCENT_NORM_CPU", .title = "NCPU%", .description = "Normalized percentage of the CPU time the process used in the last sampling (normalized by cpu count)", .flags = 0, .defaultSortDesc = true, },
+   [HOST] = { .name = "HOST", .title = "HOST         ", .description = "Host the process runs on, when showing the processes of agents", .flags = 0, },
    [PERCENT_MEM] = { .name = "PERCENT_MEM", .title = "MEM% ", .description = "Percentage of the memory the process is using, based on resident memory size", .flags = 0, .defaultSortDesc = true, },
    [USER] = { .name = "USER", .title = "USER      ", .description = "Username of the process owner (or user ID if name cannot be determined)", .flags = 0, },
    [TIME] = { .name = "TIME", .title = "  TIME+  ", .description = "Total time the process has spent in user and system time", .flags = 0, .defaultSortDesc = true, },
@@ -100,6 +101,8 @@ const ProcessFieldData Process_fields[LAST_PROCESSFIELD] = {
    [PROC_COMM] = { .name = "COMM", .title = "COMM            ", .description = "comm string of the process from /proc/[pid]/comm", .flags = 0, },
    [PROC_EXE] = { .name = "EXE", .title = "EXE             ", .description = "Basename of exe of the process from /proc/[pid]/exe", .flags = 0, },
    [CWD] = { .name ="CWD", .title = "CWD                       ", .description = "The current working directory of the process", .flags = PROCESS_FLAG_LINUX_CWD, },
+   [SOCKETS] = { .name = "SOCKETS", .title = " SOCK ", .description = "Number of sockets the process has open", .flags = PROCESS_FLAG_LINUX_SOCKETS, .defaultSortDesc = true, },
+   [LISTEN_PORTS] = { .name = "LISTEN_PORTS", .title = "LISTEN          ", .description = "TCP and UDP ports the process listens on; search for :PORT to find it", .flags = PROCESS_FLAG_LINUX_SOCKETS, },
 };
 
 /* This function returns the string displayed in Command column, so that sorting
@@ -113,6 +116,10 @@ static const char* LinuxProcess_getCommandStr(const Process *this) {
    return lp->mergedCommand.str;
 }
 
+static const char* LinuxProcess_getListenPorts(const Process* this) {
+   return ((const LinuxProcess*)this)->listenPorts;
+}
+
 Process* LinuxProcess_new(const Settings* settings) {
    LinuxProcess* this = xCalloc(1, sizeof(LinuxProcess));
    Object_setClass(this, Class(LinuxProcess));
@@ -128,6 +135,7 @@ void Process_delete(Object* cast) {
    free(this->ctid);
 #endif
    free(this->cwd);
+   free(this->listenPorts);
    free(this->secattr);
    free(this->ttyDevice);
    free(this->procExe);
@@ -749,6 +757,19 @@ static void LinuxProcess_writeField(const Process* this, RichString* str, Proces
       Process_printLeftAlignedField(str, attr, cwd, 25);
       return;
    }
+   case SOCKETS:
+      if (Process_isThread(this)) {
+         attr = CRT_colors[PROCESS_SHADOW];
+         xSnprintf(buffer, n, "  N/A ");
+      } else {
+         xSnprintf(buffer, n, "%5u ", lp->sockets);
+      }
+      break;
+   case LISTEN_PORTS:
+      if (!lp->listenPorts)
+         attr = CRT_colors[PROCESS_SHADOW];
+      Process_printLeftAlignedField(str, attr, lp->listenPorts ? lp->listenPorts : "", 15);
+      return;
    default:
       Process_writeField(this, str, field);
       return;
@@ -852,6 +873,10 @@ static int LinuxProcess_compareByKey(const Process* v1, const Process* v2, Proce
    }
    case CWD:
       return SPACESHIP_NULLSTR(p1->cwd, p2->cwd);
+   case SOCKETS:
+      return SPACESHIP_NUMBER(p1->sockets, p2->sockets);
+   case LISTEN_PORTS:
+      return SPACESHIP_NULLSTR(p1->listenPorts, p2->listenPorts);
    default:
       return Process_compareByKey_Base(v1, v2, key);
    }
@@ -870,5 +895,6 @@ const ProcessClass LinuxProcess_class = {
    },
    .writeField = LinuxProcess_writeField,
    .getCommandStr = LinuxProcess_getCommandStr,
+   .getListenPorts = LinuxProcess_getListenPorts,
    .compareByKey = LinuxProcess_compareByKey
 };
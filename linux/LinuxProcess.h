@@ -29,6 +29,7 @@ in the source distribution for its full text.
 #define PROCESS_FLAG_LINUX_LRS_FIX   0x00010000
 #define PROCESS_FLAG_LINUX_CWD       0x00020000
 #define PROCESS_FLAG_LINUX_DELAYACCT 0x00040000
+#define PROCESS_FLAG_LINUX_SOCKETS   0x00080000
 
 
 /* LinuxProcessMergedCommand is populated by LinuxProcess_makeCommandStr: It
@@ -132,6 +133,8 @@ typedef struct LinuxProcess_ {
    char* secattr;
    unsigned long long int last_mlrs_calctime;
    char* cwd;
+   unsigned int sockets;
+   char* listenPorts;         /* ":22 :8080", NULL if the process listens on no port */
 } LinuxProcess;
 
 #define Process_isKernelThread(_process) (((const LinuxProcess*)(_process))->isKernelThread)
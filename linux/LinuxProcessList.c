@@ -16,6 +16,7 @@ in the source distribution for its full text.
 #include <limits.h>
 #include <math.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -45,6 +46,9 @@ in the source distribution for its full text.
 #include "Object.h"
 #include "Platform.h" // needed for GNU/hurd to get PATH_MAX
 #include "Process.h"
+#include "ProcFileCache.h"
+#include "ProcKeyTable.h"
+#include "Profile.h"
 #include "Settings.h"
 #include "XUtils.h"
 
@@ -69,6 +73,78 @@ static long long btime = -1;
 
 static long jiffy;
 
+/* The keys read from the global memory files, their tables are built on first use */
+typedef struct MemInfo_ {
+   memory_t availableMem;
+   memory_t freeMem;
+   memory_t totalMem;
+   memory_t buffersMem;
+   memory_t cachedMem;
+   memory_t sharedMem;
+   memory_t swapTotalMem;
+   memory_t swapCacheMem;
+   memory_t swapFreeMem;
+   memory_t sreclaimableMem;
+} MemInfo;
+
+static const ProcKeyField MemInfo_fields[] = {
+   { "MemAvailable", offsetof(MemInfo, availableMem) },
+   { "MemFree", offsetof(MemInfo, freeMem) },
+   { "MemTotal", offsetof(MemInfo, totalMem) },
+   { "Buffers", offsetof(MemInfo, buffersMem) },
+   { "Cached", offsetof(MemInfo, cachedMem) },
+   { "Shmem", offsetof(MemInfo, sharedMem) },
+   { "SwapTotal", offsetof(MemInfo, swapTotalMem) },
+   { "SwapCached", offsetof(MemInfo, swapCacheMem) },
+   { "SwapFree", offsetof(MemInfo, swapFreeMem) },
+   { "SReclaimable", offsetof(MemInfo, sreclaimableMem) },
+};
+
+static ProcKeyTable MemInfo_table = PROCKEYTABLE_INIT(MemInfo_fields, 0);
+
+typedef struct ArcStats_ {
+   unsigned long long int max;
+   unsigned long long int size;
+   unsigned long long int MFU;
+   unsigned long long int MRU;
+   unsigned long long int anon;
+   unsigned long long int header;
+   unsigned long long int compressed;
+   unsigned long long int uncompressed;
+   unsigned long long int dbufSize;
+   unsigned long long int dnodeSize;
+   unsigned long long int bonusSize;
+} ArcStats;
+
+enum { ARCSTATS_COMPRESSED = 6 };
+
+static const ProcKeyField ArcStats_fields[] = {
+   { "c_max", offsetof(ArcStats, max) },
+   { "size", offsetof(ArcStats, size) },
+   { "mfu_size", offsetof(ArcStats, MFU) },
+   { "mru_size", offsetof(ArcStats, MRU) },
+   { "anon_size", offsetof(ArcStats, anon) },
+   { "hdr_size", offsetof(ArcStats, header) },
+   [ARCSTATS_COMPRESSED] = { "compressed_size", offsetof(ArcStats, compressed) },
+   { "uncompressed_size", offsetof(ArcStats, uncompressed) },
+   { "dbuf_size", offsetof(ArcStats, dbufSize) },
+   { "dnode_size", offsetof(ArcStats, dnodeSize) },
+   { "bonus_size", offsetof(ArcStats, bonusSize) },
+};
+
+/* "name type data" lines after two header lines */
+static ProcKeyTable ArcStats_table = PROCKEYTABLE_INIT(ArcStats_fields, 1);
+
+static const ProcKeyField VmStats_fields[] = {
+   { "pgfault", offsetof(VmStats, pgfault) },
+   { "pgmajfault", offsetof(VmStats, pgmajfault) },
+   { "pswpin", offsetof(VmStats, pswpin) },
+   { "pswpout", offsetof(VmStats, pswpout) },
+   { "oom_kill", offsetof(VmStats, oomKill) },
+};
+
+static ProcKeyTable VmStats_table = PROCKEYTABLE_INIT(VmStats_fields, 0);
+
 static FILE* fopenat(openat_arg_t openatArg, const char* pathname, const char* mode) {
    assert(String_eq(mode, "r")); /* only currently supported mode */
 
@@ -163,30 +239,181 @@ static void LinuxProcessList_initNetlinkSocket(LinuxProcessList* this) {
 
 #endif
 
-static void LinuxProcessList_updateCPUcount(ProcessList* super, FILE* stream) {
-   LinuxProcessList* this = (LinuxProcessList*) super;
+/* Grows the CPU array to hold cpus CPUs.  It never shrinks, so that the meters
+ * keep their CPUs while the highest ones are offline. */
+static void LinuxProcessList_growCPUs(LinuxProcessList* this, unsigned int cpus) {
+   ProcessList* super = &this->super;
+   unsigned int old = this->cpus ? super->cpuCount + 1 : 0;
+   if (cpus + 1 <= old)
+      return;
 
-   unsigned int cpus = 0;
-   char buffer[PROC_LINE_LENGTH + 1];
-   while (fgets(buffer, sizeof(buffer), stream)) {
-      if (String_startsWith(buffer, "cpu")) {
-         cpus++;
+   this->cpus = xReallocArray(this->cpus, cpus + 1, sizeof(CPUData));
+   memset(&this->cpus[old], 0, (cpus + 1 - old) * sizeof(CPUData));
+   super->cpuCount = cpus;
+   this->cpuFreqSampleMs = 0;
+}
+
+static inline unsigned long long int LinuxProcessList_statNumber(const char** pos) {
+   const char* p = *pos;
+   while (*p == ' ')
+      p++;
+
+   unsigned long long int value = 0;
+   for (unsigned int digit; (digit = (unsigned int)(unsigned char)*p - '0') < 10; p++)
+      value = value * 10 + digit;
+
+   *pos = p;
+   return value;
+}
+
+static void LinuxProcessList_updateCPUData(CPUData* cpuData, const unsigned long long int* fields) {
+   unsigned long long int usertime = fields[0];
+   unsigned long long int nicetime = fields[1];
+   unsigned long long int systemtime = fields[2];
+   unsigned long long int idletime = fields[3];
+   unsigned long long int ioWait = fields[4];
+   unsigned long long int irq = fields[5];
+   unsigned long long int softIrq = fields[6];
+   unsigned long long int steal = fields[7];
+   unsigned long long int guest = fields[8];
+   unsigned long long int guestnice = fields[9];
+   // Guest time is already accounted in usertime
+   usertime -= guest;
+   nicetime -= guestnice;
+   // Fields existing on kernels >= 2.6
+   // (and RHEL's patched kernel 2.4...)
+   unsigned long long int idlealltime = idletime + ioWait;
+   unsigned long long int systemalltime = systemtime + irq + softIrq;
+   unsigned long long int virtalltime = guest + guestnice;
+   unsigned long long int totaltime = usertime + nicetime + systemalltime + idlealltime + steal + virtalltime;
+   // Since we do a subtraction (usertime - guest) and cputime64_to_clock_t()
+   // used in /proc/stat rounds down numbers, it can lead to a case where the
+   // integer overflow.
+   #define WRAP_SUBTRACT(a,b) (((a) > (b)) ? (a) - (b) : 0)
+   cpuData->userPeriod = WRAP_SUBTRACT(usertime, cpuData->userTime);
+   cpuData->nicePeriod = WRAP_SUBTRACT(nicetime, cpuData->niceTime);
+   cpuData->systemPeriod = WRAP_SUBTRACT(systemtime, cpuData->systemTime);
+   cpuData->systemAllPeriod = WRAP_SUBTRACT(systemalltime, cpuData->systemAllTime);
+   cpuData->idleAllPeriod = WRAP_SUBTRACT(idlealltime, cpuData->idleAllTime);
+   cpuData->idlePeriod = WRAP_SUBTRACT(idletime, cpuData->idleTime);
+   cpuData->ioWaitPeriod = WRAP_SUBTRACT(ioWait, cpuData->ioWaitTime);
+   cpuData->irqPeriod = WRAP_SUBTRACT(irq, cpuData->irqTime);
+   cpuData->softIrqPeriod = WRAP_SUBTRACT(softIrq, cpuData->softIrqTime);
+   cpuData->stealPeriod = WRAP_SUBTRACT(steal, cpuData->stealTime);
+   cpuData->guestPeriod = WRAP_SUBTRACT(virtalltime, cpuData->guestTime);
+   cpuData->totalPeriod = WRAP_SUBTRACT(totaltime, cpuData->totalTime);
+   #undef WRAP_SUBTRACT
+   cpuData->userTime = usertime;
+   cpuData->niceTime = nicetime;
+   cpuData->systemTime = systemtime;
+   cpuData->systemAllTime = systemalltime;
+   cpuData->idleAllTime = idlealltime;
+   cpuData->idleTime = idletime;
+   cpuData->ioWaitTime = ioWait;
+   cpuData->irqTime = irq;
+   cpuData->softIrqTime = softIrq;
+   cpuData->stealTime = steal;
+   cpuData->guestTime = virtalltime;
+   cpuData->totalTime = totaltime;
+}
+
+/* A "cpu" or "cpuN" line after its prefix, returns the slot in the CPU array it was stored in or -1 */
+static int LinuxProcessList_scanStatCPU(LinuxProcessList* this, const char** pos) {
+   unsigned int slot = 0;
+   if (**pos != ' ') {
+      unsigned long long int cpuid = LinuxProcessList_statNumber(pos);
+      if (**pos != ' ' || cpuid >= 65536)
+         return -1;
+      slot = (unsigned int)cpuid + 1;
+      if (slot > this->super.cpuCount)
+         LinuxProcessList_growCPUs(this, slot);
+   }
+
+   // Depending on your kernel version,
+   // 5, 7, 8 or 9 of these fields will be set.
+   // The rest will remain at zero.
+   unsigned long long int fields[10];
+   for (size_t i = 0; i < ARRAYSIZE(fields); i++)
+      fields[i] = LinuxProcessList_statNumber(pos);
+
+   CPUData* cpuData = &this->cpus[slot];
+   LinuxProcessList_updateCPUData(cpuData, fields);
+   cpuData->online = true;
+   return (int)slot;
+}
+
+/*
+ * Reads the CPU times and scheduler counters in one pass over /proc/stat.
+ * Offline CPUs have no line, so every line is stored by the id it names
+ * and the CPUs without one are marked offline.  Returns the number of
+ * online CPUs.
+ */
+static unsigned int LinuxProcessList_scanStat(LinuxProcessList* this, const char* stat) {
+   ProcessList* super = &this->super;
+
+   if (!this->cpus)
+      LinuxProcessList_growCPUs(this, 1);
+   for (unsigned int i = 1; i <= super->cpuCount; i++)
+      this->cpus[i].online = false;
+
+   unsigned long long int contextSwitches = this->contextSwitches;
+   unsigned long long int forks = this->forks;
+   bool haveAggregate = false;
+   unsigned int online = 0;
+   const char* pos = stat;
+   while (*pos) {
+      if (pos[0] == 'c' && pos[1] == 'p' && pos[2] == 'u') {
+         pos += 3;
+         int slot = LinuxProcessList_scanStatCPU(this, &pos);
+         if (slot > 0)
+            online++;
+         else if (slot == 0)
+            haveAggregate = true;
+      } else if (String_startsWith(pos, "ctxt ")) {
+         pos += strlen("ctxt ");
+         contextSwitches = LinuxProcessList_statNumber(&pos);
+      } else if (String_startsWith(pos, "processes ")) {
+         pos += strlen("processes ");
+         forks = LinuxProcessList_statNumber(&pos);
+      } else if (String_startsWith(pos, "procs_running ")) {
+         pos += strlen("procs_running ");
+         super->runningTasks = (unsigned int)LinuxProcessList_statNumber(&pos);
+      } else if (String_startsWith(pos, "procs_blocked ")) {
+         pos += strlen("procs_blocked ");
+         this->blockedTasks = (unsigned int)LinuxProcessList_statNumber(&pos);
       }
-   }
 
-   if (cpus == 0)
-      CRT_fatalError("No cpu entry in " PROCSTATFILE);
-   if (cpus == 1)
-      CRT_fatalError("No cpu aggregate or cpuN entry in " PROCSTATFILE);
+      pos = strchr(pos, '\n');
+      if (!pos)
+         break;
+      pos++;
+   }
 
-   /* Subtract aggregate cpu entry */
-   cpus--;
+   if (!haveAggregate)
+      CRT_fatalError("No cpu aggregate entry in " PROCSTATFILE);
+   if (online == 0)
+      CRT_fatalError("No cpuN entry in " PROCSTATFILE);
 
-   if (cpus != super->cpuCount || !this->cpus) {
-      super->cpuCount = MAXIMUM(cpus, 1);
-      free(this->cpus);
-      this->cpus = xCalloc(cpus + 1, sizeof(CPUData));
+   // an offline CPU keeps its times for when it comes back, but did not run
+   for (unsigned int i = 1; i <= super->cpuCount; i++) {
+      CPUData* cpuData = &this->cpus[i];
+      if (cpuData->online)
+         continue;
+      cpuData->totalPeriod = cpuData->userPeriod = cpuData->systemPeriod = cpuData->systemAllPeriod = 0;
+      cpuData->idleAllPeriod = cpuData->idlePeriod = cpuData->nicePeriod = cpuData->ioWaitPeriod = 0;
+      cpuData->irqPeriod = cpuData->softIrqPeriod = cpuData->stealPeriod = cpuData->guestPeriod = 0;
    }
+
+   uint64_t now;
+   Platform_gettime_monotonic(&now);
+   this->statPeriodMs = this->statSampleMs ? now - this->statSampleMs : 0;
+   this->statSampleMs = now;
+   this->contextSwitchesPeriod = contextSwitches - MINIMUM(this->contextSwitches, contextSwitches);
+   this->contextSwitches = contextSwitches;
+   this->forksPeriod = forks - MINIMUM(this->forks, forks);
+   this->forks = forks;
+
+   return online;
 }
 
 ProcessList* ProcessList_new(UsersTable* usersTable, Hashtable* pidMatchList, uid_t userId) {
@@ -211,16 +438,15 @@ ProcessList* ProcessList_new(UsersTable* usersTable, Hashtable* pidMatchList, ui
    this->haveSmapsRollup = (access(PROCDIR "/self/smaps_rollup", R_OK) == 0);
 
    // Read btime (the kernel boot time, as number of seconds since the epoch)
-   FILE* statfile = fopen(PROCSTATFILE, "r");
-   if (statfile == NULL)
+   const char* stat = ProcFileCache_get(PROCSTATFILE, NULL);
+   if (stat == NULL)
       CRT_fatalError("Cannot open " PROCSTATFILE);
-   while (true) {
-      char buffer[PROC_LINE_LENGTH + 1];
-      if (fgets(buffer, sizeof(buffer), statfile) == NULL)
-         break;
+   const char* pos = stat;
+   char buffer[PROC_LINE_LENGTH + 1];
+   while ((pos = ProcFileCache_nextLine(pos, buffer, sizeof(buffer)))) {
       if (String_startsWith(buffer, "btime ") == false)
          continue;
-      if (sscanf(buffer, "btime %lld\n", &btime) == 1)
+      if (sscanf(buffer, "btime %lld", &btime) == 1)
          break;
       CRT_fatalError("Failed to parse btime from " PROCSTATFILE);
    }
@@ -228,19 +454,33 @@ ProcessList* ProcessList_new(UsersTable* usersTable, Hashtable* pidMatchList, ui
    if (btime == -1)
       CRT_fatalError("No btime in " PROCSTATFILE);
 
-   rewind(statfile);
-
-   // Initialize CPU count
-   LinuxProcessList_updateCPUcount(pl, statfile);
+   // Initialize CPU count and the first sample of the CPU times
+   LinuxProcessList_scanStat(this, stat);
 
-   fclose(statfile);
+   this->sockets = SocketIndex_new();
 
    return pl;
 }
 
+static void LinuxProcessList_closeCPUFreqFds(LinuxProcessList* this) {
+   for (unsigned int i = 0; i < this->cpuFreqFdCount; i++) {
+      if (this->cpuFreqFds[i] >= 0)
+         close(this->cpuFreqFds[i]);
+   }
+   free(this->cpuFreqFds);
+   this->cpuFreqFds = NULL;
+   this->cpuFreqFdCount = 0;
+}
+
 void ProcessList_delete(ProcessList* pl) {
    LinuxProcessList* this = (LinuxProcessList*) pl;
    ProcessList_done(pl);
+   ProcFileCache_done();
+   ProcKeyTable_done(&MemInfo_table);
+   ProcKeyTable_done(&ArcStats_table);
+   ProcKeyTable_done(&VmStats_table);
+   SocketIndex_delete(this->sockets);
+   LinuxProcessList_closeCPUFreqFds(this);
    free(this->cpus);
    if (this->ttyDrivers) {
       for (int i = 0; this->ttyDrivers[i].path; i++) {
@@ -584,7 +824,7 @@ static uint64_t LinuxProcessList_calcLibSize(openat_arg_t procFd) {
       libdata->exec |= 'x' == map_perm[2];
    }
 
-   fclose(mapsfile);
+   Profile_fclose(mapsfile);
 
    uint64_t total_size = 0;
    Hashtable_foreach(ht, LinuxProcessList_calcLibSize_helper, &total_size);
@@ -608,7 +848,7 @@ static bool LinuxProcessList_readStatmFile(LinuxProcess* process, openat_arg_t p
                   &tmp_m_lrs,
                   &process->m_drs,
                   &process->m_dt);
-   fclose(statmfile);
+   Profile_fclose(statmfile);
 
    if (r == 7) {
       process->super.m_virt *= pageSizeKB;
@@ -666,7 +906,7 @@ static bool LinuxProcessList_readSmapsFile(LinuxProcess* process, openat_arg_t p
       }
    }
 
-   fclose(f);
+   Profile_fclose(f);
    return true;
 }
 
@@ -748,7 +988,7 @@ static void LinuxProcessList_readOpenVZData(LinuxProcess* process, openat_arg_t
       }
    }
 
-   fclose(file);
+   Profile_fclose(file);
 
    if (!foundEnvID) {
       free(process->ctid);
@@ -793,7 +1033,7 @@ static void LinuxProcessList_readCGroupFile(LinuxProcess* process, openat_arg_t
       int wrote = snprintf(at, left, "%s", group);
       left -= wrote;
    }
-   fclose(file);
+   Profile_fclose(file);
    free_and_xStrdup(&process->cgroup, output);
 }
 
@@ -824,7 +1064,7 @@ static void LinuxProcessList_readVServerData(LinuxProcess* process, openat_arg_t
       }
       #endif
    }
-   fclose(file);
+   Profile_fclose(file);
 }
 
 #endif
@@ -842,7 +1082,7 @@ static void LinuxProcessList_readOomData(LinuxProcess* process, openat_arg_t pro
          process->oom = oom;
       }
    }
-   fclose(file);
+   Profile_fclose(file);
 }
 
 static void LinuxProcessList_readCtxtData(LinuxProcess* process, openat_arg_t procFd) {
@@ -867,7 +1107,7 @@ static void LinuxProcessList_readCtxtData(LinuxProcess* process, openat_arg_t pr
          }
       }
    }
-   fclose(file);
+   Profile_fclose(file);
    process->ctxt_diff = (ctxt > process->ctxt_total) ? (ctxt - process->ctxt_total) : 0;
    process->ctxt_total = ctxt;
 }
@@ -882,7 +1122,7 @@ static void LinuxProcessList_readSecattrData(LinuxProcess* process, openat_arg_t
 
    char buffer[PROC_LINE_LENGTH + 1];
    const char* res = fgets(buffer, sizeof(buffer), file);
-   fclose(file);
+   Profile_fclose(file);
    if (!res) {
       free(process->secattr);
       process->secattr = NULL;
@@ -923,6 +1163,99 @@ static void LinuxProcessList_readCwd(LinuxProcess* process, openat_arg_t procFd)
    free_and_xStrdup(&process->cwd, pathBuffer);
 }
 
+#define MAX_LISTEN_PORTS 64
+
+static int compareListenPorts(const void* v1, const void* v2) {
+   uint16_t p1 = *(const uint16_t*)v1;
+   uint16_t p2 = *(const uint16_t*)v2;
+   return SPACESHIP_NUMBER(p1, p2);
+}
+
+/* Counts the sockets among the descriptors and looks up the ports of those listening */
+static void LinuxProcessList_readSockets(LinuxProcessList* this, LinuxProcess* process, openat_arg_t procFd) {
+   char link[64];
+
+#if defined(HAVE_READLINKAT) && defined(HAVE_OPENAT)
+   ssize_t r = readlinkat(procFd, "ns/net", link, sizeof(link) - 1);
+#else
+   char filename[MAX_NAME + 1];
+   xSnprintf(filename, sizeof(filename), "%s/ns/net", procFd);
+   ssize_t r = readlink(filename, link, sizeof(link) - 1);
+#endif
+   unsigned long long netns = 0;
+   if (r > 0) {
+      link[r] = '\0';
+      sscanf(link, "net:[%llu]", &netns);
+   }
+
+   // the first process seen in a namespace reads the tables for all of them
+   char netDir[64];
+   xSnprintf(netDir, sizeof(netDir), "%s/%d/net", PROCDIR, process->super.pid);
+   const SocketTable* table = SocketIndex_get(this->sockets, netns, netDir);
+
+#ifdef HAVE_OPENAT
+   int fdDirFd = openat(procFd, "fd", O_RDONLY | O_DIRECTORY);
+   DIR* fdDir = fdDirFd >= 0 ? fdopendir(fdDirFd) : NULL;
+   if (!fdDir && fdDirFd >= 0)
+      close(fdDirFd);
+   const char* fdPath = NULL;
+#else
+   char fdPath[4096];
+   xSnprintf(fdPath, sizeof(fdPath), "%s/fd", procFd);
+   DIR* fdDir = opendir(fdPath);
+#endif
+
+   unsigned int sockets = 0;
+   uint16_t ports[MAX_LISTEN_PORTS];
+   size_t nPorts = 0;
+   if (fdDir) {
+      const struct dirent* entry;
+      while ((entry = readdir(fdDir))) {
+         if (entry->d_name[0] < '0' || entry->d_name[0] > '9')
+            continue;
+
+         r = Compat_readlinkat(dirfd(fdDir), fdPath, entry->d_name, link, sizeof(link) - 1);
+         if (r <= 0)
+            continue;
+         link[r] = '\0';
+
+         unsigned long long inode;
+         if (sscanf(link, "socket:[%llu]", &inode) != 1)
+            continue;
+         sockets++;
+
+         const SocketEntry* socket = table ? SocketTable_get(table, inode) : NULL;
+         if (!socket || !SocketTable_isListening(socket))
+            continue;
+
+         bool known = false;
+         for (size_t i = 0; i < nPorts && !known; i++)
+            known = ports[i] == socket->localPort;
+         if (!known && nPorts < MAX_LISTEN_PORTS)
+            ports[nPorts++] = socket->localPort;
+      }
+      closedir(fdDir);
+   }
+   process->sockets = sockets;
+
+   if (nPorts == 0) {
+      free(process->listenPorts);
+      process->listenPorts = NULL;
+      return;
+   }
+
+   qsort(ports, nPorts, sizeof(ports[0]), compareListenPorts);
+   char buffer[MAX_LISTEN_PORTS * 7 + 1];
+   size_t len = 0;
+   for (size_t i = 0; i < nPorts; i++)
+      len += xSnprintf(buffer + len, sizeof(buffer) - len, i ? " :%u" : ":%u", ports[i]);
+
+   if (process->listenPorts && String_eq(process->listenPorts, buffer))
+      return;
+
+   free_and_xStrdup(&process->listenPorts, buffer);
+}
+
 #ifdef HAVE_DELAYACCT
 
 static int handleNetlinkMsg(struct nl_msg* nlmsg, void* linuxProcess) {
@@ -1340,10 +1673,16 @@ static bool LinuxProcessList_recurseProcTree(LinuxProcessList* this, openat_arg_
          continue;
       }
 
-      if (settings->flags & PROCESS_FLAG_IO)
+      uint64_t start = Profile_start();
+      if (settings->flags & PROCESS_FLAG_IO) {
          LinuxProcessList_readIoFile(lp, procFd, now);
+         Profile_stop(PROFILE_READ_IO, start);
+      }
 
-      if (!LinuxProcessList_readStatmFile(lp, procFd, !!(settings->flags & PROCESS_FLAG_LINUX_LRS_FIX), now))
+      start = Profile_start();
+      bool statmRead = LinuxProcessList_readStatmFile(lp, procFd, !!(settings->flags & PROCESS_FLAG_LINUX_LRS_FIX), now);
+      Profile_stop(PROFILE_READ_STATM, start);
+      if (!statmRead)
          goto errorReadingProcess;
 
       if ((settings->flags & PROCESS_FLAG_LINUX_SMAPS) && !Process_isKernelThread(proc)) {
@@ -1351,7 +1690,9 @@ static bool LinuxProcessList_recurseProcTree(LinuxProcessList* this, openat_arg_
             // Read smaps file of each process only every second pass to improve performance
             static int smaps_flag = 0;
             if ((pid & 1) == smaps_flag) {
+               start = Profile_start();
                LinuxProcessList_readSmapsFile(lp, procFd, this->haveSmapsRollup);
+               Profile_stop(PROFILE_READ_SMAPS, start);
             }
             if (pid == 1) {
                smaps_flag = !smaps_flag;
@@ -1364,7 +1705,10 @@ static bool LinuxProcessList_recurseProcTree(LinuxProcessList* this, openat_arg_
       char command[MAX_NAME + 1];
       unsigned long long int lasttimes = (lp->utime + lp->stime);
       unsigned int tty_nr = proc->tty_nr;
-      if (! LinuxProcessList_readStatFile(proc, procFd, command, sizeof(command)))
+      start = Profile_start();
+      bool statRead = LinuxProcessList_readStatFile(proc, procFd, command, sizeof(command));
+      Profile_stop(PROFILE_READ_STAT, start);
+      if (!statRead)
          goto errorReadingProcess;
 
       if (tty_nr != proc->tty_nr && this->ttyDrivers) {
@@ -1390,17 +1734,24 @@ static bool LinuxProcessList_recurseProcTree(LinuxProcessList* this, openat_arg_
 
          #ifdef HAVE_OPENVZ
          if (settings->flags & PROCESS_FLAG_LINUX_OPENVZ) {
+            start = Profile_start();
             LinuxProcessList_readOpenVZData(lp, procFd);
+            Profile_stop(PROFILE_READ_STATUS, start);
          }
          #endif
 
          #ifdef HAVE_VSERVER
          if (settings->flags & PROCESS_FLAG_LINUX_VSERVER) {
+            start = Profile_start();
             LinuxProcessList_readVServerData(lp, procFd);
+            Profile_stop(PROFILE_READ_STATUS, start);
          }
          #endif
 
-         if (! LinuxProcessList_readCmdlineFile(proc, procFd)) {
+         start = Profile_start();
+         bool cmdlineRead = LinuxProcessList_readCmdlineFile(proc, procFd);
+         Profile_stop(PROFILE_READ_CMDLINE, start);
+         if (!cmdlineRead) {
             goto errorReadingProcess;
          }
 
@@ -1409,7 +1760,10 @@ static bool LinuxProcessList_recurseProcTree(LinuxProcessList* this, openat_arg_
          ProcessList_add(pl, proc);
       } else {
          if (settings->updateProcessNames && proc->state != 'Z') {
-            if (! LinuxProcessList_readCmdlineFile(proc, procFd)) {
+            start = Profile_start();
+            bool cmdlineRead = LinuxProcessList_readCmdlineFile(proc, procFd);
+            Profile_stop(PROFILE_READ_CMDLINE, start);
+            if (!cmdlineRead) {
                goto errorReadingProcess;
             }
          }
@@ -1431,7 +1785,9 @@ static bool LinuxProcessList_recurseProcTree(LinuxProcessList* this, openat_arg_
       #endif
 
       if (settings->flags & PROCESS_FLAG_LINUX_CGROUP) {
+         start = Profile_start();
          LinuxProcessList_readCGroupFile(lp, procFd);
+         Profile_stop(PROFILE_READ_CGROUP, start);
       }
 
       if (settings->flags & PROCESS_FLAG_LINUX_OOM) {
@@ -1439,7 +1795,9 @@ static bool LinuxProcessList_recurseProcTree(LinuxProcessList* this, openat_arg_
       }
 
       if (settings->flags & PROCESS_FLAG_LINUX_CTXT) {
+         start = Profile_start();
          LinuxProcessList_readCtxtData(lp, procFd);
+         Profile_stop(PROFILE_READ_STATUS, start);
       }
 
       if (settings->flags & PROCESS_FLAG_LINUX_SECATTR) {
@@ -1450,6 +1808,13 @@ static bool LinuxProcessList_recurseProcTree(LinuxProcessList* this, openat_arg_
          LinuxProcessList_readCwd(lp, procFd);
       }
 
+      // threads share the descriptors of their process
+      if (((settings->flags & PROCESS_FLAG_LINUX_SOCKETS) || pl->wantListenPorts) && !Process_isThread(proc)) {
+         start = Profile_start();
+         LinuxProcessList_readSockets(this, lp, procFd);
+         Profile_stop(PROFILE_READ_SOCKETS, start);
+      }
+
       if (proc->state == 'Z' && (proc->basenameOffset == 0)) {
          proc->basenameOffset = -1;
          free_and_xStrdup(&proc->comm, command);
@@ -1502,81 +1867,27 @@ errorReadingProcess:
 }
 
 static inline void LinuxProcessList_scanMemoryInfo(ProcessList* this) {
-   memory_t availableMem = 0;
-   memory_t freeMem = 0;
-   memory_t totalMem = 0;
-   memory_t buffersMem = 0;
-   memory_t cachedMem = 0;
-   memory_t sharedMem = 0;
-   memory_t swapTotalMem = 0;
-   memory_t swapCacheMem = 0;
-   memory_t swapFreeMem = 0;
-   memory_t sreclaimableMem = 0;
-
-   FILE* file = fopen(PROCMEMINFOFILE, "r");
-   if (!file)
+   const char* meminfo = ProcFileCache_get(PROCMEMINFOFILE, NULL);
+   if (!meminfo)
       CRT_fatalError("Cannot open " PROCMEMINFOFILE);
 
-   char buffer[128];
-   while (fgets(buffer, sizeof(buffer), file)) {
-
-      #define tryRead(label, variable)                                       \
-         if (String_startsWith(buffer, label)) {                             \
-            memory_t parsed_;                                                \
-            if (sscanf(buffer + strlen(label), "%llu kB", &parsed_) == 1) {  \
-               (variable) = parsed_;                                         \
-            }                                                                \
-            break;                                                           \
-         }
-
-      switch (buffer[0]) {
-      case 'M':
-         tryRead("MemAvailable:", availableMem);
-         tryRead("MemFree:", freeMem);
-         tryRead("MemTotal:", totalMem);
-         break;
-      case 'B':
-         tryRead("Buffers:", buffersMem);
-         break;
-      case 'C':
-         tryRead("Cached:", cachedMem);
-         break;
-      case 'S':
-         switch (buffer[1]) {
-         case 'h':
-            tryRead("Shmem:", sharedMem);
-            break;
-         case 'w':
-            tryRead("SwapTotal:", swapTotalMem);
-            tryRead("SwapCached:", swapCacheMem);
-            tryRead("SwapFree:", swapFreeMem);
-            break;
-         case 'R':
-            tryRead("SReclaimable:", sreclaimableMem);
-            break;
-         }
-         break;
-      }
-
-      #undef tryRead
-   }
-
-   fclose(file);
+   MemInfo info = { 0 };
+   ProcKeyTable_parse(&MemInfo_table, meminfo, &info);
 
    /*
     * Compute memory partition like procps(free)
     *  https://gitlab.com/procps-ng/procps/-/blob/master/proc/sysinfo.c
     */
-   this->totalMem = totalMem;
-   this->cachedMem = cachedMem + sreclaimableMem;
-   this->sharedMem = sharedMem;
-   const memory_t usedDiff = freeMem + cachedMem + sreclaimableMem + buffersMem + sharedMem;
-   this->usedMem = (totalMem >= usedDiff) ? totalMem - usedDiff : totalMem - freeMem;
-   this->buffersMem = buffersMem;
-   this->availableMem = availableMem != 0 ? MINIMUM(availableMem, totalMem) : freeMem;
-   this->totalSwap = swapTotalMem;
-   this->usedSwap = swapTotalMem - swapFreeMem - swapCacheMem;
-   this->cachedSwap = swapCacheMem;
+   this->totalMem = info.totalMem;
+   this->cachedMem = info.cachedMem + info.sreclaimableMem;
+   this->sharedMem = info.sharedMem;
+   const memory_t usedDiff = info.freeMem + info.cachedMem + info.sreclaimableMem + info.buffersMem + info.sharedMem;
+   this->usedMem = (info.totalMem >= usedDiff) ? info.totalMem - usedDiff : info.totalMem - info.freeMem;
+   this->buffersMem = info.buffersMem;
+   this->availableMem = info.availableMem != 0 ? MINIMUM(info.availableMem, info.totalMem) : info.freeMem;
+   this->totalSwap = info.swapTotalMem;
+   this->usedSwap = info.swapTotalMem - info.swapFreeMem - info.swapCacheMem;
+   this->cachedSwap = info.swapCacheMem;
 }
 
 static void LinuxProcessList_scanHugePages(LinuxProcessList* this) {
@@ -1652,10 +1963,10 @@ static inline void LinuxProcessList_scanZramInfo(LinuxProcessList* this) {
       FILE* mm_stat_file = fopen(mm_stat, "r");
       if (disksize_file == NULL || mm_stat_file == NULL) {
          if (disksize_file) {
-            fclose(disksize_file);
+            Profile_fclose(disksize_file);
          }
          if (mm_stat_file) {
-            fclose(mm_stat_file);
+            Profile_fclose(mm_stat_file);
          }
          break;
       }
@@ -1665,8 +1976,8 @@ static inline void LinuxProcessList_scanZramInfo(LinuxProcessList* this) {
 
       if (!fscanf(disksize_file, "%llu\n", &size) ||
           !fscanf(mm_stat_file, "    %llu       %llu", &orig_data_size, &compr_data_size)) {
-         fclose(disksize_file);
-         fclose(mm_stat_file);
+         Profile_fclose(disksize_file);
+         Profile_fclose(mm_stat_file);
          break;
       }
 
@@ -1674,8 +1985,8 @@ static inline void LinuxProcessList_scanZramInfo(LinuxProcessList* this) {
       usedZramComp += compr_data_size;
       usedZramOrig += orig_data_size;
 
-      fclose(disksize_file);
-      fclose(mm_stat_file);
+      Profile_fclose(disksize_file);
+      Profile_fclose(mm_stat_file);
    }
 
    this->zram.totalZram = totalZram / 1024;
@@ -1684,163 +1995,66 @@ static inline void LinuxProcessList_scanZramInfo(LinuxProcessList* this) {
 }
 
 static inline void LinuxProcessList_scanZfsArcstats(LinuxProcessList* lpl) {
-   memory_t dbufSize = 0;
-   memory_t dnodeSize = 0;
-   memory_t bonusSize = 0;
-
-   FILE* file = fopen(PROCARCSTATSFILE, "r");
-   if (file == NULL) {
+   const char* arcstats = ProcFileCache_get(PROCARCSTATSFILE, NULL);
+   if (arcstats == NULL) {
       lpl->zfs.enabled = 0;
       return;
    }
-   char buffer[128];
-   while (fgets(buffer, 128, file)) {
-      #define tryRead(label, variable)                                         \
-         if (String_startsWith(buffer, label)) {                               \
-            sscanf(buffer + strlen(label), " %*2u %32llu", variable);          \
-            break;                                                             \
-         }
-      #define tryReadFlag(label, variable, flag)                               \
-         if (String_startsWith(buffer, label)) {                               \
-            (flag) = sscanf(buffer + strlen(label), " %*2u %32llu", variable); \
-            break;                                                             \
-         }
 
-      switch (buffer[0]) {
-      case 'c':
-         tryRead("c_max", &lpl->zfs.max);
-         tryReadFlag("compressed_size", &lpl->zfs.compressed, lpl->zfs.isCompressed);
-         break;
-      case 'u':
-         tryRead("uncompressed_size", &lpl->zfs.uncompressed);
-         break;
-      case 's':
-         tryRead("size", &lpl->zfs.size);
-         break;
-      case 'h':
-         tryRead("hdr_size", &lpl->zfs.header);
-         break;
-      case 'd':
-         tryRead("dbuf_size", &dbufSize);
-         tryRead("dnode_size", &dnodeSize);
-         break;
-      case 'b':
-         tryRead("bonus_size", &bonusSize);
-         break;
-      case 'a':
-         tryRead("anon_size", &lpl->zfs.anon);
-         break;
-      case 'm':
-         tryRead("mfu_size", &lpl->zfs.MFU);
-         tryRead("mru_size", &lpl->zfs.MRU);
-         break;
-      }
-      #undef tryRead
-      #undef tryReadFlag
-   }
-   fclose(file);
-
-   lpl->zfs.enabled = (lpl->zfs.size > 0 ? 1 : 0);
-   lpl->zfs.size    /= 1024;
-   lpl->zfs.max    /= 1024;
-   lpl->zfs.MFU    /= 1024;
-   lpl->zfs.MRU    /= 1024;
-   lpl->zfs.anon   /= 1024;
-   lpl->zfs.header /= 1024;
-   lpl->zfs.other   = (dbufSize + dnodeSize + bonusSize) / 1024;
+   ArcStats arc = { 0 };
+   uint64_t found = ProcKeyTable_parse(&ArcStats_table, arcstats, &arc);
+
+   lpl->zfs.enabled = (arc.size > 0 ? 1 : 0);
+   lpl->zfs.isCompressed = (found & (UINT64_C(1) << ARCSTATS_COMPRESSED)) ? 1 : 0;
+   lpl->zfs.size    = arc.size / 1024;
+   lpl->zfs.max     = arc.max / 1024;
+   lpl->zfs.MFU     = arc.MFU / 1024;
+   lpl->zfs.MRU     = arc.MRU / 1024;
+   lpl->zfs.anon    = arc.anon / 1024;
+   lpl->zfs.header  = arc.header / 1024;
+   lpl->zfs.other   = (arc.dbufSize + arc.dnodeSize + arc.bonusSize) / 1024;
    if ( lpl->zfs.isCompressed ) {
-      lpl->zfs.compressed /= 1024;
-      lpl->zfs.uncompressed /= 1024;
+      lpl->zfs.compressed = arc.compressed / 1024;
+      lpl->zfs.uncompressed = arc.uncompressed / 1024;
    }
 }
 
-static inline double LinuxProcessList_scanCPUTime(ProcessList* super) {
-   LinuxProcessList* this = (LinuxProcessList*) super;
+static void LinuxProcessList_scanVmStats(LinuxProcessList* this) {
+   const char* vmstat = ProcFileCache_get(PROCVMSTATFILE, NULL);
+   if (!vmstat)
+      return;
 
-   FILE* file = fopen(PROCSTATFILE, "r");
-   if (!file)
-      CRT_fatalError("Cannot open " PROCSTATFILE);
+   VmStats stats = this->vmstat;
+   ProcKeyTable_parse(&VmStats_table, vmstat, &stats);
 
-   LinuxProcessList_updateCPUcount(super, file);
+   for (size_t i = 0; i < ARRAYSIZE(VmStats_fields); i++) {
+      size_t offset = VmStats_fields[i].offset;
+      unsigned long long int now = *(unsigned long long int*)((char*)&stats + offset);
+      unsigned long long int* last = (unsigned long long int*)((char*)&this->vmstat + offset);
+      *(unsigned long long int*)((char*)&this->vmstatPeriod + offset) = now - MINIMUM(*last, now);
+      *last = now;
+   }
+}
 
-   rewind(file);
+static inline double LinuxProcessList_scanCPUTime(ProcessList* super) {
+   LinuxProcessList* this = (LinuxProcessList*) super;
 
-   unsigned int cpus = super->cpuCount;
-   for (unsigned int i = 0; i <= cpus; i++) {
-      char buffer[PROC_LINE_LENGTH + 1];
-      unsigned long long int usertime, nicetime, systemtime, idletime;
-      unsigned long long int ioWait = 0, irq = 0, softIrq = 0, steal = 0, guest = 0, guestnice = 0;
-      // Depending on your kernel version,
-      // 5, 7, 8 or 9 of these fields will be set.
-      // The rest will remain at zero.
-      const char* ok = fgets(buffer, sizeof(buffer), file);
-      if (!ok)
-         break;
+   const char* stat = ProcFileCache_get(PROCSTATFILE, NULL);
+   if (!stat)
+      CRT_fatalError("Cannot open " PROCSTATFILE);
 
-      if (i == 0) {
-         (void) sscanf(buffer,   "cpu  %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu",         &usertime, &nicetime, &systemtime, &idletime, &ioWait, &irq, &softIrq, &steal, &guest, &guestnice);
-      } else {
-         unsigned int cpuid;
-         (void) sscanf(buffer, "cpu%4u %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu", &cpuid, &usertime, &nicetime, &systemtime, &idletime, &ioWait, &irq, &softIrq, &steal, &guest, &guestnice);
-         assert(cpuid == i - 1);
-      }
-      // Guest time is already accounted in usertime
-      usertime -= guest;
-      nicetime -= guestnice;
-      // Fields existing on kernels >= 2.6
-      // (and RHEL's patched kernel 2.4...)
-      unsigned long long int idlealltime = idletime + ioWait;
-      unsigned long long int systemalltime = systemtime + irq + softIrq;
-      unsigned long long int virtalltime = guest + guestnice;
-      unsigned long long int totaltime = usertime + nicetime + systemalltime + idlealltime + steal + virtalltime;
-      CPUData* cpuData = &(this->cpus[i]);
-      // Since we do a subtraction (usertime - guest) and cputime64_to_clock_t()
-      // used in /proc/stat rounds down numbers, it can lead to a case where the
-      // integer overflow.
-      #define WRAP_SUBTRACT(a,b) (((a) > (b)) ? (a) - (b) : 0)
-      cpuData->userPeriod = WRAP_SUBTRACT(usertime, cpuData->userTime);
-      cpuData->nicePeriod = WRAP_SUBTRACT(nicetime, cpuData->niceTime);
-      cpuData->systemPeriod = WRAP_SUBTRACT(systemtime, cpuData->systemTime);
-      cpuData->systemAllPeriod = WRAP_SUBTRACT(systemalltime, cpuData->systemAllTime);
-      cpuData->idleAllPeriod = WRAP_SUBTRACT(idlealltime, cpuData->idleAllTime);
-      cpuData->idlePeriod = WRAP_SUBTRACT(idletime, cpuData->idleTime);
-      cpuData->ioWaitPeriod = WRAP_SUBTRACT(ioWait, cpuData->ioWaitTime);
-      cpuData->irqPeriod = WRAP_SUBTRACT(irq, cpuData->irqTime);
-      cpuData->softIrqPeriod = WRAP_SUBTRACT(softIrq, cpuData->softIrqTime);
-      cpuData->stealPeriod = WRAP_SUBTRACT(steal, cpuData->stealTime);
-      cpuData->guestPeriod = WRAP_SUBTRACT(virtalltime, cpuData->guestTime);
-      cpuData->totalPeriod = WRAP_SUBTRACT(totaltime, cpuData->totalTime);
-      #undef WRAP_SUBTRACT
-      cpuData->userTime = usertime;
-      cpuData->niceTime = nicetime;
-      cpuData->systemTime = systemtime;
-      cpuData->systemAllTime = systemalltime;
-      cpuData->idleAllTime = idlealltime;
-      cpuData->idleTime = idletime;
-      cpuData->ioWaitTime = ioWait;
-      cpuData->irqTime = irq;
-      cpuData->softIrqTime = softIrq;
-      cpuData->stealTime = steal;
-      cpuData->guestTime = virtalltime;
-      cpuData->totalTime = totaltime;
-   }
-
-   double period = (double)this->cpus[0].totalPeriod / cpus;
+   unsigned int online = LinuxProcessList_scanStat(this, stat);
 
-   char buffer[PROC_LINE_LENGTH + 1];
-   while (fgets(buffer, sizeof(buffer), file)) {
-      if (String_startsWith(buffer, "procs_running")) {
-         super->runningTasks = strtoul(buffer + strlen("procs_running"), NULL, 10);
-         break;
-      }
-   }
+   return (double)this->cpus[0].totalPeriod / online;
+}
 
-   fclose(file);
+/* Frequencies change quickly but are only shown, so they are read less often than the CPU times */
+#define CPUFREQ_SAMPLE_INTERVAL_MS 1000
 
-   return period;
-}
+/* How often CPUs without a readable scaling_cur_freq, e.g. offline ones, are looked at again */
+#define CPUFREQ_RETRY_INTERVAL_MS 10000
 
-static int scanCPUFreqencyFromSysCPUFreq(LinuxProcessList* this) {
+static int scanCPUFreqencyFromSysCPUFreq(LinuxProcessList* this, uint64_t now) {
    unsigned int cpus = this->super.cpuCount;
    int numCPUsWithFrequency = 0;
    unsigned long totalFrequency = 0;
@@ -1859,28 +2073,58 @@ static int scanCPUFreqencyFromSysCPUFreq(LinuxProcessList* this) {
       return -1;
    }
 
+   /* The files are kept open and read again with pread, the set of CPUs changed */
+   if (this->cpuFreqFdCount != cpus) {
+      LinuxProcessList_closeCPUFreqFds(this);
+      this->cpuFreqFds = xMallocArray(cpus, sizeof(int));
+      for (unsigned int i = 0; i < cpus; i++)
+         this->cpuFreqFds[i] = -1;
+      this->cpuFreqFdCount = cpus;
+      this->cpuFreqRetryMs = 0;
+   }
+
+   bool retry = now >= this->cpuFreqRetryMs;
+   bool missing = false;
+
    for (unsigned int i = 0; i < cpus; ++i) {
-      char pathBuffer[64];
-      xSnprintf(pathBuffer, sizeof(pathBuffer), "/sys/devices/system/cpu/cpu%u/cpufreq/scaling_cur_freq", i);
+      int* fd = &this->cpuFreqFds[i];
+      if (*fd < 0) {
+         if (!retry) {
+            missing = true;
+            continue;
+         }
+
+         char pathBuffer[64];
+         xSnprintf(pathBuffer, sizeof(pathBuffer), "/sys/devices/system/cpu/cpu%u/cpufreq/scaling_cur_freq", i);
+         *fd = open(pathBuffer, O_RDONLY | O_CLOEXEC);
+         if (*fd < 0) {
+            missing = true;
+            continue;
+         }
+         Profile_count(PROFILE_FILES_OPENED, 1);
+      }
 
       struct timespec start;
       if (i == 0)
          clock_gettime(CLOCK_MONOTONIC, &start);
 
-      FILE* file = fopen(pathBuffer, "r");
-      if (!file)
-         return -errno;
-
-      unsigned long frequency;
-      if (fscanf(file, "%lu", &frequency) == 1) {
-         /* convert kHz to MHz */
-         frequency = frequency / 1000;
-         this->cpus[i + 1].frequency = frequency;
-         numCPUsWithFrequency++;
-         totalFrequency += frequency;
+      char buffer[32];
+      ssize_t len = pread(*fd, buffer, sizeof(buffer) - 1, 0);
+      if (len <= 0) {
+         /* the CPU went offline */
+         close(*fd);
+         *fd = -1;
+         missing = true;
+         continue;
       }
+      buffer[len] = '\0';
+      Profile_count(PROFILE_BYTES_READ, (uint64_t)len);
 
-      fclose(file);
+      /* convert kHz to MHz */
+      unsigned long frequency = strtoul(buffer, NULL, 10) / 1000;
+      this->cpus[i + 1].frequency = frequency;
+      numCPUsWithFrequency++;
+      totalFrequency += frequency;
 
       if (i == 0) {
          struct timespec end;
@@ -1891,11 +2135,15 @@ static int scanCPUFreqencyFromSysCPUFreq(LinuxProcessList* this) {
             return -1;
          }
       }
-
    }
 
-   if (numCPUsWithFrequency > 0)
-      this->cpus[0].frequency = (double)totalFrequency / numCPUsWithFrequency;
+   if (missing && retry)
+      this->cpuFreqRetryMs = now + CPUFREQ_RETRY_INTERVAL_MS;
+
+   if (numCPUsWithFrequency == 0)
+      return -1;
+
+   this->cpus[0].frequency = (double)totalFrequency / numCPUsWithFrequency;
 
    return 0;
 }
@@ -1943,7 +2191,7 @@ static void scanCPUFreqencyFromCPUinfo(LinuxProcessList* this) {
          cpuid = -1;
       }
    }
-   fclose(file);
+   Profile_fclose(file);
 
    if (numCPUsWithFrequency > 0) {
       this->cpus[0].frequency = totalFrequency / numCPUsWithFrequency;
@@ -1953,11 +2201,20 @@ static void scanCPUFreqencyFromCPUinfo(LinuxProcessList* this) {
 static void LinuxProcessList_scanCPUFrequency(LinuxProcessList* this) {
    unsigned int cpus = this->super.cpuCount;
 
+   /* the scan time stands still while process updates are paused */
+   uint64_t now;
+   Platform_gettime_monotonic(&now);
+
+   /* keep the last sample, which is reset when the CPUs change */
+   if (this->cpuFreqSampleMs > 0 && now - this->cpuFreqSampleMs < CPUFREQ_SAMPLE_INTERVAL_MS)
+      return;
+   this->cpuFreqSampleMs = now;
+
    for (unsigned int i = 0; i <= cpus; i++) {
       this->cpus[i].frequency = NAN;
    }
 
-   if (scanCPUFreqencyFromSysCPUFreq(this) == 0) {
+   if (scanCPUFreqencyFromSysCPUFreq(this, now) == 0) {
       return;
    }
 
@@ -1968,10 +2225,15 @@ void ProcessList_goThroughEntries(ProcessList* super, bool pauseProcessUpdate) {
    LinuxProcessList* this = (LinuxProcessList*) super;
    const Settings* settings = super->settings;
 
+   ProcFileCache_invalidate();
+   SocketIndex_invalidate(this->sockets);
+
+   uint64_t start = Profile_start();
    LinuxProcessList_scanMemoryInfo(super);
    LinuxProcessList_scanHugePages(this);
    LinuxProcessList_scanZfsArcstats(this);
    LinuxProcessList_scanZramInfo(this);
+   LinuxProcessList_scanVmStats(this);
 
    double period = LinuxProcessList_scanCPUTime(super);
 
@@ -1983,6 +2245,7 @@ void ProcessList_goThroughEntries(ProcessList* super, bool pauseProcessUpdate) {
    if (settings->showCPUTemperature)
       LibSensors_getCPUTemperatures(this->cpus, this->super.cpuCount);
    #endif
+   Profile_stop(PROFILE_READ_SYSTEM, start);
 
    // in pause mode only gather global data for meters (CPU/memory/...)
    if (pauseProcessUpdate) {
@@ -10,10 +10,12 @@ in the source distribution for its full text.
 #include "config.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 #include "Hashtable.h"
 #include "ProcessList.h"
+#include "SocketTable.h"
 #include "UsersTable.h"
 #include "ZramStats.h"
 #include "zfs/ZfsArcStats.h"
@@ -50,11 +52,22 @@ typedef struct CPUData_ {
 
    double frequency;
 
+   bool online;               /* had a line in /proc/stat in the last scan */
+
    #ifdef HAVE_SENSORS_SENSORS_H
    double temperature;
    #endif
 } CPUData;
 
+/* Event counters of /proc/vmstat */
+typedef struct VmStats_ {
+   unsigned long long int pgfault;
+   unsigned long long int pgmajfault;
+   unsigned long long int pswpin;
+   unsigned long long int pswpout;
+   unsigned long long int oomKill;
+} VmStats;
+
 typedef struct TtyDriver_ {
    char* path;
    unsigned int major;
@@ -81,6 +94,26 @@ typedef struct LinuxProcessList_ {
 
    ZfsArcStats zfs;
    ZramStats zram;
+
+   SocketIndex* sockets;
+
+   /* scheduler counters from /proc/stat, the periods are since the previous scan */
+   unsigned long long int contextSwitches;
+   unsigned long long int contextSwitchesPeriod;
+   unsigned long long int forks;
+   unsigned long long int forksPeriod;
+   unsigned int blockedTasks;
+   uint64_t statSampleMs;
+   uint64_t statPeriodMs;
+
+   /* since boot and since the previous scan, which took statPeriodMs */
+   VmStats vmstat;
+   VmStats vmstatPeriod;
+
+   int* cpuFreqFds;           /* scaling_cur_freq of each CPU kept open, -1 while it can not be opened */
+   unsigned int cpuFreqFdCount;
+   uint64_t cpuFreqSampleMs;  /* when the frequencies were last read */
+   uint64_t cpuFreqRetryMs;   /* when to try again to open the files that could not be opened */
 } LinuxProcessList;
 
 #ifndef PROCDIR
@@ -99,6 +132,10 @@ typedef struct LinuxProcessList_ {
 #define PROCMEMINFOFILE PROCDIR "/meminfo"
 #endif
 
+#ifndef PROCVMSTATFILE
+#define PROCVMSTATFILE PROCDIR "/vmstat"
+#endif
+
 #ifndef PROCARCSTATSFILE
 #define PROCARCSTATSFILE PROCDIR "/spl/kstat/zfs/arcstats"
 #endif
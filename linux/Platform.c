@@ -15,13 +15,17 @@ in the source distribution for its full text.
 #include <errno.h>
 #include <fcntl.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <math.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
 #include <time.h>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
 
 #include "BatteryMeter.h"
 #include "ClockMeter.h"
@@ -30,6 +34,7 @@ in the source distribution for its full text.
 #include "DateMeter.h"
 #include "DateTimeMeter.h"
 #include "DiskIOMeter.h"
+#include "Exporter.h"
 #include "HostnameMeter.h"
 #include "HugePageMeter.h"
 #include "IOPriority.h"
@@ -45,15 +50,22 @@ in the source distribution for its full text.
 #include "Object.h"
 #include "Panel.h"
 #include "PressureStallMeter.h"
+#include "ProcFileCache.h"
+#include "ProcFileCacheMeter.h"
 #include "ProcessList.h"
+#include "ProfileMeter.h"
 #include "ProvideCurses.h"
 #include "SELinuxMeter.h"
+#include "SchedulerMeter.h"
 #include "Settings.h"
+#include "Snapshot.h"
+#include "SocketTable.h"
 #include "SwapMeter.h"
 #include "SysArchMeter.h"
 #include "SystemdMeter.h"
 #include "TasksMeter.h"
 #include "UptimeMeter.h"
+#include "VmStatMeter.h"
 #include "XUtils.h"
 #include "ZramMeter.h"
 #include "ZramStats.h"
@@ -164,7 +176,10 @@ const MeterClass* const Platform_meterTypes[] = {
    &SysArchMeter_class,
    &HugePageMeter_class,
    &TasksMeter_class,
+   &SchedulerMeter_class,
+   &VmStatMeter_class,
    &UptimeMeter_class,
+   &ProfileMeter_class,
    &BatteryMeter_class,
    &HostnameMeter_class,
    &AllCPUsMeter_class,
@@ -179,6 +194,7 @@ const MeterClass* const Platform_meterTypes[] = {
    &RightCPUs4Meter_class,
    &LeftCPUs8Meter_class,
    &RightCPUs8Meter_class,
+   &CPUHeatmapMeter_class,
    &BlankMeter_class,
    &PressureStallCPUSomeMeter_class,
    &PressureStallIOSomeMeter_class,
@@ -188,6 +204,7 @@ const MeterClass* const Platform_meterTypes[] = {
    &ZfsArcMeter_class,
    &ZfsCompressedArcMeter_class,
    &ZramMeter_class,
+   &ProcFileCacheMeter_class,
    &DiskIOMeter_class,
    &NetworkIOMeter_class,
    &SELinuxMeter_class,
@@ -195,6 +212,65 @@ const MeterClass* const Platform_meterTypes[] = {
    NULL
 };
 
+/* The restricted fields come from exe, smaps_rollup, io and cwd below /proc/PID */
+static const SnapshotField Platform_snapshotFields[] = {
+   SNAPSHOT_FIELD(LinuxProcess, procComm, SNAPSHOT_STRING),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, procExe, SNAPSHOT_STRING, 0),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, procExeLen, SNAPSHOT_INT, 0),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, procExeBasenameOffset, SNAPSHOT_INT, 0),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, procExeDeleted, SNAPSHOT_INT, 0),
+   SNAPSHOT_FIELD(LinuxProcess, isKernelThread, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(LinuxProcess, ioPriority, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(LinuxProcess, cminflt, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(LinuxProcess, cmajflt, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(LinuxProcess, utime, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(LinuxProcess, stime, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(LinuxProcess, cutime, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(LinuxProcess, cstime, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(LinuxProcess, m_share, SNAPSHOT_INT),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, m_pss, SNAPSHOT_INT, 0),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, m_swap, SNAPSHOT_INT, 0),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, m_psswp, SNAPSHOT_INT, 0),
+   SNAPSHOT_FIELD(LinuxProcess, m_trs, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(LinuxProcess, m_drs, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(LinuxProcess, m_lrs, SNAPSHOT_INT),
+   SNAPSHOT_FIELD(LinuxProcess, m_dt, SNAPSHOT_INT),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, io_rchar, SNAPSHOT_UINT, (int64_t)ULLONG_MAX),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, io_wchar, SNAPSHOT_UINT, (int64_t)ULLONG_MAX),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, io_syscr, SNAPSHOT_UINT, (int64_t)ULLONG_MAX),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, io_syscw, SNAPSHOT_UINT, (int64_t)ULLONG_MAX),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, io_read_bytes, SNAPSHOT_UINT, (int64_t)ULLONG_MAX),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, io_write_bytes, SNAPSHOT_UINT, (int64_t)ULLONG_MAX),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, io_cancelled_write_bytes, SNAPSHOT_UINT, (int64_t)ULLONG_MAX),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, io_rate_read_bps, SNAPSHOT_REAL, SNAPSHOT_NAN),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, io_rate_write_bps, SNAPSHOT_REAL, SNAPSHOT_NAN),
+   #ifdef HAVE_OPENVZ
+   SNAPSHOT_FIELD(LinuxProcess, ctid, SNAPSHOT_STRING),
+   SNAPSHOT_FIELD(LinuxProcess, vpid, SNAPSHOT_INT),
+   #endif
+   #ifdef HAVE_VSERVER
+   SNAPSHOT_FIELD(LinuxProcess, vxid, SNAPSHOT_UINT),
+   #endif
+   SNAPSHOT_FIELD(LinuxProcess, cgroup, SNAPSHOT_STRING),
+   SNAPSHOT_FIELD(LinuxProcess, oom, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(LinuxProcess, ttyDevice, SNAPSHOT_STRING),
+   #ifdef HAVE_DELAYACCT
+   SNAPSHOT_FIELD(LinuxProcess, cpu_delay_percent, SNAPSHOT_REAL),
+   SNAPSHOT_FIELD(LinuxProcess, blkio_delay_percent, SNAPSHOT_REAL),
+   SNAPSHOT_FIELD(LinuxProcess, swapin_delay_percent, SNAPSHOT_REAL),
+   #endif
+   SNAPSHOT_FIELD(LinuxProcess, ctxt_total, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(LinuxProcess, ctxt_diff, SNAPSHOT_UINT),
+   SNAPSHOT_FIELD(LinuxProcess, secattr, SNAPSHOT_STRING),
+   SNAPSHOT_RESTRICTED_FIELD(LinuxProcess, cwd, SNAPSHOT_STRING, 0),
+};
+
+const SnapshotLayout Platform_snapshotLayout = {
+   .newProcess = LinuxProcess_new,
+   .fields = Platform_snapshotFields,
+   .nFields = ARRAYSIZE(Platform_snapshotFields),
+};
+
 int Platform_getUptime() {
    double uptime = 0;
    FILE* fd = fopen(PROCDIR "/uptime", "r");
@@ -245,6 +321,11 @@ int Platform_getMaxPid() {
 double Platform_setCPUValues(Meter* this, unsigned int cpu) {
    const LinuxProcessList* pl = (const LinuxProcessList*) this->pl;
    const CPUData* cpuData = &(pl->cpus[cpu]);
+   if (cpu > 0 && !cpuData->online) {
+      this->curItems = 0;
+      return NAN;
+   }
+
    double total = (double) ( cpuData->totalPeriod == 0 ? 1 : cpuData->totalPeriod);
    double percent;
    double* v = this->values;
@@ -364,59 +445,67 @@ char* Platform_getProcessEnv(pid_t pid) {
    return env;
 }
 
+static int FileLocks_Data_compareByInode(const void* v1, const void* v2) {
+   const FileLocks_Data* data1 = (const FileLocks_Data*)v1;
+   const FileLocks_Data* data2 = (const FileLocks_Data*)v2;
+   if (data1->pid != data2->pid)
+      return data1->pid < data2->pid ? -1 : 1;
+   return (data1->inode > data2->inode) - (data1->inode < data2->inode);
+}
+
 /*
- * Return the absolute path of a file given its pid&inode number
+ * Names the files of the locks of one process, which are sorted by inode.
+ * The fd directory is walked once and only descriptors of a locked inode
+ * are resolved, each inode once, however many locks and descriptors refer
+ * to it.
  *
- * Based on implementation of lslocks from util-linux:
+ * Based on the file name lookup of lslocks from util-linux:
  * https://sources.debian.org/src/util-linux/2.36-3/misc-utils/lslocks.c/#L162
  */
-char* Platform_getInodeFilename(pid_t pid, ino_t inode) {
-   struct stat sb;
-   const struct dirent *de;
-   DIR *dirp;
-   ssize_t len;
-   int fd;
+static void Platform_nameLockedFiles(FileLocks_Data* locks, size_t nLocks, Hashtable* byInode) {
+   Hashtable_clear(byInode);
+   size_t unnamed = 0;
+   for (size_t i = 0; i < nLocks; i++) {
+      if (i == 0 || locks[i].inode != locks[i - 1].inode) {
+         Hashtable_put(byInode, (ht_key_t)locks[i].inode, &locks[i]);
+         unnamed++;
+      }
+   }
 
    char path[PATH_MAX];
-   char sym[PATH_MAX];
-   char* ret = NULL;
-
-   memset(path, 0, sizeof(path));
-   memset(sym, 0, sizeof(sym));
+   xSnprintf(path, sizeof(path), "%s/%d/fd/", PROCDIR, locks[0].pid);
 
-   xSnprintf(path, sizeof(path), "%s/%d/fd/", PROCDIR, pid);
-   if (strlen(path) >= (sizeof(path) - 2))
-      return NULL;
-
-   if (!(dirp = opendir(path)))
-      return NULL;
-
-   if ((fd = dirfd(dirp)) < 0 )
-      goto out;
-
-   while ((de = readdir(dirp))) {
-      if (String_eq(de->d_name, ".") || String_eq(de->d_name, ".."))
-         continue;
+   DIR* dirp = opendir(path);
+   if (!dirp)
+      return;
 
+   int fd = dirfd(dirp);
+   const struct dirent* de;
+   while (unnamed > 0 && (de = readdir(dirp))) {
       /* care only for numerical descriptors */
-      if (!strtoull(de->d_name, (char **) NULL, 10))
+      if (de->d_name[0] < '0' || de->d_name[0] > '9')
          continue;
 
-      if (!Compat_fstatat(fd, path, de->d_name, &sb, 0) && inode != sb.st_ino)
+      struct stat sb;
+      if (Compat_fstatat(fd, path, de->d_name, &sb, 0) != 0)
          continue;
 
-      if ((len = Compat_readlinkat(fd, path, de->d_name, sym, sizeof(sym) - 1)) < 1)
-         goto out;
+      FileLocks_Data* first = Hashtable_get(byInode, (ht_key_t)sb.st_ino);
+      if (!first || first->inode != (uint64_t)sb.st_ino || first->filename)
+         continue;
 
+      char sym[PATH_MAX];
+      ssize_t len = Compat_readlinkat(fd, path, de->d_name, sym, sizeof(sym) - 1);
+      if (len < 1)
+         continue;
       sym[len] = '\0';
 
-      ret = xStrdup(sym);
-      break;
+      for (FileLocks_Data* data = first; data < locks + nLocks && data->inode == first->inode; data++)
+         data->filename = xStrdup(sym);
+      unnamed--;
    }
 
-out:
    closedir(dirp);
-   return ret;
 }
 
 FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
@@ -429,7 +518,6 @@ FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
    }
 
    char buffer[1024];
-   FileLocks_LockData** data_ref = &pdata->locks;
    while(fgets(buffer, sizeof(buffer), f)) {
       if (!strchr(buffer, '\n'))
          continue;
@@ -450,16 +538,15 @@ FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
          lock_start, lock_end))
          continue;
 
-      if (pid != lock_pid)
+      if (pid != 0 && pid != lock_pid)
          continue;
 
-      FileLocks_LockData* ldata = xCalloc(1, sizeof(FileLocks_LockData));
-      FileLocks_Data* data = &ldata->data;
+      FileLocks_Data* data = FileLocks_ProcessData_add(pdata);
       data->id = lock_id;
+      data->pid = lock_pid;
       data->locktype = xStrdup(lock_type);
       data->exclusive = xStrdup(lock_excl);
       data->readwrite = xStrdup(lock_rw);
-      data->filename = Platform_getInodeFilename(lock_pid, lock_inode);
       data->dev[0] = lock_dev[0];
       data->dev[1] = lock_dev[1];
       data->inode = lock_inode;
@@ -469,41 +556,242 @@ FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
       } else {
          data->end = ULLONG_MAX;
       }
-
-      *data_ref = ldata;
-      data_ref = &ldata->next;
    }
 
    fclose(f);
+
+   if (pdata->nLocks == 0)
+      return pdata;
+
+   // group the locks by process, each group sorted by inode, and walk the fds of every process once
+   qsort(pdata->locks, pdata->nLocks, sizeof(FileLocks_Data), FileLocks_Data_compareByInode);
+
+   Hashtable* byInode = Hashtable_new(64, false);
+   size_t first = 0;
+   while (first < pdata->nLocks) {
+      size_t last = first + 1;
+      while (last < pdata->nLocks && pdata->locks[last].pid == pdata->locks[first].pid)
+         last++;
+
+      // open file description locks have no owning process
+      if (pdata->locks[first].pid > 0)
+         Platform_nameLockedFiles(&pdata->locks[first], last - first, byInode);
+
+      first = last;
+   }
+   Hashtable_delete(byInode);
+
    return pdata;
 }
 
+static void Platform_readFileInfo(const char* infoPath, const char* name, OpenFiles_FileData* fdata, bool seekable) {
+   char path[PATH_MAX];
+   xSnprintf(path, sizeof(path), "%s/%s", infoPath, name);
+
+   char buffer[1024];
+   if (xReadfile(path, buffer, sizeof(buffer)) <= 0)
+      return;
+
+   const char* pos = strstr(buffer, "pos:");
+   if (pos && seekable)
+      xSnprintf(fdata->offset, sizeof(fdata->offset), "%llu", strtoull(pos + 4, NULL, 10));
+
+   const char* flags = strstr(buffer, "flags:");
+   if (flags) {
+      switch (strtoul(flags + 6, NULL, 8) & O_ACCMODE) {
+      case O_RDONLY:
+         String_safeStrncpy(fdata->mode, "r", sizeof(fdata->mode));
+         break;
+      case O_WRONLY:
+         String_safeStrncpy(fdata->mode, "w", sizeof(fdata->mode));
+         break;
+      default:
+         String_safeStrncpy(fdata->mode, "u", sizeof(fdata->mode));
+         break;
+      }
+   }
+}
+
+/* Fills in type, device, size and inode from what the descriptor points to */
+static void Platform_statFile(const struct stat* st, const char* link, OpenFiles_FileData* fdata) {
+   const char* type;
+   if (S_ISREG(st->st_mode))
+      type = "REG";
+   else if (S_ISDIR(st->st_mode))
+      type = "DIR";
+   else if (S_ISCHR(st->st_mode))
+      type = "CHR";
+   else if (S_ISBLK(st->st_mode))
+      type = "BLK";
+   else if (S_ISFIFO(st->st_mode))
+      type = "FIFO";
+   else if (S_ISSOCK(st->st_mode))
+      type = "sock";
+   else if (String_startsWith(link, "anon_inode:"))
+      type = "a_inode";
+   else
+      type = "unknown";
+   String_safeStrncpy(fdata->type, type, sizeof(fdata->type));
+
+   dev_t dev = S_ISCHR(st->st_mode) || S_ISBLK(st->st_mode) ? st->st_rdev : st->st_dev;
+   xSnprintf(fdata->device, sizeof(fdata->device), "%u,%u", major(dev), minor(dev));
+   if (S_ISREG(st->st_mode) || S_ISDIR(st->st_mode))
+      xSnprintf(fdata->size, sizeof(fdata->size), "%lld", (long long)st->st_size);
+   else
+      fdata->size[0] = '\0';
+   xSnprintf(fdata->node, sizeof(fdata->node), "%llu", (unsigned long long)st->st_ino);
+}
+
+typedef struct OpenFilesScan_ {
+   pid_t pid;
+   const OpenFiles_ProcessData* previous;
+   OpenFiles_ProcessData* pdata;
+   SocketTable* sockets;      /* read on the first socket */
+   bool socketsRead;
+} OpenFilesScan;
+
+static void Platform_addOpenFile(OpenFilesScan* scan, int dirFd, const char* dirPath, const char* infoPath, const char* name, int number, const char* fd) {
+   char link[PATH_MAX];
+   ssize_t len = Compat_readlinkat(dirFd, dirPath, name, link, sizeof(link) - 1);
+   if (len < 0)
+      return;
+   link[len] = '\0';
+
+   OpenFiles_ProcessData* pdata = scan->pdata;
+
+   // a descriptor that still points to the same thing keeps what was found out about it,
+   // only the size and offset of regular files move; sockets change state and peers,
+   // so they are described again from the fresh socket table
+   const OpenFiles_FileData* prev = scan->previous ? OpenFiles_ProcessData_find(scan->previous, number) : NULL;
+   if (prev && prev->link && !String_startsWith(link, "socket:") && String_eq(OpenFiles_ProcessData_name(scan->previous, prev->link), link)) {
+      OpenFiles_FileData* fdata = OpenFiles_ProcessData_add(pdata);
+      *fdata = *prev;
+      fdata->name = OpenFiles_ProcessData_addName(pdata, OpenFiles_ProcessData_name(scan->previous, prev->name));
+      fdata->link = OpenFiles_ProcessData_addName(pdata, link);
+      if (String_eq(fdata->type, "REG")) {
+         struct stat st;
+         if (Compat_fstatat(dirFd, dirPath, name, &st, 0) == 0)
+            Platform_statFile(&st, link, fdata);
+         if (infoPath)
+            Platform_readFileInfo(infoPath, name, fdata, true);
+      }
+      return;
+   }
+
+   OpenFiles_FileData* fdata = OpenFiles_ProcessData_add(pdata);
+   fdata->number = number;
+   String_safeStrncpy(fdata->fd, fd, sizeof(fdata->fd));
+
+   struct stat st;
+   bool statOk = Compat_fstatat(dirFd, dirPath, name, &st, 0) == 0;
+   if (statOk)
+      Platform_statFile(&st, link, fdata);
+   else
+      String_safeStrncpy(fdata->type, String_startsWith(link, "anon_inode:") ? "a_inode" : "unknown", sizeof(fdata->type));
+   if (infoPath)
+      Platform_readFileInfo(infoPath, name, fdata, statOk && (S_ISREG(st.st_mode) || S_ISBLK(st.st_mode) || S_ISCHR(st.st_mode)));
+
+   const char* shown = link;
+   char description[512];
+   unsigned long long inode;
+   if (sscanf(link, "socket:[%llu]", &inode) == 1) {
+      if (!scan->socketsRead) {
+         char netPath[64];
+         xSnprintf(netPath, sizeof(netPath), "%s/%d/net", PROCDIR, scan->pid);
+         scan->sockets = SocketTable_new();
+         SocketTable_read(scan->sockets, netPath);
+         scan->socketsRead = true;
+      }
+      const SocketEntry* entry = SocketTable_get(scan->sockets, inode);
+      if (entry) {
+         String_safeStrncpy(fdata->type, SocketTable_family(entry), sizeof(fdata->type));
+         SocketTable_describe(scan->sockets, entry, description, sizeof(description));
+         shown = description;
+      }
+   }
+
+   fdata->name = OpenFiles_ProcessData_addName(pdata, shown);
+   fdata->link = OpenFiles_ProcessData_addName(pdata, link);
+}
+
+bool Platform_getProcessFiles(pid_t pid, const OpenFiles_ProcessData* previous, OpenFiles_ProcessData* pdata) {
+   char procPath[64];
+   char fdPath[64];
+   char infoPath[64];
+   xSnprintf(procPath, sizeof(procPath), "%s/%d", PROCDIR, pid);
+   xSnprintf(fdPath, sizeof(fdPath), "%s/fd", procPath);
+   xSnprintf(infoPath, sizeof(infoPath), "%s/fdinfo", procPath);
+
+   DIR* fdDir = opendir(fdPath);
+   if (!fdDir) {
+      pdata->error = 1;
+      return true;
+   }
+
+   OpenFilesScan scan = {
+      .pid = pid,
+      .previous = previous,
+      .pdata = pdata,
+   };
+
+   DIR* procDir = opendir(procPath);
+   if (procDir) {
+      Platform_addOpenFile(&scan, dirfd(procDir), procPath, NULL, "cwd", OPENFILES_FD_CWD, "cwd");
+      Platform_addOpenFile(&scan, dirfd(procDir), procPath, NULL, "root", OPENFILES_FD_ROOT, "rtd");
+      Platform_addOpenFile(&scan, dirfd(procDir), procPath, NULL, "exe", OPENFILES_FD_TEXT, "txt");
+      closedir(procDir);
+   }
+
+   const struct dirent* entry;
+   while ((entry = readdir(fdDir))) {
+      char* end;
+      long number = strtol(entry->d_name, &end, 10);
+      if (end == entry->d_name || *end || number < 0 || number > INT_MAX)
+         continue;
+
+      Platform_addOpenFile(&scan, dirfd(fdDir), fdPath, infoPath, entry->d_name, (int)number, entry->d_name);
+   }
+   closedir(fdDir);
+
+   SocketTable_delete(scan.sockets);
+   return true;
+}
+
+FILE* Platform_openProcessSmaps(pid_t pid) {
+   char path[PATH_MAX];
+   xSnprintf(path, sizeof(path), "%s/%d/smaps", PROCDIR, pid);
+   return fopen(path, "r");
+}
+
 void Platform_getPressureStall(const char* file, bool some, double* ten, double* sixty, double* threehundred) {
    *ten = *sixty = *threehundred = 0;
    char procname[128];
    xSnprintf(procname, sizeof(procname), PROCDIR "/pressure/%s", file);
-   FILE* fd = fopen(procname, "r");
-   if (!fd) {
+   const char* buf = ProcFileCache_get(procname, NULL);
+   if (!buf) {
       *ten = *sixty = *threehundred = NAN;
       return;
    }
-   int total = fscanf(fd, "some avg10=%32lf avg60=%32lf avg300=%32lf total=%*f ", ten, sixty, threehundred);
    if (!some) {
-      total = fscanf(fd, "full avg10=%32lf avg60=%32lf avg300=%32lf total=%*f ", ten, sixty, threehundred);
+      buf = strstr(buf, "full ");
+      if (!buf) {
+         *ten = *sixty = *threehundred = NAN;
+         return;
+      }
    }
+   int total = sscanf(buf, some ? "some avg10=%32lf avg60=%32lf avg300=%32lf" : "full avg10=%32lf avg60=%32lf avg300=%32lf", ten, sixty, threehundred);
    (void) total;
    assert(total == 3);
-   fclose(fd);
 }
 
 bool Platform_getDiskIO(DiskIOData* data) {
-   FILE* fd = fopen(PROCDIR "/diskstats", "r");
-   if (!fd)
+   const char* buf = ProcFileCache_get(PROCDIR "/diskstats", NULL);
+   if (!buf)
       return false;
 
    unsigned long long int read_sum = 0, write_sum = 0, timeSpend_sum = 0;
    char lineBuffer[256];
-   while (fgets(lineBuffer, sizeof(lineBuffer), fd)) {
+   while ((buf = ProcFileCache_nextLine(buf, lineBuffer, sizeof(lineBuffer)))) {
       char diskname[32];
       unsigned long long int read_tmp, write_tmp, timeSpend_tmp;
       if (sscanf(lineBuffer, "%*d %*d %31s %*u %*u %llu %*u %*u %*u %llu %*u %*u %llu", diskname, &read_tmp, &write_tmp, &timeSpend_tmp) == 4) {
@@ -533,7 +821,6 @@ bool Platform_getDiskIO(DiskIOData* data) {
          timeSpend_sum += timeSpend_tmp;
       }
    }
-   fclose(fd);
    /* multiply with sector size */
    data->totalBytesRead = 512 * read_sum;
    data->totalBytesWritten = 512 * write_sum;
@@ -573,6 +860,85 @@ bool Platform_getNetworkIO(NetworkIOData* data) {
    return true;
 }
 
+void Platform_exportMetrics(const ProcessList* pl, Exporter* out) {
+   const LinuxProcessList* lpl = (const LinuxProcessList*) pl;
+   char labels[64];
+
+   long ticks = sysconf(_SC_CLK_TCK);
+   if (ticks > 0) {
+      Exporter_family(out, "htop_cpu_seconds", "counter", "Time each CPU spent in each mode");
+      for (unsigned int i = 0; i < pl->cpuCount; i++) {
+         const CPUData* cpu = &lpl->cpus[i + 1];
+         if (!cpu->online)
+            continue;
+         const struct { const char* mode; unsigned long long int time; } modes[] = {
+            { "user", cpu->userTime },
+            { "nice", cpu->niceTime },
+            { "system", cpu->systemTime },
+            { "idle", cpu->idleTime },
+            { "iowait", cpu->ioWaitTime },
+            { "irq", cpu->irqTime },
+            { "softirq", cpu->softIrqTime },
+            { "steal", cpu->stealTime },
+            { "guest", cpu->guestTime },
+         };
+         for (size_t m = 0; m < ARRAYSIZE(modes); m++) {
+            xSnprintf(labels, sizeof(labels), "cpu=\"%u\",mode=\"%s\"", i, modes[m].mode);
+            Exporter_sample(out, "htop_cpu_seconds_total", labels, (double)modes[m].time / ticks);
+         }
+      }
+   }
+
+   if (lpl->zram.totalZram > 0) {
+      Exporter_family(out, "htop_zram_bytes", "gauge", "Compressed RAM disks used as swap");
+      Exporter_sample(out, "htop_zram_bytes", "kind=\"total\"", (double)lpl->zram.totalZram * ONE_K);
+      Exporter_sample(out, "htop_zram_bytes", "kind=\"compressed\"", (double)lpl->zram.usedZramComp * ONE_K);
+      Exporter_sample(out, "htop_zram_bytes", "kind=\"original\"", (double)lpl->zram.usedZramOrig * ONE_K);
+   }
+
+   if (lpl->zfs.enabled) {
+      const struct { const char* kind; unsigned long long int size; } arc[] = {
+         { "size", lpl->zfs.size },
+         { "max", lpl->zfs.max },
+         { "mfu", lpl->zfs.MFU },
+         { "mru", lpl->zfs.MRU },
+         { "anon", lpl->zfs.anon },
+         { "header", lpl->zfs.header },
+         { "other", lpl->zfs.other },
+      };
+      Exporter_family(out, "htop_zfs_arc_bytes", "gauge", "ZFS adaptive replacement cache");
+      for (size_t k = 0; k < ARRAYSIZE(arc); k++) {
+         xSnprintf(labels, sizeof(labels), "kind=\"%s\"", arc[k].kind);
+         Exporter_sample(out, "htop_zfs_arc_bytes", labels, (double)arc[k].size * ONE_K);
+      }
+      if (lpl->zfs.isCompressed) {
+         Exporter_sample(out, "htop_zfs_arc_bytes", "kind=\"compressed\"", (double)lpl->zfs.compressed * ONE_K);
+         Exporter_sample(out, "htop_zfs_arc_bytes", "kind=\"uncompressed\"", (double)lpl->zfs.uncompressed * ONE_K);
+      }
+   }
+
+   static const char* const resources[] = { "cpu", "io", "memory" };
+   bool familyWritten = false;
+   for (size_t r = 0; r < ARRAYSIZE(resources); r++) {
+      for (int some = 1; some >= 0; some--) {
+         double avg[3];
+         Platform_getPressureStall(resources[r], some, &avg[0], &avg[1], &avg[2]);
+         if (isnan(avg[0]))
+            continue;
+
+         if (!familyWritten) {
+            Exporter_family(out, "htop_pressure_percent", "gauge", "Share of time tasks were stalled on a resource (PSI)");
+            familyWritten = true;
+         }
+         static const char* const windows[] = { "10s", "60s", "300s" };
+         for (int w = 0; w < 3; w++) {
+            xSnprintf(labels, sizeof(labels), "resource=\"%s\",kind=\"%s\",window=\"%s\"", resources[r], some ? "some" : "full", windows[w]);
+            Exporter_sample(out, "htop_pressure_percent", labels, avg[w]);
+         }
+      }
+   }
+}
+
 // Linux battery reading by Ian P. Hands (iphands@gmail.com, ihands@redhat.com).
 
 #define MAX_BATTERIES 64
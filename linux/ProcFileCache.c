@@ -0,0 +1,153 @@
+/*
+htop - ProcFileCache.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "ProcFileCache.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Macros.h"
+#include "Profile.h"
+#include "XUtils.h"
+
+
+/* Global files like /proc/stat or /proc/diskstats are wanted by the process
+ * list and by several meters in the same cycle.  Each one is kept open and
+ * read with pread() at most once per cycle; later readers share the buffer. */
+
+#define PROCFILECACHE_MAX_ENTRIES 32
+#define PROCFILECACHE_INITIAL_SIZE 4096
+
+typedef struct ProcFileCacheEntry_ {
+   char* path;
+   int fd;                   /* -1 while the file can not be opened */
+   char* buffer;
+   size_t size;
+   size_t len;
+   bool valid;               /* last read succeeded */
+   unsigned int generation;  /* cycle the buffer was filled in */
+} ProcFileCacheEntry;
+
+static ProcFileCacheEntry ProcFileCache_entries[PROCFILECACHE_MAX_ENTRIES];
+static unsigned int ProcFileCache_count;
+static unsigned int ProcFileCache_generation = 1;
+static unsigned long long ProcFileCache_saved;
+
+void ProcFileCache_invalidate(void) {
+   ProcFileCache_generation++;
+}
+
+static bool ProcFileCache_fill(ProcFileCacheEntry* entry) {
+   if (entry->fd < 0) {
+      entry->fd = open(entry->path, O_RDONLY | O_CLOEXEC);
+      if (entry->fd < 0)
+         return false;
+      Profile_count(PROFILE_FILES_OPENED, 1);
+   }
+
+   size_t used = 0;
+   for (;;) {
+      if (used + 1 >= entry->size) {
+         entry->size = entry->size ? entry->size * 2 : PROCFILECACHE_INITIAL_SIZE;
+         entry->buffer = xRealloc(entry->buffer, entry->size);
+      }
+
+      ssize_t r = pread(entry->fd, entry->buffer + used, entry->size - used - 1, (off_t)used);
+      if (r < 0) {
+         if (errno == EINTR)
+            continue;
+
+         // the file may have gone away, try to reopen it next cycle
+         close(entry->fd);
+         entry->fd = -1;
+         return false;
+      }
+      if (r == 0)
+         break;
+
+      used += (size_t)r;
+   }
+
+   entry->buffer[used] = '\0';
+   entry->len = used;
+   Profile_count(PROFILE_BYTES_READ, used);
+   return true;
+}
+
+static ProcFileCacheEntry* ProcFileCache_lookup(const char* path) {
+   for (unsigned int i = 0; i < ProcFileCache_count; i++) {
+      if (String_eq(ProcFileCache_entries[i].path, path))
+         return &ProcFileCache_entries[i];
+   }
+
+   if (ProcFileCache_count == PROCFILECACHE_MAX_ENTRIES)
+      return NULL;
+
+   ProcFileCacheEntry* entry = &ProcFileCache_entries[ProcFileCache_count++];
+   entry->path = xStrdup(path);
+   entry->fd = -1;
+   return entry;
+}
+
+const char* ProcFileCache_get(const char* path, size_t* len) {
+   ProcFileCacheEntry* entry = ProcFileCache_lookup(path);
+   if (!entry)
+      return NULL;
+
+   if (entry->generation == ProcFileCache_generation) {
+      ProcFileCache_saved++;
+   } else {
+      entry->generation = ProcFileCache_generation;
+      entry->valid = ProcFileCache_fill(entry);
+   }
+
+   if (!entry->valid)
+      return NULL;
+
+   if (len)
+      *len = entry->len;
+   return entry->buffer;
+}
+
+const char* ProcFileCache_nextLine(const char* pos, char* line, size_t size) {
+   if (!pos || !*pos)
+      return NULL;
+
+   const char* end = strchr(pos, '\n');
+   size_t n = end ? (size_t)(end - pos) : strlen(pos);
+   size_t copy = MINIMUM(n, size - 1);
+   memcpy(line, pos, copy);
+   line[copy] = '\0';
+
+   return end ? end + 1 : pos + n;
+}
+
+unsigned long long ProcFileCache_readsSaved(void) {
+   return ProcFileCache_saved;
+}
+
+unsigned int ProcFileCache_size(void) {
+   return ProcFileCache_count;
+}
+
+void ProcFileCache_done(void) {
+   for (unsigned int i = 0; i < ProcFileCache_count; i++) {
+      ProcFileCacheEntry* entry = &ProcFileCache_entries[i];
+      if (entry->fd >= 0)
+         close(entry->fd);
+      free(entry->buffer);
+      free(entry->path);
+   }
+   memset(ProcFileCache_entries, 0, sizeof(ProcFileCache_entries));
+   ProcFileCache_count = 0;
+}
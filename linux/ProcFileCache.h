@@ -0,0 +1,31 @@
+#ifndef HEADER_ProcFileCache
+#define HEADER_ProcFileCache
+/*
+htop - ProcFileCache.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stddef.h>
+
+
+/* Start a new update cycle: every cached file is read again on next access. */
+void ProcFileCache_invalidate(void);
+
+/* Contents of a global kernel file as of the current cycle, NUL-terminated,
+ * or NULL if it can not be read.  The buffer stays valid until the next
+ * ProcFileCache_invalidate() call. */
+const char* ProcFileCache_get(const char* path, size_t* len);
+
+/* Copy the line starting at pos into line (without the newline) and return
+ * the start of the following line, or NULL once the end was reached. */
+const char* ProcFileCache_nextLine(const char* pos, char* line, size_t size);
+
+unsigned long long ProcFileCache_readsSaved(void);
+
+unsigned int ProcFileCache_size(void);
+
+void ProcFileCache_done(void);
+
+#endif
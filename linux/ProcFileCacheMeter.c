@@ -0,0 +1,56 @@
+/*
+htop - ProcFileCacheMeter.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "ProcFileCacheMeter.h"
+
+#include "CRT.h"
+#include "Macros.h"
+#include "Meter.h"
+#include "Object.h"
+#include "ProcFileCache.h"
+#include "RichString.h"
+#include "XUtils.h"
+
+
+static const int ProcFileCacheMeter_attributes[] = {
+   METER_VALUE
+};
+
+static void ProcFileCacheMeter_updateValues(Meter* this) {
+   this->values[0] = (double) ProcFileCache_readsSaved();
+   xSnprintf(this->txtBuffer, sizeof(this->txtBuffer), "%llu okuma kaydedildi, %u dosya", ProcFileCache_readsSaved(), ProcFileCache_size());
+}
+
+static void ProcFileCacheMeter_display(ATTR_UNUSED const Object* cast, RichString* out) {
+   char buffer[32];
+
+   xSnprintf(buffer, sizeof(buffer), "%llu", ProcFileCache_readsSaved());
+   RichString_writeAscii(out, CRT_colors[METER_VALUE], buffer);
+   RichString_appendAscii(out, CRT_colors[METER_TEXT], " okuma kaydedildi, ");
+
+   xSnprintf(buffer, sizeof(buffer), "%u", ProcFileCache_size());
+   RichString_appendAscii(out, CRT_colors[METER_VALUE], buffer);
+   RichString_appendWide(out, CRT_colors[METER_TEXT], " dosya önbellekte");
+}
+
+const MeterClass ProcFileCacheMeter_class = {
+   .super = {
+      .extends = Class(Meter),
+      .delete = Meter_delete,
+      .display = ProcFileCacheMeter_display,
+   },
+   .updateValues = ProcFileCacheMeter_updateValues,
+   .defaultMode = TEXT_METERMODE,
+   .supportedModes = (1 << TEXT_METERMODE),
+   .maxItems = 1,
+   .total = 100.0,
+   .attributes = ProcFileCacheMeter_attributes,
+   .name = "ProcFileCache",
+   .uiName = "Proc dosya önbelleği",
+   .caption = "Önbellek: ",
+   .description = "Aynı döngüde paylaşılan /proc ve /sys okumaları"
+};
@@ -0,0 +1,14 @@
+#ifndef HEADER_ProcFileCacheMeter
+#define HEADER_ProcFileCacheMeter
+/*
+htop - ProcFileCacheMeter.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "Meter.h"
+
+extern const MeterClass ProcFileCacheMeter_class;
+
+#endif
@@ -0,0 +1,121 @@
+/*
+htop - ProcKeyTable.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "ProcKeyTable.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CRT.h"
+#include "XUtils.h"
+
+
+/* FNV-1a over the key, the seed picks one of a family of hashes */
+static inline uint32_t ProcKeyTable_hash(uint32_t seed, const char* key, size_t len) {
+   uint32_t hash = 2166136261U ^ seed;
+   for (size_t i = 0; i < len; i++) {
+      hash ^= (unsigned char)key[i];
+      hash *= 16777619U;
+   }
+   return hash ^ (hash >> 15);
+}
+
+static bool ProcKeyTable_place(ProcKeyTable* this) {
+   memset(this->slots, 0, this->mask + 1);
+   for (unsigned int i = 0; i < this->count; i++) {
+      const char* key = this->fields[i].key;
+      uint32_t slot = ProcKeyTable_hash(this->seed, key, strlen(key)) & this->mask;
+      if (this->slots[slot])
+         return false;
+      this->slots[slot] = (uint8_t)(i + 1);
+   }
+   return true;
+}
+
+/*
+ * The keys are fixed, so a seed without collisions is searched once: a
+ * table with four slots per key is almost always free of them within a
+ * few seeds, and a larger one is tried if not.
+ */
+static void ProcKeyTable_build(ProcKeyTable* this) {
+   assert(this->count > 0 && this->count <= 64);
+
+   uint32_t size = 4;
+   while (size < this->count * 4)
+      size *= 2;
+
+   for (;; size *= 2) {
+      if (size > 65536)
+         CRT_fatalError("Cannot place the keys of a kernel file");
+      this->mask = size - 1;
+      this->slots = xRealloc(this->slots, size);
+      for (this->seed = 0; this->seed < 64; this->seed++) {
+         if (ProcKeyTable_place(this))
+            return;
+      }
+   }
+}
+
+static inline unsigned long long int ProcKeyTable_number(const char** pos) {
+   const char* p = *pos;
+   while (*p == ' ' || *p == '\t')
+      p++;
+
+   unsigned long long int value = 0;
+   for (unsigned int digit; (digit = (unsigned int)(unsigned char)*p - '0') < 10; p++)
+      value = value * 10 + digit;
+
+   *pos = p;
+   return value;
+}
+
+uint64_t ProcKeyTable_parse(ProcKeyTable* this, const char* text, void* target) {
+   if (!this->slots)
+      ProcKeyTable_build(this);
+
+   uint64_t found = 0;
+   const char* pos = text;
+   while (*pos) {
+      // the key ends at the colon of "Key: value" or at the blank of "key value"
+      const char* key = pos;
+      while (*pos && *pos != ':' && *pos != ' ' && *pos != '\t' && *pos != '\n')
+         pos++;
+      size_t len = (size_t)(pos - key);
+
+      unsigned int index = this->slots[ProcKeyTable_hash(this->seed, key, len) & this->mask];
+      if (index) {
+         const ProcKeyField* field = &this->fields[index - 1];
+         if (strncmp(field->key, key, len) == 0 && field->key[len] == '\0') {
+            if (*pos == ':')
+               pos++;
+            for (unsigned int c = 0; c < this->column; c++) {
+               while (*pos == ' ' || *pos == '\t')
+                  pos++;
+               while (*pos && *pos != ' ' && *pos != '\t' && *pos != '\n')
+                  pos++;
+            }
+            *(unsigned long long int*)((char*)target + field->offset) = ProcKeyTable_number(&pos);
+            found |= UINT64_C(1) << (index - 1);
+         }
+      }
+
+      pos = strchr(pos, '\n');
+      if (!pos)
+         break;
+      pos++;
+   }
+   return found;
+}
+
+void ProcKeyTable_done(ProcKeyTable* this) {
+   free(this->slots);
+   this->slots = NULL;
+}
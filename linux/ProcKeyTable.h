@@ -0,0 +1,46 @@
+#ifndef HEADER_ProcKeyTable
+#define HEADER_ProcKeyTable
+/*
+htop - ProcKeyTable.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Macros.h"
+
+
+/* A key wanted from a "key value" file and where its value goes in the target struct */
+typedef struct ProcKeyField_ {
+   const char* key;
+   size_t offset;             /* of an unsigned long long int */
+} ProcKeyField;
+
+/*
+ * Kernel files like /proc/meminfo or /proc/vmstat list many more keys than
+ * a reader wants.  The wanted keys are placed in a table by a hash without
+ * collisions among them, so every line costs one hash of its key and at
+ * most one comparison, whether it is wanted or not.
+ */
+typedef struct ProcKeyTable_ {
+   const ProcKeyField* fields;
+   unsigned int count;        /* at most 64 */
+   unsigned int column;       /* columns between key and value, 1 for "key type value" */
+   uint32_t seed;
+   uint32_t mask;
+   uint8_t* slots;            /* field index + 1 of each slot, 0 if empty; built on first use */
+} ProcKeyTable;
+
+#define PROCKEYTABLE_INIT(fields_, column_) { .fields = (fields_), .count = ARRAYSIZE(fields_), .column = (column_) }
+
+/* Stores the value of every wanted key in text into target and returns a
+ * mask with the bit of each field index that was found.  Fields that are
+ * not found are left as they are. */
+uint64_t ProcKeyTable_parse(ProcKeyTable* this, const char* text, void* target);
+
+void ProcKeyTable_done(ProcKeyTable* this);
+
+#endif
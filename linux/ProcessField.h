@@ -47,6 +47,8 @@ in the source distribution for its full text.
    PROC_COMM = 124,              \
    PROC_EXE = 125,               \
    CWD = 126,                    \
+   SOCKETS = 127,                \
+   LISTEN_PORTS = 128,           \
    // End of list
 
 
@@ -0,0 +1,70 @@
+/*
+htop - SchedulerMeter.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "SchedulerMeter.h"
+
+#include "CRT.h"
+#include "LinuxProcessList.h"
+#include "Macros.h"
+#include "Meter.h"
+#include "Object.h"
+#include "RichString.h"
+#include "XUtils.h"
+
+
+static const int SchedulerMeter_attributes[] = {
+   METER_VALUE,
+   METER_VALUE,
+   METER_VALUE,
+};
+
+static void SchedulerMeter_updateValues(Meter* this) {
+   const LinuxProcessList* lpl = (const LinuxProcessList*) this->pl;
+
+   /* the counters of /proc/stat are per scan, shown per second */
+   double seconds = lpl->statPeriodMs / 1000.0;
+   this->values[0] = seconds > 0 ? lpl->contextSwitchesPeriod / seconds : 0.0;
+   this->values[1] = seconds > 0 ? lpl->forksPeriod / seconds : 0.0;
+   this->values[2] = lpl->blockedTasks;
+
+   xSnprintf(this->txtBuffer, sizeof(this->txtBuffer), "%.0f bağlam/s, %.1f fork/s, %u G/Ç bekleyen",
+             this->values[0], this->values[1], lpl->blockedTasks);
+}
+
+static void SchedulerMeter_display(const Object* cast, RichString* out) {
+   const Meter* this = (const Meter*)cast;
+   char buffer[32];
+
+   xSnprintf(buffer, sizeof(buffer), "%.0f", this->values[0]);
+   RichString_writeAscii(out, CRT_colors[METER_VALUE], buffer);
+   RichString_appendWide(out, CRT_colors[METER_TEXT], " bağlam değişimi/s, ");
+
+   xSnprintf(buffer, sizeof(buffer), "%.1f", this->values[1]);
+   RichString_appendAscii(out, CRT_colors[METER_VALUE], buffer);
+   RichString_appendAscii(out, CRT_colors[METER_TEXT], " fork/s, ");
+
+   xSnprintf(buffer, sizeof(buffer), "%.0f", this->values[2]);
+   RichString_appendAscii(out, this->values[2] > 0 ? CRT_colors[METER_VALUE_WARN] : CRT_colors[METER_VALUE], buffer);
+   RichString_appendWide(out, CRT_colors[METER_TEXT], " G/Ç bekleyen");
+}
+
+const MeterClass SchedulerMeter_class = {
+   .super = {
+      .extends = Class(Meter),
+      .delete = Meter_delete,
+      .display = SchedulerMeter_display,
+   },
+   .updateValues = SchedulerMeter_updateValues,
+   .defaultMode = TEXT_METERMODE,
+   .maxItems = 3,
+   .total = 100.0,
+   .attributes = SchedulerMeter_attributes,
+   .name = "Scheduler",
+   .uiName = "Zamanlayıcı",
+   .caption = "Zmn: ",
+   .description = "Bağlam değişimleri ve fork'lar saniyede, G/Ç bekleyen görevler"
+};
@@ -0,0 +1,405 @@
+/*
+htop - linux/SocketTable.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "SocketTable.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "Macros.h"
+#include "XUtils.h"
+
+
+static const char* const SocketTable_files[SOCKET_PROTOCOLS] = {
+   [SOCKET_TCP] = "tcp",
+   [SOCKET_TCP6] = "tcp6",
+   [SOCKET_UDP] = "udp",
+   [SOCKET_UDP6] = "udp6",
+   [SOCKET_UNIX] = "unix",
+};
+
+static const char* const SocketTable_stateNames[SOCKET_STATES] = {
+   [SOCKET_ESTABLISHED] = "ESTABLISHED",
+   [SOCKET_SYN_SENT] = "SYN_SENT",
+   [SOCKET_SYN_RECV] = "SYN_RECV",
+   [SOCKET_FIN_WAIT1] = "FIN_WAIT1",
+   [SOCKET_FIN_WAIT2] = "FIN_WAIT2",
+   [SOCKET_TIME_WAIT] = "TIME_WAIT",
+   [SOCKET_CLOSE] = "CLOSE",
+   [SOCKET_CLOSE_WAIT] = "CLOSE_WAIT",
+   [SOCKET_LAST_ACK] = "LAST_ACK",
+   [SOCKET_LISTEN] = "LISTEN",
+   [SOCKET_CLOSING] = "CLOSING",
+};
+
+SocketTable* SocketTable_new(void) {
+   SocketTable* this = xCalloc(1, sizeof(SocketTable));
+   this->byInode = Hashtable_new(1024, false);
+   return this;
+}
+
+void SocketTable_delete(SocketTable* this) {
+   if (!this)
+      return;
+
+   Hashtable_delete(this->byInode);
+   free(this->entries);
+   free(this->paths);
+   free(this);
+}
+
+static size_t SocketTable_addPath(SocketTable* this, const char* path, size_t len) {
+   if (this->pathsSize + len + 1 > this->pathsCapacity) {
+      this->pathsCapacity = MAXIMUM(this->pathsCapacity * 2, this->pathsSize + len + 1);
+      this->paths = xRealloc(this->paths, this->pathsCapacity);
+   }
+   size_t offset = this->pathsSize;
+   memcpy(this->paths + offset, path, len);
+   this->paths[offset + len] = '\0';
+   this->pathsSize += len + 1;
+   return offset;
+}
+
+static SocketEntry* SocketTable_add(SocketTable* this) {
+   if (this->count == this->capacity) {
+      this->capacity = MAXIMUM(this->capacity * 2, 64);
+      this->entries = xReallocArray(this->entries, this->capacity, sizeof(SocketEntry));
+   }
+   SocketEntry* entry = &this->entries[this->count++];
+   memset(entry, 0, sizeof(SocketEntry));
+   return entry;
+}
+
+static inline const char* skipSpaces(const char* p) {
+   while (*p == ' ' || *p == '\t')
+      p++;
+   return p;
+}
+
+static inline const char* skipField(const char* p) {
+   p = skipSpaces(p);
+   while (*p && *p != ' ' && *p != '\t' && *p != '\n')
+      p++;
+   return p;
+}
+
+static inline int hexDigit(char c) {
+   if (c >= '0' && c <= '9')
+      return c - '0';
+   if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+   if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+   return -1;
+}
+
+static const char* parseHex(const char* p, uint64_t* value, unsigned int maxDigits) {
+   uint64_t v = 0;
+   unsigned int n = 0;
+   for (int d; n < maxDigits && (d = hexDigit(*p)) >= 0; p++, n++)
+      v = (v << 4) | (unsigned int)d;
+   *value = v;
+   return n ? p : NULL;
+}
+
+static const char* parseDecimal(const char* p, uint64_t* value) {
+   uint64_t v = 0;
+   const char* start = p;
+   for (; *p >= '0' && *p <= '9'; p++)
+      v = v * 10 + (uint64_t)(*p - '0');
+   *value = v;
+   return p != start ? p : NULL;
+}
+
+/* An address as printed by the kernel: 32 bit words in host byte order, then ":PORT" */
+static const char* parseEndpoint(const char* p, uint8_t* address, unsigned int words, uint16_t* port) {
+   for (unsigned int i = 0; i < words; i++) {
+      uint64_t word;
+      if (!(p = parseHex(p, &word, 8)))
+         return NULL;
+      uint32_t w = (uint32_t)word;
+      memcpy(address + 4 * i, &w, sizeof(w));
+   }
+   if (*p != ':')
+      return NULL;
+
+   uint64_t value;
+   if (!(p = parseHex(p + 1, &value, 4)))
+      return NULL;
+   *port = (uint16_t)value;
+   return p;
+}
+
+/* "  sl  local_address rem_address   st tx_queue rx_queue tr tm->when retrnsmt   uid  timeout inode" */
+static bool SocketTable_parseInet(SocketEntry* entry, const char* line, unsigned int words) {
+   const char* p = strchr(line, ':');
+   if (!p)
+      return false;
+
+   p = skipSpaces(p + 1);
+   if (!(p = parseEndpoint(p, entry->local, words, &entry->localPort)))
+      return false;
+   p = skipSpaces(p);
+   if (!(p = parseEndpoint(p, entry->remote, words, &entry->remotePort)))
+      return false;
+
+   uint64_t state;
+   if (!(p = parseHex(skipSpaces(p), &state, 2)))
+      return false;
+   entry->state = (uint8_t)state;
+
+   // tx_queue:rx_queue, tr:tm->when, retrnsmt, uid and timeout come before the inode
+   for (int i = 0; i < 5; i++)
+      p = skipField(p);
+
+   return parseDecimal(skipSpaces(p), &entry->inode) != NULL;
+}
+
+/* "Num       RefCount Protocol Flags    Type St Inode Path" */
+static bool SocketTable_parseUnix(SocketTable* this, SocketEntry* entry, const char* line) {
+   const char* p = strchr(line, ':');
+   if (!p)
+      return false;
+
+   // RefCount, Protocol and Flags
+   p++;
+   for (int i = 0; i < 3; i++)
+      p = skipField(p);
+
+   uint64_t type, state;
+   if (!(p = parseHex(skipSpaces(p), &type, 4)))
+      return false;
+   if (!(p = parseHex(skipSpaces(p), &state, 2)))
+      return false;
+   if (!(p = parseDecimal(skipSpaces(p), &entry->inode)))
+      return false;
+   entry->unixType = (uint8_t)type;
+   entry->state = (uint8_t)state;
+
+   p = skipSpaces(p);
+   size_t len = strcspn(p, "\n");
+   if (len)
+      entry->path = SocketTable_addPath(this, p, len);
+   return true;
+}
+
+bool SocketTable_read(SocketTable* this, const char* netDir) {
+   this->count = 0;
+   this->pathsSize = 0;
+   SocketTable_addPath(this, "", 0);
+   Hashtable_clear(this->byInode);
+
+   bool any = false;
+   for (int protocol = 0; protocol < SOCKET_PROTOCOLS; protocol++) {
+      char filename[256];
+      xSnprintf(filename, sizeof(filename), "%s/%s", netDir, SocketTable_files[protocol]);
+      FILE* f = fopen(filename, "r");
+      if (!f)
+         continue;
+      any = true;
+
+      char line[512];
+      // the first line names the columns
+      if (!fgets(line, sizeof(line), f)) {
+         fclose(f);
+         continue;
+      }
+
+      while (fgets(line, sizeof(line), f)) {
+         SocketEntry* entry = SocketTable_add(this);
+         entry->protocol = protocol;
+
+         bool ok;
+         switch (protocol) {
+         case SOCKET_TCP:
+         case SOCKET_UDP:
+            ok = SocketTable_parseInet(entry, line, 1);
+            break;
+         case SOCKET_TCP6:
+         case SOCKET_UDP6:
+            ok = SocketTable_parseInet(entry, line, 4);
+            break;
+         default:
+            ok = SocketTable_parseUnix(this, entry, line);
+            break;
+         }
+         // sockets in TIME_WAIT and the like have no inode, no process can own them
+         if (!ok || entry->inode == 0)
+            this->count--;
+      }
+      fclose(f);
+   }
+
+   // the entries do not move any more, index them
+   Hashtable_setSize(this->byInode, this->count * 2);
+   for (size_t i = 0; i < this->count; i++)
+      Hashtable_put(this->byInode, (ht_key_t)this->entries[i].inode, &this->entries[i]);
+
+   return any;
+}
+
+const SocketEntry* SocketTable_get(const SocketTable* this, uint64_t inode) {
+   const SocketEntry* entry = Hashtable_get(this->byInode, (ht_key_t)inode);
+   return entry && entry->inode == inode ? entry : NULL;
+}
+
+const char* SocketTable_family(const SocketEntry* entry) {
+   switch (entry->protocol) {
+   case SOCKET_TCP:
+   case SOCKET_UDP:
+      return "IPv4";
+   case SOCKET_TCP6:
+   case SOCKET_UDP6:
+      return "IPv6";
+   default:
+      return "unix";
+   }
+}
+
+static void SocketTable_formatEndpoint(const SocketEntry* entry, const uint8_t* address, uint16_t port, char* buffer, size_t size) {
+   static const uint8_t any[16];
+   bool v6 = entry->protocol == SOCKET_TCP6 || entry->protocol == SOCKET_UDP6;
+
+   char host[INET6_ADDRSTRLEN];
+   if (memcmp(address, any, v6 ? 16 : 4) == 0)
+      String_safeStrncpy(host, "*", sizeof(host));
+   else if (!inet_ntop(v6 ? AF_INET6 : AF_INET, address, host, sizeof(host)))
+      String_safeStrncpy(host, "?", sizeof(host));
+
+   if (port)
+      xSnprintf(buffer, size, v6 && host[0] != '*' ? "[%s]:%u" : "%s:%u", host, port);
+   else
+      xSnprintf(buffer, size, v6 && host[0] != '*' ? "[%s]:*" : "%s:*", host);
+}
+
+void SocketTable_describe(const SocketTable* this, const SocketEntry* entry, char* buffer, size_t size) {
+   if (entry->protocol == SOCKET_UNIX) {
+      const char* type = entry->unixType == SOCK_STREAM ? "STREAM"
+                       : entry->unixType == SOCK_DGRAM ? "DGRAM"
+                       : entry->unixType == SOCK_SEQPACKET ? "SEQPACKET"
+                       : "?";
+      if (entry->path)
+         xSnprintf(buffer, size, "%s type=%s", this->paths + entry->path, type);
+      else
+         xSnprintf(buffer, size, "type=%s", type);
+      return;
+   }
+
+   bool tcp = entry->protocol == SOCKET_TCP || entry->protocol == SOCKET_TCP6;
+   char local[INET6_ADDRSTRLEN + 9];
+   SocketTable_formatEndpoint(entry, entry->local, entry->localPort, local, sizeof(local));
+
+   // listening and unconnected sockets have no remote end
+   if (entry->remotePort == 0) {
+      if (tcp && entry->state < SOCKET_STATES && SocketTable_stateNames[entry->state])
+         xSnprintf(buffer, size, "TCP %s (%s)", local, SocketTable_stateNames[entry->state]);
+      else
+         xSnprintf(buffer, size, "%s %s", tcp ? "TCP" : "UDP", local);
+      return;
+   }
+
+   char remote[INET6_ADDRSTRLEN + 9];
+   SocketTable_formatEndpoint(entry, entry->remote, entry->remotePort, remote, sizeof(remote));
+   if (tcp && entry->state < SOCKET_STATES && SocketTable_stateNames[entry->state])
+      xSnprintf(buffer, size, "TCP %s->%s (%s)", local, remote, SocketTable_stateNames[entry->state]);
+   else
+      xSnprintf(buffer, size, "%s %s->%s", tcp ? "TCP" : "UDP", local, remote);
+}
+
+bool SocketTable_isListening(const SocketEntry* entry) {
+   switch (entry->protocol) {
+   case SOCKET_TCP:
+   case SOCKET_TCP6:
+      return entry->state == SOCKET_LISTEN;
+   case SOCKET_UDP:
+   case SOCKET_UDP6:
+      return entry->state == SOCKET_CLOSE && entry->localPort != 0 && entry->remotePort == 0;
+   default:
+      return false;
+   }
+}
+
+typedef struct SocketNamespace_ {
+   SocketTable* table;
+   bool valid;                /* the table was read during this scan and could be */
+   unsigned int readGeneration;
+   unsigned int usedGeneration;
+} SocketNamespace;
+
+SocketIndex* SocketIndex_new(void) {
+   SocketIndex* this = xCalloc(1, sizeof(SocketIndex));
+   this->namespaces = Hashtable_new(8, false);
+   this->generation = 1;
+   return this;
+}
+
+static void SocketIndex_deleteNamespace(ATTR_UNUSED ht_key_t key, void* value, ATTR_UNUSED void* userdata) {
+   SocketNamespace* ns = value;
+   SocketTable_delete(ns->table);
+   free(ns);
+}
+
+void SocketIndex_delete(SocketIndex* this) {
+   if (!this)
+      return;
+
+   Hashtable_foreach(this->namespaces, SocketIndex_deleteNamespace, NULL);
+   Hashtable_delete(this->namespaces);
+   free(this);
+}
+
+typedef struct SocketIndexStale_ {
+   unsigned int generation;
+   ht_key_t* keys;
+   size_t count;
+   size_t capacity;
+} SocketIndexStale;
+
+static void SocketIndex_collectStale(ht_key_t key, void* value, void* userdata) {
+   const SocketNamespace* ns = value;
+   SocketIndexStale* stale = userdata;
+   if (ns->usedGeneration >= stale->generation)
+      return;
+
+   if (stale->count == stale->capacity) {
+      stale->capacity = MAXIMUM(stale->capacity * 2, 8);
+      stale->keys = xReallocArray(stale->keys, stale->capacity, sizeof(ht_key_t));
+   }
+   stale->keys[stale->count++] = key;
+}
+
+void SocketIndex_invalidate(SocketIndex* this) {
+   // what was not used during the scan that just ended belongs to a namespace that is gone
+   SocketIndexStale stale = { .generation = this->generation };
+   Hashtable_foreach(this->namespaces, SocketIndex_collectStale, &stale);
+   for (size_t i = 0; i < stale.count; i++)
+      SocketIndex_deleteNamespace(stale.keys[i], Hashtable_remove(this->namespaces, stale.keys[i]), NULL);
+   free(stale.keys);
+
+   this->generation++;
+}
+
+const SocketTable* SocketIndex_get(SocketIndex* this, uint64_t netns, const char* netDir) {
+   SocketNamespace* ns = Hashtable_get(this->namespaces, (ht_key_t)netns);
+   if (!ns) {
+      ns = xCalloc(1, sizeof(SocketNamespace));
+      ns->table = SocketTable_new();
+      Hashtable_put(this->namespaces, (ht_key_t)netns, ns);
+   }
+
+   ns->usedGeneration = this->generation;
+   if (ns->readGeneration != this->generation) {
+      ns->valid = SocketTable_read(ns->table, netDir);
+      ns->readGeneration = this->generation;
+   }
+   return ns->valid ? ns->table : NULL;
+}
@@ -0,0 +1,108 @@
+#ifndef HEADER_SocketTable
+#define HEADER_SocketTable
+/*
+htop - linux/SocketTable.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Hashtable.h"
+
+
+typedef enum SocketProtocol_ {
+   SOCKET_TCP,
+   SOCKET_TCP6,
+   SOCKET_UDP,
+   SOCKET_UDP6,
+   SOCKET_UNIX,
+   SOCKET_PROTOCOLS
+} SocketProtocol;
+
+/* TCP states as numbered by the kernel */
+typedef enum SocketState_ {
+   SOCKET_ESTABLISHED = 1,
+   SOCKET_SYN_SENT,
+   SOCKET_SYN_RECV,
+   SOCKET_FIN_WAIT1,
+   SOCKET_FIN_WAIT2,
+   SOCKET_TIME_WAIT,
+   SOCKET_CLOSE,
+   SOCKET_CLOSE_WAIT,
+   SOCKET_LAST_ACK,
+   SOCKET_LISTEN,
+   SOCKET_CLOSING,
+   SOCKET_STATES
+} SocketState;
+
+typedef struct SocketEntry_ {
+   uint64_t inode;
+   SocketProtocol protocol;
+   uint8_t state;             /* SocketState for TCP, the socket state for UDP and UNIX */
+   uint8_t unixType;          /* SOCK_STREAM, SOCK_DGRAM, ... for UNIX sockets */
+   uint16_t localPort;
+   uint16_t remotePort;
+   uint8_t local[16];         /* network byte order, IPv4 addresses use the first 4 bytes */
+   uint8_t remote[16];
+   size_t path;               /* offset of the bound path of a UNIX socket in paths, 0 if it has none */
+} SocketEntry;
+
+/*
+ * The sockets of one network namespace, read from its tcp, tcp6, udp, udp6
+ * and unix tables and indexed by inode, which is what the fd symlinks of
+ * a process name.  The table is reused: reading it again keeps the memory.
+ */
+typedef struct SocketTable_ {
+   SocketEntry* entries;
+   size_t count;
+   size_t capacity;
+   char* paths;               /* NUL separated, starting with an empty string */
+   size_t pathsSize;
+   size_t pathsCapacity;
+   Hashtable* byInode;
+} SocketTable;
+
+SocketTable* SocketTable_new(void);
+
+void SocketTable_delete(SocketTable* this);
+
+/* Reads the tables in netDir (e.g. /proc/net or /proc/<pid>/net), false if none could be read */
+bool SocketTable_read(SocketTable* this, const char* netDir);
+
+const SocketEntry* SocketTable_get(const SocketTable* this, uint64_t inode);
+
+/* "IPv4", "IPv6" or "unix", the address family as open file listings name it */
+const char* SocketTable_family(const SocketEntry* entry);
+
+/* Writes the endpoints and state, e.g. "TCP 10.0.0.1:22->10.0.0.2:51000 (ESTABLISHED)" */
+void SocketTable_describe(const SocketTable* this, const SocketEntry* entry, char* buffer, size_t size);
+
+/* A socket others can connect or send to: listening TCP or bound, unconnected UDP */
+bool SocketTable_isListening(const SocketEntry* entry);
+
+/*
+ * The socket tables of every network namespace seen while scanning, keyed
+ * by the inode of the namespace.  All processes of a namespace share its
+ * table, which is read at most once per scan, and namespaces that were not
+ * seen during a whole scan are forgotten.
+ */
+typedef struct SocketIndex_ {
+   Hashtable* namespaces;
+   unsigned int generation;
+} SocketIndex;
+
+SocketIndex* SocketIndex_new(void);
+
+void SocketIndex_delete(SocketIndex* this);
+
+/* Starts a new scan, the tables are read again on first use */
+void SocketIndex_invalidate(SocketIndex* this);
+
+/* The table of namespace netns as of this scan, read from netDir if it was not yet; NULL if it can not be read */
+const SocketTable* SocketIndex_get(SocketIndex* this, uint64_t netns, const char* netDir);
+
+#endif
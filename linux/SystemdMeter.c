@@ -9,6 +9,8 @@ in the source distribution for its full text.
 
 #include <dlfcn.h>
 #include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -29,17 +31,34 @@ in the source distribution for its full text.
 #ifdef BUILD_STATIC
 
 #define sym_sd_bus_open_system sd_bus_open_system
+#define sym_sd_bus_add_match sd_bus_add_match
+#define sym_sd_bus_call_method sd_bus_call_method
+#define sym_sd_bus_process sd_bus_process
 #define sym_sd_bus_get_property_string sd_bus_get_property_string
 #define sym_sd_bus_get_property_trivial sd_bus_get_property_trivial
+#define sym_sd_bus_message_read sd_bus_message_read
+#define sym_sd_bus_message_enter_container sd_bus_message_enter_container
+#define sym_sd_bus_message_exit_container sd_bus_message_exit_container
+#define sym_sd_bus_message_skip sd_bus_message_skip
 #define sym_sd_bus_unref sd_bus_unref
 
 #else
 
 typedef void sd_bus;
 typedef void sd_bus_error;
+typedef void sd_bus_message;
+typedef void sd_bus_slot;
+typedef int (*sd_bus_message_handler_t)(sd_bus_message*, void*, sd_bus_error*);
 static int (*sym_sd_bus_open_system)(sd_bus**);
+static int (*sym_sd_bus_add_match)(sd_bus*, sd_bus_slot**, const char*, sd_bus_message_handler_t, void*);
+static int (*sym_sd_bus_call_method)(sd_bus*, const char*, const char*, const char*, const char*, sd_bus_error*, sd_bus_message**, const char*, ...);
+static int (*sym_sd_bus_process)(sd_bus*, sd_bus_message**);
 static int (*sym_sd_bus_get_property_string)(sd_bus*, const char*, const char*, const char*, const char*, sd_bus_error*, char**);
 static int (*sym_sd_bus_get_property_trivial)(sd_bus*, const char*, const char*, const char*, const char*, sd_bus_error*, char, void*);
+static int (*sym_sd_bus_message_read)(sd_bus_message*, const char*, ...);
+static int (*sym_sd_bus_message_enter_container)(sd_bus_message*, char, const char*);
+static int (*sym_sd_bus_message_exit_container)(sd_bus_message*);
+static int (*sym_sd_bus_message_skip)(sd_bus_message*, const char*);
 static sd_bus* (*sym_sd_bus_unref)(sd_bus*);
 static void* dlopenHandle = NULL;
 
@@ -47,6 +66,12 @@ static void* dlopenHandle = NULL;
 
 #if !defined(BUILD_STATIC) || defined(HAVE_LIBSYSTEMD)
 static sd_bus* bus = NULL;
+
+/* The values need to be queried, because the bus was just opened or systemd announced a change without values */
+static bool busStale = true;
+
+/* Without the signals of systemd the values are queried on every update */
+static bool busSubscribed = false;
 #endif /* !BUILD_STATIC || HAVE_LIBSYSTEMD */
 
 
@@ -83,6 +108,125 @@ static void SystemdMeter_done(ATTR_UNUSED Meter* this) {
 }
 
 #if !defined(BUILD_STATIC) || defined(HAVE_LIBSYSTEMD)
+static const char* const busServiceName = "org.freedesktop.systemd1";
+static const char* const busObjectPath = "/org/freedesktop/systemd1";
+static const char* const busInterfaceName = "org.freedesktop.systemd1.Manager";
+
+/* Reads the value of a changed property of the manager, skipping those the meter does not show */
+static int readChangedProperty(sd_bus_message* m) {
+   const char* name;
+   int r = sym_sd_bus_message_read(m, "s", &name);
+   if (r < 0)
+      return r;
+
+   unsigned int* counter = NULL;
+   if (String_eq(name, "SystemState")) {
+      const char* state;
+      r = sym_sd_bus_message_read(m, "v", "s", &state);
+      if (r >= 0)
+         free_and_xStrdup(&systemState, state);
+      return r;
+   } else if (String_eq(name, "NFailedUnits")) {
+      counter = &nFailedUnits;
+   } else if (String_eq(name, "NInstalledJobs")) {
+      counter = &nInstalledJobs;
+   } else if (String_eq(name, "NNames")) {
+      counter = &nNames;
+   } else if (String_eq(name, "NJobs")) {
+      counter = &nJobs;
+   } else {
+      return sym_sd_bus_message_skip(m, "v");
+   }
+
+   uint32_t value;
+   r = sym_sd_bus_message_read(m, "v", "u", &value);
+   if (r >= 0) {
+      // SystemState follows the failed units, but changes without a PropertiesChanged of its own
+      if (counter == &nFailedUnits && value != nFailedUnits)
+         busStale = true;
+      *counter = value;
+   }
+   return r;
+}
+
+/* org.freedesktop.DBus.Properties.PropertiesChanged of the manager: "s" interface, "a{sv}" changed, "as" invalidated */
+static int onPropertiesChanged(sd_bus_message* m, ATTR_UNUSED void* userdata, ATTR_UNUSED sd_bus_error* error) {
+   const char* interface;
+   int r = sym_sd_bus_message_read(m, "s", &interface);
+   if (r < 0 || !String_eq(interface, busInterfaceName))
+      goto unknown;
+
+   r = sym_sd_bus_message_enter_container(m, 'a', "{sv}");
+   if (r < 0)
+      goto unknown;
+   while ((r = sym_sd_bus_message_enter_container(m, 'e', "sv")) > 0) {
+      if (readChangedProperty(m) < 0 || sym_sd_bus_message_exit_container(m) < 0)
+         goto unknown;
+   }
+   if (r < 0 || sym_sd_bus_message_exit_container(m) < 0)
+      goto unknown;
+
+   // invalidated properties come without values and are queried on the next update
+   r = sym_sd_bus_message_enter_container(m, 'a', "s");
+   if (r < 0)
+      goto unknown;
+   const char* name;
+   while ((r = sym_sd_bus_message_read(m, "s", &name)) > 0)
+      busStale = true;
+   if (r < 0)
+      goto unknown;
+
+   return 0;
+
+unknown:
+   busStale = true;
+   return 0;
+}
+
+/* Unit and job signals of the manager change the counts without a PropertiesChanged */
+static int onManagerSignal(ATTR_UNUSED sd_bus_message* m, ATTR_UNUSED void* userdata, ATTR_UNUSED sd_bus_error* error) {
+   busStale = true;
+   return 0;
+}
+
+static int subscribe(void) {
+   int r = sym_sd_bus_add_match(bus, NULL,
+                                "type='signal',"
+                                "sender='org.freedesktop.systemd1',"
+                                "path='/org/freedesktop/systemd1',"
+                                "interface='org.freedesktop.DBus.Properties',"
+                                "member='PropertiesChanged',"
+                                "arg0='org.freedesktop.systemd1.Manager'",
+                                onPropertiesChanged, NULL);
+   if (r < 0)
+      return r;
+
+   r = sym_sd_bus_add_match(bus, NULL,
+                            "type='signal',"
+                            "sender='org.freedesktop.systemd1',"
+                            "path='/org/freedesktop/systemd1',"
+                            "interface='org.freedesktop.systemd1.Manager'",
+                            onManagerSignal, NULL);
+   if (r < 0)
+      return r;
+
+   // systemd only emits its signals while some client is subscribed
+   return sym_sd_bus_call_method(bus,
+                                 busServiceName,       /* service to contact */
+                                 busObjectPath,        /* object path */
+                                 busInterfaceName,     /* interface name */
+                                 "Subscribe",          /* method name */
+                                 NULL,                 /* object to return error in */
+                                 NULL,                 /* no reply wanted */
+                                 NULL);                /* no arguments */
+}
+
+/*
+ * The connection is kept open and subscribed to the changes of the
+ * manager, so an update only dispatches the signals that arrived since
+ * the last one and queries the properties only if a signal left them
+ * unknown; when nothing changed that is a single non-blocking read.
+ */
 static int updateViaLib(void) {
 #ifndef BUILD_STATIC
    if (!dlopenHandle) {
@@ -100,8 +244,15 @@ static int updateViaLib(void) {
       } while(0)
 
       resolve(sd_bus_open_system);
+      resolve(sd_bus_add_match);
+      resolve(sd_bus_call_method);
+      resolve(sd_bus_process);
       resolve(sd_bus_get_property_string);
       resolve(sd_bus_get_property_trivial);
+      resolve(sd_bus_message_read);
+      resolve(sd_bus_message_enter_container);
+      resolve(sd_bus_message_exit_container);
+      resolve(sd_bus_message_skip);
       resolve(sd_bus_unref);
 
       #undef resolve
@@ -115,11 +266,22 @@ static int updateViaLib(void) {
       r = sym_sd_bus_open_system(&bus);
       if (r < 0)
          goto busfailure;
+
+      busSubscribed = subscribe() >= 0;
+      busStale = true;
    }
 
-   static const char* const busServiceName = "org.freedesktop.systemd1";
-   static const char* const busObjectPath = "/org/freedesktop/systemd1";
-   static const char* const busInterfaceName = "org.freedesktop.systemd1.Manager";
+   /* Dispatch the signals received since the last update */
+   while ((r = sym_sd_bus_process(bus, NULL)) > 0)
+      ;
+   if (r < 0)
+      goto busfailure;
+
+   if (!busStale)
+      return 0;
+
+   free(systemState);
+   systemState = NULL;
 
    r = sym_sd_bus_get_property_string(bus,
                                       busServiceName,        /* service to contact */
@@ -176,10 +338,12 @@ static int updateViaLib(void) {
       goto busfailure;
 
    /* success */
+   busStale = !busSubscribed;
    return 0;
 
 busfailure:
-   sym_sd_bus_unref(bus);
+   if (bus)
+      sym_sd_bus_unref(bus);
    bus = NULL;
    return -2;
 
@@ -195,6 +359,10 @@ dlfailure:
 #endif /* !BUILD_STATIC || HAVE_LIBSYSTEMD */
 
 static void updateViaExec(void) {
+   free(systemState);
+   systemState = NULL;
+   nFailedUnits = nInstalledJobs = nNames = nJobs = INVALID_VALUE;
+
    int fdpair[2];
    if (pipe(fdpair) < 0)
       return;
@@ -263,10 +431,6 @@ static void updateViaExec(void) {
 }
 
 static void SystemdMeter_updateValues(Meter* this) {
-   free(systemState);
-   systemState = NULL;
-   nFailedUnits = nInstalledJobs = nNames = nJobs = INVALID_VALUE;
-
 #if !defined(BUILD_STATIC) || defined(HAVE_LIBSYSTEMD)
    if (updateViaLib() < 0)
       updateViaExec();
@@ -0,0 +1,83 @@
+/*
+htop - VmStatMeter.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "VmStatMeter.h"
+
+#include "CRT.h"
+#include "LinuxProcessList.h"
+#include "Macros.h"
+#include "Meter.h"
+#include "Object.h"
+#include "RichString.h"
+#include "XUtils.h"
+
+
+static const int VmStatMeter_attributes[] = {
+   METER_VALUE,
+   METER_VALUE,
+   METER_VALUE,
+   METER_VALUE,
+   METER_VALUE,
+};
+
+static void VmStatMeter_updateValues(Meter* this) {
+   const LinuxProcessList* lpl = (const LinuxProcessList*) this->pl;
+   const VmStats* period = &lpl->vmstatPeriod;
+
+   /* the counters are per scan, shown per second; OOM kills are rare enough to be counted since boot */
+   double seconds = lpl->statPeriodMs / 1000.0;
+   this->values[0] = seconds > 0 ? period->pgfault / seconds : 0.0;
+   this->values[1] = seconds > 0 ? period->pgmajfault / seconds : 0.0;
+   this->values[2] = seconds > 0 ? period->pswpin / seconds : 0.0;
+   this->values[3] = seconds > 0 ? period->pswpout / seconds : 0.0;
+   this->values[4] = lpl->vmstat.oomKill;
+
+   xSnprintf(this->txtBuffer, sizeof(this->txtBuffer), "%.0f hata/s, %.0f büyük/s, takas %.0f/%.0f sayfa/s, %llu OOM",
+             this->values[0], this->values[1], this->values[2], this->values[3], lpl->vmstat.oomKill);
+}
+
+static void VmStatMeter_display(const Object* cast, RichString* out) {
+   const Meter* this = (const Meter*)cast;
+   const LinuxProcessList* lpl = (const LinuxProcessList*) this->pl;
+   char buffer[32];
+
+   xSnprintf(buffer, sizeof(buffer), "%.0f", this->values[0]);
+   RichString_writeAscii(out, CRT_colors[METER_VALUE], buffer);
+   RichString_appendWide(out, CRT_colors[METER_TEXT], " sayfa hatası/s, ");
+
+   xSnprintf(buffer, sizeof(buffer), "%.0f", this->values[1]);
+   RichString_appendAscii(out, CRT_colors[METER_VALUE], buffer);
+   RichString_appendWide(out, CRT_colors[METER_TEXT], " büyük/s, takas giriş ");
+
+   xSnprintf(buffer, sizeof(buffer), "%.0f", this->values[2]);
+   RichString_appendAscii(out, this->values[2] > 0 ? CRT_colors[METER_VALUE_WARN] : CRT_colors[METER_VALUE], buffer);
+   RichString_appendWide(out, CRT_colors[METER_TEXT], " çıkış ");
+
+   xSnprintf(buffer, sizeof(buffer), "%.0f", this->values[3]);
+   RichString_appendAscii(out, this->values[3] > 0 ? CRT_colors[METER_VALUE_WARN] : CRT_colors[METER_VALUE], buffer);
+   RichString_appendAscii(out, CRT_colors[METER_TEXT], " sayfa/s, OOM ");
+
+   xSnprintf(buffer, sizeof(buffer), "%llu", lpl->vmstat.oomKill);
+   RichString_appendAscii(out, lpl->vmstatPeriod.oomKill > 0 ? CRT_colors[METER_VALUE_ERROR] : CRT_colors[METER_VALUE], buffer);
+}
+
+const MeterClass VmStatMeter_class = {
+   .super = {
+      .extends = Class(Meter),
+      .delete = Meter_delete,
+      .display = VmStatMeter_display,
+   },
+   .updateValues = VmStatMeter_updateValues,
+   .defaultMode = TEXT_METERMODE,
+   .maxItems = 5,
+   .total = 100.0,
+   .attributes = VmStatMeter_attributes,
+   .name = "VmStat",
+   .uiName = "Sanal bellek olayları",
+   .caption = "VM: ",
+   .description = "Sayfa hataları ve takas trafiği saniyede, açılıştan beri OOM sonlandırmaları"
+};
@@ -0,0 +1,14 @@
+#ifndef HEADER_VmStatMeter
+#define HEADER_VmStatMeter
+/*
+htop - VmStatMeter.h
+(C) 2021 htop dev team
+Released under the GNU GPLv2, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "Meter.h"
+
+extern const MeterClass VmStatMeter_class;
+
+#endif
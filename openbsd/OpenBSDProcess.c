@@ -181,6 +181,12 @@ const ProcessFieldData Process_fields[LAST_PROCESSFIELD] = {
       .flags = 0,
       .pidColumn = true,
    },
+   [HOST] = {
+      .name = "HOST",
+      .title = "HOST         ",
+      .description = "Host the process runs on, when showing the processes of agents",
+      .flags = 0,
+   },
 };
 
 Process* OpenBSDProcess_new(const Settings* settings) {
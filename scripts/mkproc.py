@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+#
+# htop - scripts/mkproc.py
+# (C) 2021 htop dev team
+# Released under the GNU GPLv2, see the COPYING file
+# in the source distribution for its full text.
+#
+# Generates a synthetic Linux /proc tree for benchmarking the process scan
+# at a scale the build machine does not have.  htop reads it when built
+# with a PROCDIR pointing at the generated directory; "make benchmark"
+# does that and runs the headless benchmark against it.
+
+import argparse
+import os
+import random
+import shutil
+import sys
+
+COMMANDS = [
+    "/usr/sbin/sshd", "/usr/bin/python3", "/usr/lib/jvm/java-17/bin/java",
+    "/usr/bin/postgres", "/usr/sbin/nginx", "/usr/bin/node", "/bin/bash",
+    "/usr/lib/firefox/firefox", "/usr/bin/dockerd", "/usr/lib/systemd/systemd-journald",
+]
+
+LIBRARIES = [
+    "/usr/lib/x86_64-linux-gnu/libc.so.6", "/usr/lib/x86_64-linux-gnu/libm.so.6",
+    "/usr/lib/x86_64-linux-gnu/libpthread.so.0", "/usr/lib/x86_64-linux-gnu/libssl.so.3",
+    "/usr/lib/x86_64-linux-gnu/libcrypto.so.3", "/usr/lib/x86_64-linux-gnu/libz.so.1",
+]
+
+# left in every generated tree, only trees that have it are replaced
+MARKER = ".htop-mkproc"
+
+SMAPS_KEYS = [
+    "Size", "KernelPageSize", "MMUPageSize", "Rss", "Pss", "Shared_Clean",
+    "Shared_Dirty", "Private_Clean", "Private_Dirty", "Referenced", "Anonymous",
+    "LazyFree", "AnonHugePages", "ShmemPmdMapped", "Swap", "SwapPss", "Locked",
+]
+
+MEMINFO = [
+    ("MemTotal", 65831844), ("MemFree", 12345678), ("MemAvailable", 40000000),
+    ("Buffers", 1024000), ("Cached", 20000000), ("SwapCached", 0),
+    ("Active", 20000000), ("Inactive", 10000000), ("SwapTotal", 8388604),
+    ("SwapFree", 8388604), ("Dirty", 1000), ("Writeback", 0),
+    ("AnonPages", 9000000), ("Mapped", 2000000), ("Shmem", 500000),
+    ("SReclaimable", 800000), ("SUnreclaim", 300000), ("PageTables", 100000),
+    ("HugePages_Total", 0), ("Hugepagesize", 2048),
+]
+
+
+def write(path, content):
+    with open(path, "w") as f:
+        f.write(content)
+
+
+def stat_line(pid, comm, ppid, threads, cpu, rng):
+    fields = [
+        pid, "(%s)" % comm, "S", ppid, ppid, ppid, 0, -1, 4194560,
+        rng.randrange(100000), 0, rng.randrange(100), 0,
+        rng.randrange(100000), rng.randrange(50000), 0, 0, 20, 0, threads, 0,
+        rng.randrange(100, 1000000), rng.randrange(1 << 20, 1 << 32),
+        rng.randrange(100, 100000), 18446744073709551615,
+    ]
+    fields += [0] * 13
+    fields += [17, cpu, 0, 0, 0, 0, 0]
+    fields += [0] * 7
+    return " ".join(str(field) for field in fields) + "\n"
+
+
+def cmdline(command, length, rng):
+    args = [command]
+    size = len(command)
+    while size < length:
+        arg = "--option-%d=%x" % (len(args), rng.getrandbits(32))
+        args.append(arg)
+        size += len(arg) + 1
+    return "\0".join(args) + "\0"
+
+
+def maps(entries, rng):
+    lines = []
+    address = 0x400000
+    for i in range(entries):
+        size = rng.choice([0x1000, 0x21000, 0x200000])
+        path = LIBRARIES[i % len(LIBRARIES)] if i % 3 else ""
+        lines.append("%012x-%012x r-xp 00000000 08:01 %-10d %s" % (address, address + size, 1000 + i, path))
+        address += size + 0x1000
+    return lines
+
+
+def smaps(map_lines):
+    out = []
+    for line in map_lines:
+        out.append(line + "\n")
+        out.extend("%-16s%8d kB\n" % (key + ":", 4) for key in SMAPS_KEYS)
+        out.append("VmFlags: rd ex mr mw me dw\n")
+    return "".join(out)
+
+
+def status(pid, tgid, comm, ppid, threads, uid):
+    ids = "\t".join([str(uid)] * 4)
+    return ("Name:\t%s\nState:\tS (sleeping)\nTgid:\t%d\nPid:\t%d\nPPid:\t%d\n"
+            "Uid:\t%s\nGid:\t%s\nThreads:\t%d\n"
+            "voluntary_ctxt_switches:\t%d\nnonvoluntary_ctxt_switches:\t%d\n"
+            % (comm, tgid, pid, ppid, ids, ids, threads, pid * 7, pid))
+
+
+def cgroup(pid, depth):
+    path = "".join("/level%d" % level for level in range(depth))
+    return "0::%s/service-%d.scope\n" % (path, pid % 97)
+
+
+def io(rng):
+    values = tuple(rng.randrange(1 << 30) for _ in range(6))
+    return ("rchar: %d\nwchar: %d\nsyscr: %d\nsyscw: %d\nread_bytes: %d\nwrite_bytes: %d\n"
+            "cancelled_write_bytes: 0\n" % values)
+
+
+def task_files(directory, pid, tgid, comm, ppid, threads, command, args, rng):
+    os.makedirs(directory)
+    statm = (rng.randrange(1000, 100000), rng.randrange(100, 10000), rng.randrange(10, 1000), rng.randrange(100, 10000))
+    write(os.path.join(directory, "stat"), stat_line(pid, comm, ppid, threads, rng.randrange(args.cpus), rng))
+    write(os.path.join(directory, "statm"), "%d %d %d 1 0 %d 0\n" % statm)
+    write(os.path.join(directory, "comm"), comm + "\n")
+    write(os.path.join(directory, "cmdline"), command)
+    write(os.path.join(directory, "status"), status(pid, tgid, comm, ppid, threads, args.uid))
+    write(os.path.join(directory, "io"), io(rng))
+    write(os.path.join(directory, "cgroup"), cgroup(tgid, args.cgroup_depth))
+    write(os.path.join(directory, "oom_score"), "%d\n" % rng.randrange(1000))
+
+
+def global_files(root, args, rng):
+    def cpu(name):
+        return "%s %d 0 %d %d %d 0 %d 0 0 0\n" % (name, rng.randrange(10 ** 6), rng.randrange(10 ** 6),
+                                                 rng.randrange(10 ** 8), rng.randrange(10 ** 5), rng.randrange(10 ** 4))
+
+    # offline CPUs have no line of their own, the ids of the others keep their gaps
+    stat = [cpu("cpu ")] + [cpu("cpu%d" % i) for i in range(args.cpus) if i not in args.offline_cpus]
+    stat += ["intr 123456789\n", "ctxt 987654321\n", "btime 1600000000\n",
+             "processes %d\n" % (args.processes * 3), "procs_running 3\n", "procs_blocked 0\n"]
+    write(os.path.join(root, "stat"), "".join(stat))
+
+    write(os.path.join(root, "meminfo"), "".join("%-16s%12d kB\n" % (key + ":", value) for key, value in MEMINFO))
+
+    disks = []
+    for i in range(args.disks):
+        counters = " ".join(str(rng.randrange(10 ** 9)) for _ in range(11))
+        disks.append("%4d %7d sd%s %s\n" % (8, i * 16, chr(ord("a") + i % 26), counters))
+    write(os.path.join(root, "diskstats"), "".join(disks))
+
+    write(os.path.join(root, "vmstat"), "nr_free_pages 3086419\npgpgin 123456\npgpgout 654321\n"
+          "pswpin 0\npswpout 0\npgfault 99999999\npgmajfault 12345\n")
+    write(os.path.join(root, "uptime"), "123456.78 987654.32\n")
+    write(os.path.join(root, "loadavg"), "1.00 0.75 0.50 3/%d %d\n" % (args.processes * (1 + args.threads), args.processes))
+    write(os.path.join(root, "cpuinfo"), "".join("processor\t: %d\ncpu MHz\t\t: 2400.000\n\n" % i for i in range(args.cpus)))
+
+    os.makedirs(os.path.join(root, "net"))
+    write(os.path.join(root, "net", "dev"), "Inter-|   Receive\n face |bytes packets\n"
+          "    lo: 1000 10 0 0 0 0 0 0 1000 10 0 0 0 0 0 0\n"
+          "  eth0: 5000 50 0 0 0 0 0 0 4000 40 0 0 0 0 0 0\n")
+    os.makedirs(os.path.join(root, "sys", "kernel"))
+    write(os.path.join(root, "sys", "kernel", "pid_max"), "4194304\n")
+    os.makedirs(os.path.join(root, "tty"))
+    write(os.path.join(root, "tty", "drivers"), "/dev/tty             /dev/tty        5       0 system:/dev/tty\n"
+          "pty_slave            /dev/pts      136 0-1048575 pty:slave\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate a synthetic /proc tree for htop benchmarks.")
+    parser.add_argument("directory", help="directory to create, an earlier tree of this script in it is replaced")
+    parser.add_argument("--processes", type=int, default=5000, help="number of processes (default: %(default)s)")
+    parser.add_argument("--threads", type=int, default=4, help="additional threads per process (default: %(default)s)")
+    parser.add_argument("--cmdline-length", type=int, default=200, help="length of each command line in bytes (default: %(default)s)")
+    parser.add_argument("--maps", type=int, default=50, help="mappings in maps and smaps of each process (default: %(default)s)")
+    parser.add_argument("--cgroup-depth", type=int, default=3, help="nesting of the cgroup of each process (default: %(default)s)")
+    parser.add_argument("--cpus", type=int, default=64, help="number of CPUs in stat (default: %(default)s)")
+    parser.add_argument("--offline-cpus", type=lambda v: {int(i) for i in v.split(",") if i}, default=set(),
+                        help="comma separated ids of CPUs left out of stat as if offline (default: none)")
+    parser.add_argument("--disks", type=int, default=8, help="number of disks in diskstats (default: %(default)s)")
+    parser.add_argument("--uid", type=int, default=os.getuid(), help="owner shown in status (default: the current user)")
+    parser.add_argument("--seed", type=int, default=1, help="random seed, the same seed gives the same tree (default: %(default)s)")
+    args = parser.parse_args()
+
+    if args.processes < 1 or args.threads < 0 or args.cpus < 1 or args.maps < 0 or args.cgroup_depth < 0:
+        parser.error("counts must not be negative and there must be a process and a CPU")
+    if len(set(range(args.cpus)) - args.offline_cpus) == 0:
+        parser.error("there must be an online CPU")
+
+    rng = random.Random(args.seed)
+    root = args.directory
+    if os.path.exists(root) and not os.path.isdir(root):
+        parser.error("%s is not a directory" % root)
+    if os.path.isdir(root) and os.listdir(root):
+        if not os.path.isfile(os.path.join(root, MARKER)):
+            parser.error("%s is not empty and was not generated by this script, not replacing it" % root)
+        shutil.rmtree(root)
+    os.makedirs(root, exist_ok=True)
+    write(os.path.join(root, MARKER), "generated by scripts/mkproc.py\n")
+
+    global_files(root, args, rng)
+
+    # every process but init is the child of a recent one, which gives the tree some depth
+    pids = []
+    next_pid = 1
+    for n in range(args.processes):
+        pid = next_pid
+        next_pid += 1 + args.threads
+        if n == 0:
+            ppid = 0
+        elif len(pids) < 3:
+            ppid = 1
+        else:
+            ppid = pids[rng.randrange(len(pids) // 2, len(pids))]
+        pids.append(pid)
+
+        exe = COMMANDS[n % len(COMMANDS)] if n else "/sbin/init"
+        comm = os.path.basename(exe)[:15]
+        command = cmdline(exe, args.cmdline_length, rng)
+        threads = 1 + args.threads
+        directory = os.path.join(root, str(pid))
+        task_files(directory, pid, pid, comm, ppid, threads, command, args, rng)
+
+        map_lines = maps(args.maps, rng)
+        write(os.path.join(directory, "maps"), "".join(line + "\n" for line in map_lines))
+        write(os.path.join(directory, "smaps"), smaps(map_lines))
+        write(os.path.join(directory, "environ"), "PATH=/usr/bin:/bin\0HOME=/root\0LANG=C.UTF-8\0")
+
+        # like the kernel, the main thread is listed among the tasks as well
+        task_dir = os.path.join(directory, "task")
+        os.makedirs(task_dir)
+        for tid in range(pid, pid + threads):
+            task_files(os.path.join(task_dir, str(tid)), tid, pid, comm, ppid, threads, command, args, rng)
+
+        if (n + 1) % 1000 == 0:
+            print("%d/%d processes" % (n + 1, args.processes), file=sys.stderr)
+
+    print("%s: %d processes, %d tasks" % (root, args.processes, args.processes * (1 + args.threads)), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
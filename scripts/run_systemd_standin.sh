@@ -0,0 +1,29 @@
+#!/bin/sh
+
+# Runs htop against systemd_standin.c on a private bus, to check which
+# properties the Systemd meter queries as the stand-in changes its state.
+# Add the Systemd meter in the setup; the stand-in logs to systemd_standin.log.
+
+SCRIPT=$(readlink -f "$0")
+SCRIPTDIR=$(dirname "$SCRIPT")
+WORKDIR=$(mktemp -d)
+LOG="${STANDIN_LOG:-systemd_standin.log}"
+
+cleanup() {
+   [ -n "$STANDIN_PID" ] && kill "$STANDIN_PID" 2>/dev/null
+   [ -s "$WORKDIR/bus.pid" ] && kill "$(cat "$WORKDIR/bus.pid")" 2>/dev/null
+   rm -rf "$WORKDIR"
+}
+trap cleanup EXIT
+
+${CC:-cc} -o "$WORKDIR/standin" "${SCRIPTDIR}/systemd_standin.c" -l:libsystemd.so.0 || exit 1
+dbus-daemon --session --address="unix:path=$WORKDIR/bus" --fork --print-pid > "$WORKDIR/bus.pid" || exit 1
+
+DBUS_SYSTEM_BUS_ADDRESS="unix:path=$WORKDIR/bus"
+export DBUS_SYSTEM_BUS_ADDRESS
+
+"$WORKDIR/standin" 2> "$LOG" &
+STANDIN_PID=$!
+sleep 1
+
+"${SCRIPTDIR}/../htop" "$@"
@@ -0,0 +1,138 @@
+/*
+htop - scripts/systemd_standin.c
+(C) 2021 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+/*
+ * Stand-in for the systemd manager on a private bus, see
+ * run_systemd_standin.sh.  It answers Subscribe and the property Gets of
+ * the Systemd meter and logs each Get to stderr, then changes its state
+ * every few seconds:
+ *
+ *   1. NJobs and SystemState change with a PropertiesChanged
+ *   2. a UnitNew signal, which carries no values
+ *   3. NFailedUnits changes with a PropertiesChanged, SystemState without one
+ *
+ * The meter should query all properties after 2 and 3, and none after 1.
+ * Built against libsystemd.so.0 alone, so no development headers are needed.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct sd_bus sd_bus;
+typedef struct sd_bus_message sd_bus_message;
+typedef int (*sd_bus_message_handler_t)(sd_bus_message* m, void* userdata, void* error);
+
+int sd_bus_open_system(sd_bus** bus);
+int sd_bus_request_name(sd_bus* bus, const char* name, uint64_t flags);
+int sd_bus_add_filter(sd_bus* bus, void** slot, sd_bus_message_handler_t callback, void* userdata);
+int sd_bus_process(sd_bus* bus, sd_bus_message** r);
+int sd_bus_wait(sd_bus* bus, uint64_t timeout_usec);
+int sd_bus_message_is_method_call(sd_bus_message* m, const char* interface, const char* member);
+int sd_bus_message_read(sd_bus_message* m, const char* types, ...);
+int sd_bus_reply_method_return(sd_bus_message* call, const char* types, ...);
+int sd_bus_emit_signal(sd_bus* bus, const char* path, const char* interface, const char* member, const char* types, ...);
+
+#define STANDIN_PATH "/org/freedesktop/systemd1"
+#define STANDIN_MANAGER "org.freedesktop.systemd1.Manager"
+#define STANDIN_PHASE_SECONDS 3
+
+static const char* systemState = "running";
+static uint32_t nFailedUnits = 0;
+static uint32_t nInstalledJobs = 99;
+static uint32_t nNames = 250;
+static uint32_t nJobs = 3;
+static unsigned int gets = 0;
+
+static uint32_t counterOf(const char* name) {
+   if (strcmp(name, "NFailedUnits") == 0)
+      return nFailedUnits;
+   if (strcmp(name, "NInstalledJobs") == 0)
+      return nInstalledJobs;
+   if (strcmp(name, "NNames") == 0)
+      return nNames;
+   if (strcmp(name, "NJobs") == 0)
+      return nJobs;
+   return 0;
+}
+
+static int onMessage(sd_bus_message* m, void* userdata, void* error) {
+   (void)userdata;
+   (void)error;
+
+   if (sd_bus_message_is_method_call(m, "org.freedesktop.DBus.Properties", "Get")) {
+      const char* interface;
+      const char* name;
+      if (sd_bus_message_read(m, "ss", &interface, &name) < 0)
+         return 0;
+
+      gets++;
+      fprintf(stderr, "Get %s (total %u)\n", name, gets);
+      if (strcmp(name, "SystemState") == 0)
+         return sd_bus_reply_method_return(m, "v", "s", systemState) >= 0;
+      return sd_bus_reply_method_return(m, "v", "u", counterOf(name)) >= 0;
+   }
+
+   if (sd_bus_message_is_method_call(m, STANDIN_MANAGER, "Subscribe")) {
+      fprintf(stderr, "Subscribe\n");
+      return sd_bus_reply_method_return(m, "") >= 0;
+   }
+
+   return 0;
+}
+
+static void changeState(sd_bus* bus, int phase) {
+   switch (phase) {
+   case 1:
+      nJobs = 7;
+      systemState = "starting";
+      sd_bus_emit_signal(bus, STANDIN_PATH, "org.freedesktop.DBus.Properties", "PropertiesChanged", "sa{sv}as",
+                         STANDIN_MANAGER, 2, "NJobs", "u", nJobs, "SystemState", "s", systemState, 0);
+      fprintf(stderr, "emitted PropertiesChanged of NJobs and SystemState\n");
+      break;
+   case 2:
+      sd_bus_emit_signal(bus, STANDIN_PATH, STANDIN_MANAGER, "UnitNew", "so", "x.service", STANDIN_PATH "/unit/x_2eservice");
+      fprintf(stderr, "emitted UnitNew\n");
+      break;
+   case 3:
+      nFailedUnits = 1;
+      systemState = "degraded";
+      sd_bus_emit_signal(bus, STANDIN_PATH, "org.freedesktop.DBus.Properties", "PropertiesChanged", "sa{sv}as",
+                         STANDIN_MANAGER, 1, "NFailedUnits", "u", nFailedUnits, 0);
+      fprintf(stderr, "emitted PropertiesChanged of NFailedUnits\n");
+      break;
+   default:
+      break;
+   }
+}
+
+int main(void) {
+   sd_bus* bus;
+   if (sd_bus_open_system(&bus) < 0) {
+      fprintf(stderr, "no bus, is DBUS_SYSTEM_BUS_ADDRESS set?\n");
+      return 1;
+   }
+   if (sd_bus_request_name(bus, "org.freedesktop.systemd1", 0) < 0) {
+      fprintf(stderr, "can not own org.freedesktop.systemd1\n");
+      return 2;
+   }
+   sd_bus_add_filter(bus, NULL, onMessage, NULL);
+
+   time_t last = time(NULL);
+   int phase = 0;
+   for (;;) {
+      while (sd_bus_process(bus, NULL) > 0)
+         ;
+      sd_bus_wait(bus, 200000);
+
+      if (time(NULL) - last >= STANDIN_PHASE_SECONDS) {
+         last = time(NULL);
+         changeState(bus, ++phase);
+      }
+   }
+}
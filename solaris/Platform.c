@@ -24,6 +24,7 @@ in the source distribution for its full text.
 #include "Meter.h"
 #include "CPUMeter.h"
 #include "MemoryMeter.h"
+#include "ProfileMeter.h"
 #include "SwapMeter.h"
 #include "TasksMeter.h"
 #include "LoadAverageMeter.h"
@@ -104,6 +105,7 @@ const MeterClass* const Platform_meterTypes[] = {
    &HostnameMeter_class,
    &SysArchMeter_class,
    &UptimeMeter_class,
+   &ProfileMeter_class,
    &AllCPUsMeter_class,
    &AllCPUs2Meter_class,
    &AllCPUs4Meter_class,
@@ -116,12 +118,17 @@ const MeterClass* const Platform_meterTypes[] = {
    &RightCPUs4Meter_class,
    &LeftCPUs8Meter_class,
    &RightCPUs8Meter_class,
+   &CPUHeatmapMeter_class,
    &ZfsArcMeter_class,
    &ZfsCompressedArcMeter_class,
    &BlankMeter_class,
    NULL
 };
 
+const SnapshotLayout Platform_snapshotLayout = {
+   .newProcess = SolarisProcess_new,
+};
+
 void Platform_init(void) {
    /* no platform-specific setup needed */
 }
@@ -282,13 +289,19 @@ char* Platform_getProcessEnv(pid_t pid) {
    return envBuilder.env;
 }
 
-char* Platform_getInodeFilename(pid_t pid, ino_t inode) {
+FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
     (void)pid;
-    (void)inode;
     return NULL;
 }
 
-FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
+bool Platform_getProcessFiles(pid_t pid, const OpenFiles_ProcessData* previous, OpenFiles_ProcessData* pdata) {
+    (void)pid;
+    (void)previous;
+    (void)pdata;
+    return false;
+}
+
+FILE* Platform_openProcessSmaps(pid_t pid) {
     (void)pid;
     return NULL;
 }